@@ -0,0 +1,795 @@
+#include "Benchmark.h"
+
+#include "HelloTriangleApp.h"
+#include "IndexCodec.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <stb_image.h>
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <map>
+#include <random>
+
+/* ************************************************************************************************
+ * Global Functions
+ * ************************************************************************************************/
+bool runBenchmark(int argc, char** argv)
+{
+    if (argc < 2) { return false; }
+
+    std::string name = argv[1];
+    if (name == "--bench-obj")
+    {
+        benchmarkObjLoader(argc > 2 ? argv[2] : MODEL_DIR);
+        return true;
+    }
+    if (name == "--bench-overdraw")
+    {
+        benchmarkOverdraw(argc > 2 ? argv[2] : MODEL_DIR);
+        return true;
+    }
+    if (name == "--bench-decode")
+    {
+        benchmarkTextureDecoder(argc > 2 ? argv[2] : TEXTURE_DIR);
+        return true;
+    }
+    if (name == "--bench-index")
+    {
+        benchmarkIndexCodec(argc > 2 ? argv[2] : MODEL_DIR);
+        return true;
+    }
+    if (name == "--bench-lod")
+    {
+        benchmarkLodChain(argc > 2 ? argv[2] : MODEL_DIR);
+        return true;
+    }
+    if (name == "--bench-mips")
+    {
+        benchmarkMipGenerator(argc > 2 ? argv[2] : TEXTURE_DIR);
+        return true;
+    }
+    if (name == "--bench-meshopt")
+    {
+        benchmarkMeshOptimizer(argc > 2 ? argv[2] : MODEL_DIR);
+        return true;
+    }
+    if (name == "--bench-allocator")
+    {
+        benchmarkDeviceAllocator();
+        return true;
+    }
+    if (name == "--bench-instancing")
+    {
+        benchmarkInstancing();
+        return true;
+    }
+    if (name == "--bench-recording")
+    {
+        benchmarkRecording();
+        return true;
+    }
+
+    return false;
+}
+
+void benchmarkDeviceAllocator()
+{
+    // A fake device with a large device local heap, a small host visible one, which runs out of
+    // memory part way through and so also exercises the fallback to smaller blocks, and a host visible
+    // device local one the size of a BAR without resizing. First, every usage is checked to land in
+    // its memory type, and per-frame data to spill over into host memory once the BAR is at its
+    // budget. Then random allocations of buffers and images come and go, and every 100 steps all
+    // live ones are checked against each other; the allocator's counts are compared with one device
+    // allocation per resource, which is what the renderer did before.
+    const VkDeviceSize granularity = 1024;
+    VkPhysicalDeviceMemoryProperties memoryProperties {};
+    memoryProperties.memoryHeapCount = 3;
+    memoryProperties.memoryHeaps[0].size = VkDeviceSize(8) * 1024 * 1024 * 1024;
+    memoryProperties.memoryHeaps[1].size = 192 * 1024 * 1024;
+    memoryProperties.memoryHeaps[2].size = 256 * 1024 * 1024;
+    memoryProperties.memoryTypeCount = 3;
+    memoryProperties.memoryTypes[0].propertyFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+    memoryProperties.memoryTypes[0].heapIndex = 0;
+    memoryProperties.memoryTypes[1].propertyFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    memoryProperties.memoryTypes[1].heapIndex = 1;
+    memoryProperties.memoryTypes[2].propertyFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT |
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    memoryProperties.memoryTypes[2].heapIndex = 2;
+
+    struct FakeMemory
+    {
+        uint32_t                        memoryTypeIndex;
+        VkDeviceSize                    size;
+        std::vector<uint8_t>            data;
+    };
+
+    std::map<VkDeviceMemory, FakeMemory> memories;
+    VkDeviceSize heapUsage[3] = {};
+    uint64_t nextHandle = 1;
+    size_t deviceCallCount = 0;
+
+    DeviceMemoryFunctions functions {};
+    functions.allocate = [&](uint32_t memoryTypeIndex, VkDeviceSize size) {
+        ++ deviceCallCount;
+        uint32_t heapIndex = memoryProperties.memoryTypes[memoryTypeIndex].heapIndex;
+        if (heapUsage[heapIndex] + size > memoryProperties.memoryHeaps[heapIndex].size)
+        {
+            return static_cast<VkDeviceMemory>(VK_NULL_HANDLE);
+        }
+
+        heapUsage[heapIndex] += size;
+        auto memory = (VkDeviceMemory)(uintptr_t)nextHandle++;
+        memories[memory] = { memoryTypeIndex, size, {} };
+        return memory;
+    };
+    functions.free = [&](VkDeviceMemory memory) {
+        auto it = memories.find(memory);
+        if (it == memories.end())
+        {
+            throw std::runtime_error("device allocator check failed: freed unknown memory");
+        }
+        heapUsage[memoryProperties.memoryTypes[it->second.memoryTypeIndex].heapIndex] -= it->second.size;
+        memories.erase(it);
+    };
+    functions.map = [&](VkDeviceMemory memory, VkDeviceSize size) {
+        FakeMemory& fake = memories.at(memory);
+        fake.data.resize(static_cast<size_t>(size));
+        return static_cast<void*>(fake.data.data());
+    };
+
+    struct LiveAllocation
+    {
+        DeviceAllocation                allocation;
+        uint32_t                        memoryTypeIndex;
+        bool                            optimal;
+    };
+
+    auto check = [&](const std::vector<LiveAllocation>& live) {
+        std::map<VkDeviceMemory, std::map<VkDeviceSize, const LiveAllocation*>> ranges;
+        for (const auto& entry : live)
+        {
+            const DeviceAllocation& allocation = entry.allocation;
+            auto memory = memories.find(allocation.memory);
+            if (memory == memories.end() || allocation.offset + allocation.size > memory->second.size)
+            {
+                throw std::runtime_error("device allocator check failed: allocation outside its memory");
+            }
+            uint8_t* data = entry.memoryTypeIndex == 1 ? memory->second.data.data() + allocation.offset : nullptr;
+            if (allocation.data != data)
+            {
+                throw std::runtime_error("device allocator check failed: wrong mapping");
+            }
+            ranges[allocation.memory][allocation.offset] = &entry;
+        }
+
+        for (const auto& memory : ranges)
+        {
+            const LiveAllocation* previous = nullptr;
+            for (const auto& range : memory.second)
+            {
+                const LiveAllocation* current = range.second;
+                if (previous != nullptr)
+                {
+                    VkDeviceSize previousEnd = previous->allocation.offset + previous->allocation.size;
+                    if (previousEnd > current->allocation.offset)
+                    {
+                        throw std::runtime_error("device allocator check failed: overlapping allocations");
+                    }
+                    if (previous->optimal != current->optimal &&
+                        (previousEnd - 1) / granularity == current->allocation.offset / granularity)
+                    {
+                        throw std::runtime_error("device allocator check failed: buffer and image share a page");
+                    }
+                }
+                previous = current;
+            }
+        }
+    };
+
+    DeviceAllocator allocator;
+    allocator.init(functions, memoryProperties, granularity, DEVICE_MEMORY_BLOCK_SIZE);
+
+    VkMemoryRequirements placementRequirements {};
+    placementRequirements.size = 1024 * 1024;
+    placementRequirements.alignment = 256;
+    placementRequirements.memoryTypeBits = 0x7;
+    const std::pair<MemoryUsage, uint32_t> placements[] = {
+        { MemoryUsage::GpuOnly, 0 }, { MemoryUsage::Upload, 1 }, { MemoryUsage::Readback, 1 }, { MemoryUsage::Dynamic, 2 }
+    };
+    for (const auto& placement : placements)
+    {
+        DeviceAllocation allocation = allocator.allocate(placementRequirements, placement.first, false);
+        if (memories.at(allocation.memory).memoryTypeIndex != placement.second)
+        {
+            throw std::runtime_error("device allocator check failed: wrong memory type for the usage");
+        }
+        allocator.free(allocation);
+    }
+
+    std::vector<DeviceAllocation> frameAllocations;
+    size_t barAllocationCount = 0;
+    for (int i = 0; i < 256; ++ i)
+    {
+        frameAllocations.push_back(allocator.allocate(placementRequirements, MemoryUsage::Dynamic, false));
+        barAllocationCount += memories.at(frameAllocations.back().memory).memoryTypeIndex == 2 ? 1 : 0;
+    }
+    DeviceHeapBudget barBudget = allocator.getBudgets()[2];
+    if (barAllocationCount == frameAllocations.size() || barBudget.usage > barBudget.budget)
+    {
+        throw std::runtime_error("device allocator check failed: per-frame data exceeded the budget");
+    }
+    for (const auto& allocation : frameAllocations)
+    {
+        allocator.free(allocation);
+    }
+
+    std::mt19937 random(1);
+    std::vector<LiveAllocation> live;
+    std::vector<VkDeviceSize> alignments;
+    size_t allocationCount = 0;
+    size_t failureCount = 0;
+    size_t peakLiveCount = 0;
+    double seconds = 0.0;
+
+    const int stepCount = 20000;
+    for (int step = 0; step < stepCount; ++ step)
+    {
+        // Grow to around 2000 live allocations, then keep the count level. Sizes are spread evenly
+        // on a log scale from 16 bytes to 16 MiB, alignments from 1 byte to 64 KiB.
+        bool grow = live.empty() || random() % 4000 >= live.size();
+        auto startTime = std::chrono::high_resolution_clock::now();
+        if (grow)
+        {
+            LiveAllocation entry {};
+            VkMemoryRequirements requirements {};
+            requirements.size = VkDeviceSize(16) << (random() % 21);
+            requirements.size += random() % requirements.size;
+            requirements.alignment = VkDeviceSize(1) << (random() % 17);
+            entry.memoryTypeIndex = random() % 4 == 0 ? 1 : 0;
+            entry.optimal = random() % 2 == 0;
+
+            try
+            {
+                entry.allocation = allocator.allocate(requirements, entry.memoryTypeIndex, entry.optimal);
+            }
+            catch (const std::runtime_error&)
+            {
+                ++ failureCount;
+                continue;
+            }
+            seconds += std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - startTime).count();
+
+            if (entry.allocation.offset % requirements.alignment != 0)
+            {
+                throw std::runtime_error("device allocator check failed: misaligned allocation");
+            }
+            live.push_back(entry);
+            ++ allocationCount;
+        }
+        else
+        {
+            size_t index = random() % live.size();
+            allocator.free(live[index].allocation);
+            seconds += std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - startTime).count();
+            live[index] = live.back();
+            live.pop_back();
+        }
+
+        peakLiveCount = std::max(peakLiveCount, live.size());
+        if (step % 100 == 0) { check(live); }
+    }
+    check(live);
+
+    DeviceAllocatorStats stats = allocator.getStats();
+    DeviceAllocatorStats hostStats = allocator.getStats(1);
+    std::cout << std::fixed << std::setprecision(1)
+        << "device allocator: " << stepCount << " steps, " << allocationCount << " allocations, " << failureCount
+        << " out of memory, " << seconds / stepCount * 1e9 << " ns per step" << std::endl
+        << "  live " << stats.allocationCount << " (peak " << peakLiveCount << ") in " << stats.deviceAllocationCount
+        << " device allocations (" << stats.blockCount << " blocks, " << stats.dedicatedCount << " dedicated), "
+        << deviceCallCount << " vkAllocateMemory calls in total" << std::endl
+        << "  used " << stats.usedBytes / 1048576.0 << " MiB, allocated " << stats.allocatedBytes / 1048576.0
+        << " MiB, reserved " << stats.reservedBytes / 1048576.0 << " MiB, largest free range "
+        << stats.largestFreeRange / 1048576.0 << " MiB" << std::endl
+        << "  host visible: " << hostStats.allocationCount << " live in " << hostStats.deviceAllocationCount
+        << " device allocations, reserved " << hostStats.reservedBytes / 1048576.0 << " of "
+        << memoryProperties.memoryHeaps[1].size / 1048576.0 << " MiB" << std::endl
+        << "  placement ok, per-frame data spilled into host memory after " << barAllocationCount << " of "
+        << frameAllocations.size() << " MiB, with " << barBudget.usage / 1048576.0 << " of "
+        << barBudget.budget / 1048576.0 << " MiB of the BAR budget in use" << std::endl;
+
+    // Freeing everything must merge every block back into one range and leave at most one empty
+    // block per pool; destroying the allocator must give back the rest.
+    for (const auto& entry : live)
+    {
+        allocator.free(entry.allocation);
+    }
+    stats = allocator.getStats();
+    if (stats.allocationCount != 0 || stats.usedBytes != 0 || stats.allocatedBytes != 0 || stats.blockCount > 2 * memoryProperties.memoryTypeCount ||
+        stats.dedicatedCount != 0)
+    {
+        throw std::runtime_error("device allocator check failed: memory left behind after freeing everything");
+    }
+
+    allocator.destroy();
+    if (!memories.empty())
+    {
+        throw std::runtime_error("device allocator check failed: device memory leaked");
+    }
+    std::cout << "  all checks passed" << std::endl;
+}
+
+void benchmarkIndexCodec(const std::string& filename)
+{
+    // Encode the optimized index buffer the way the mesh cache stores it and time decoding into
+    // both index widths; decode speed is reported against the encoded size, i.e. as the disk read
+    // speed it would have to beat.
+    ThreadPool threadPool;
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    ObjLoader::load(filename, threadPool, threadPool.threadCount(), vertices, indices);
+    MeshOptimizer::optimizeVertexCache(indices.data(), indices.size(), vertices.size());
+    MeshOptimizer::optimizeVertexFetch(vertices, indices);
+
+    std::vector<uint8_t> encoded;
+    auto startTime = std::chrono::high_resolution_clock::now();
+    IndexCodec::encode(indices.data(), indices.size(), encoded);
+    double encodeSeconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - startTime).count();
+
+    size_t rawSize = sizeof(uint32_t) * indices.size();
+    std::cout << "index codec: " << filename << " (" << indices.size() << " indices, " << vertices.size() << " vertices)" << std::endl;
+    std::cout << std::fixed << std::setprecision(3)
+        << "  raw " << rawSize << " bytes | 16-bit " << rawSize / 2 << " bytes | encoded " << encoded.size() << " bytes ("
+        << static_cast<double>(encoded.size()) / indices.size() << " bytes/index)"
+        << " | encode " << encodeSeconds * 1000.0 << " ms" << std::endl;
+
+    const int repeats = 10;
+    std::vector<uint32_t> decoded32(indices.size());
+    startTime = std::chrono::high_resolution_clock::now();
+    bool valid = true;
+    for (int i = 0; i < repeats; ++ i)
+    {
+        valid = IndexCodec::decode(encoded.data(), encoded.size(), decoded32.data(), decoded32.size()) && valid;
+    }
+    double decodeSeconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - startTime).count() / repeats;
+    valid = valid && decoded32 == indices;
+
+    std::cout << "  decode 32-bit " << decodeSeconds * 1000.0 << " ms | " << encoded.size() / decodeSeconds / 1e6 << " MB/s in, "
+              << rawSize / decodeSeconds / 1e6 << " MB/s out | " << (valid ? "round trip ok" : "ROUND TRIP FAILED") << std::endl;
+
+    if (vertices.size() <= 0x10000)
+    {
+        std::vector<uint16_t> decoded16(indices.size());
+        startTime = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < repeats; ++ i)
+        {
+            IndexCodec::decode(encoded.data(), encoded.size(), decoded16.data(), decoded16.size());
+        }
+        decodeSeconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - startTime).count() / repeats;
+        std::cout << "  decode 16-bit " << decodeSeconds * 1000.0 << " ms | " << encoded.size() / decodeSeconds / 1e6 << " MB/s in, "
+                  << rawSize / 2 / decodeSeconds / 1e6 << " MB/s out" << std::endl;
+    }
+}
+
+void benchmarkInstancing()
+{
+    /***
+     * Sweep the object count and compare, per frame, the CPU side of three ways to draw the scene. A
+     * uniform block per draw is built for every object and pushed into the uniform ring at the largest
+     * offset alignment, and each draw binds the descriptor set with its offset. A push constant per
+     * draw copies the object's transform into the command buffer next to its draw, on top of one
+     * uniform block for the frame. An instanced draw writes a compact placement per object into the
+     * instance stream and records a fixed handful of commands. The commands are counted here, and a
+     * checksum over what every repeat has written keeps the loops from being optimised away. Then the
+     * same counts are drawn on the device, with a draw per object and instanced, and timed there.
+     ***/
+    const size_t objectCounts[] = { 1, 16, 256, 4096, 16384, 65536 };
+    const size_t maxObjectCount = objectCounts[std::size(objectCounts) - 1];
+    const VkDeviceSize uniformAlignment = 256;
+    // Pipeline, vertex buffers and index buffer.
+    const size_t bindCommandCount = 3;
+
+    std::vector<glm::vec3> positions(maxObjectCount);
+    for (size_t i = 0; i < maxObjectCount; ++ i)
+    {
+        positions[i] = glm::vec3((i % 256) * SCENE_OBJECT_SPACING, (i / 256) * SCENE_OBJECT_SPACING, 0.f);
+    }
+
+    UniformBufferObject ubo {};
+    ubo.model = getModelTransform(0.f);
+
+    VkDeviceSize frameSize = UniformRing::getSize(sizeof(UniformBufferObject), 1, uniformAlignment) * maxObjectCount;
+    std::vector<uint8_t> uniformData(static_cast<size_t>(frameSize));
+    UniformRing uniformRing;
+    uniformRing.reset(uniformData.data(), frameSize, 1, uniformAlignment);
+    std::vector<glm::mat4> pushData(maxObjectCount);
+    std::vector<InstanceData> instances(maxObjectCount);
+    double checksum = 0.0;
+
+    std::cout << "instancing: " << sizeof(UniformBufferObject) << " byte uniform blocks at " << uniformAlignment
+              << " byte alignment vs " << sizeof(PushConstants::transform) << " byte push constants vs "
+              << sizeof(InstanceData) << " byte instances" << std::endl;
+    for (size_t objectCount : objectCounts)
+    {
+        const size_t repeats = std::max<size_t>(1, 262144 / objectCount);
+
+        auto startTime = std::chrono::high_resolution_clock::now();
+        for (size_t repeat = 0; repeat < repeats; ++ repeat)
+        {
+            uniformRing.beginFrame(0);
+            UniformBufferObject objectUbo = ubo;
+            uint32_t offset = 0;
+            for (size_t i = 0; i < objectCount; ++ i)
+            {
+                objectUbo.model = glm::translate(glm::mat4(1.f), positions[i]) * ubo.model;
+                offset = uniformRing.push(&objectUbo, sizeof(objectUbo));
+            }
+            checksum += reinterpret_cast<const UniformBufferObject*>(uniformData.data() + offset)->model[3][0];
+        }
+        double uniformSeconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - startTime).count() / repeats;
+        uint64_t uniformBytes = uniformRing.frameUsage();
+
+        startTime = std::chrono::high_resolution_clock::now();
+        for (size_t repeat = 0; repeat < repeats; ++ repeat)
+        {
+            uniformRing.beginFrame(0);
+            uniformRing.push(&ubo, sizeof(ubo));
+            for (size_t i = 0; i < objectCount; ++ i)
+            {
+                pushData[i] = glm::translate(glm::mat4(1.f), positions[i]);
+            }
+            checksum += pushData[repeat % objectCount][3][0];
+        }
+        double pushSeconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - startTime).count() / repeats;
+        uint64_t pushBytes = uniformRing.frameUsage() + sizeof(glm::mat4) * objectCount;
+
+        startTime = std::chrono::high_resolution_clock::now();
+        for (size_t repeat = 0; repeat < repeats; ++ repeat)
+        {
+            uniformRing.beginFrame(0);
+            uniformRing.push(&ubo, sizeof(ubo));
+            for (size_t i = 0; i < objectCount; ++ i)
+            {
+                instances[i].positionScale = glm::vec4(positions[i], 1.f);
+                instances[i].rotation = glm::vec4(0.f, 0.f, 0.f, 1.f);
+            }
+            checksum += instances[repeat % objectCount].positionScale.x;
+        }
+        double instancedSeconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - startTime).count() / repeats;
+        uint64_t instancedBytes = uniformRing.frameUsage() + sizeof(InstanceData) * objectCount;
+
+        std::cout << std::fixed << std::setprecision(3)
+            << "  " << std::setw(6) << objectCount << " objects"
+            << " | uniform per draw " << std::setw(8) << uniformSeconds * 1000.0 << " ms, " << std::setw(9)
+            << uniformBytes / 1024.0 << " KiB, " << std::setw(6) << bindCommandCount + 2 * objectCount << " commands"
+            << " | push per draw " << std::setw(8) << pushSeconds * 1000.0 << " ms, " << std::setw(9)
+            << pushBytes / 1024.0 << " KiB, " << std::setw(6) << bindCommandCount + 1 + 2 * objectCount << " commands"
+            << " | instanced " << std::setw(8) << instancedSeconds * 1000.0 << " ms, " << std::setw(9)
+            << instancedBytes / 1024.0 << " KiB, " << bindCommandCount + 2 << " commands" << std::endl;
+    }
+    std::cout << "  checksum " << checksum << std::endl;
+
+    HelloTriangleApplication app;
+    app.runSceneBenchmark(std::vector<uint32_t>(std::begin(objectCounts), std::end(objectCounts)), false, true, 100);
+}
+
+void benchmarkLodChain(const std::string& filename)
+{
+    // Build the level of detail chain with the application's settings and report, per level, its
+    // size, its error and the view distance beyond which selectLod() switches to it.
+    ThreadPool threadPool;
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    ObjLoader::load(filename, threadPool, threadPool.threadCount(), vertices, indices);
+
+    glm::vec3 boundsMin = vertices.empty() ? glm::vec3(0.f) : vertices[0].pos;
+    glm::vec3 boundsMax = boundsMin;
+    for (const Vertex& vertex : vertices)
+    {
+        boundsMin = glm::min(boundsMin, vertex.pos);
+        boundsMax = glm::max(boundsMax, vertex.pos);
+    }
+    float errorLimit = LOD_ERROR_LIMIT * glm::length(boundsMax - boundsMin);
+
+    std::vector<MeshLod> lods;
+    auto startTime = std::chrono::high_resolution_clock::now();
+    MeshSimplifier::buildLodChain(vertices, indices, lods, MAX_LOD_COUNT, errorLimit);
+    double buildSeconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - startTime).count();
+
+    // Distance from the camera to the nearest point of the bounding sphere at which a level's error
+    // projects to exactly LOD_PIXEL_ERROR pixels, for the application's projection and window size.
+    float pixelsPerUnitAtUnitDistance = std::abs(getProjTransform(WIDTH / static_cast<float>(HEIGHT))[1][1]) * HEIGHT * .5f;
+
+    std::cout << "lod chain: " << filename << " (" << lods[0].indexCount / 3 << " triangles, "
+              << vertices.size() << " vertices) | build " << std::fixed << std::setprecision(3)
+              << buildSeconds * 1000.0 << " ms" << std::endl;
+    for (size_t i = 0; i < lods.size(); ++ i)
+    {
+        std::cout << "  LOD " << i << " | " << std::setw(8) << lods[i].indexCount / 3 << " triangles ("
+                  << std::setw(6) << 100.0 * lods[i].indexCount / lods[0].indexCount << "%) | error "
+                  << std::setprecision(5) << lods[i].error << " | switch at "
+                  << std::setprecision(3) << lods[i].error * pixelsPerUnitAtUnitDistance / LOD_PIXEL_ERROR << std::endl;
+    }
+}
+
+void benchmarkMeshOptimizer(const std::string& filename)
+{
+    // Report the FIFO cache behaviour of the file order and of the optimized order for a few cache
+    // sizes, together with how long each optimization pass takes.
+    ThreadPool threadPool;
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    ObjLoader::load(filename, threadPool, threadPool.threadCount(), vertices, indices);
+
+    std::cout << "mesh optimizer: " << filename << " (" << indices.size() / 3 << " triangles, "
+              << vertices.size() << " vertices)" << std::endl;
+
+    for (uint32_t cacheSize : { 8u, 16u, 32u })
+    {
+        std::vector<Vertex> optimizedVertices = vertices;
+        std::vector<uint32_t> optimizedIndices = indices;
+
+        auto startTime = std::chrono::high_resolution_clock::now();
+        MeshOptimizer::optimizeVertexCache(optimizedIndices.data(), optimizedIndices.size(), optimizedVertices.size(), cacheSize);
+        auto cacheTime = std::chrono::high_resolution_clock::now();
+        MeshOptimizer::optimizeVertexFetch(optimizedVertices, optimizedIndices);
+        auto fetchTime = std::chrono::high_resolution_clock::now();
+
+        VertexCacheStats before = MeshOptimizer::analyzeVertexCache(indices.data(), indices.size(), vertices.size(), cacheSize);
+        VertexCacheStats after = MeshOptimizer::analyzeVertexCache(
+            optimizedIndices.data(), optimizedIndices.size(), optimizedVertices.size(), cacheSize);
+
+        std::cout << std::fixed << std::setprecision(3)
+            << "  cache " << std::setw(2) << cacheSize
+            << " | ACMR " << before.acmr << " -> " << after.acmr
+            << " | ATVR " << before.atvr << " -> " << after.atvr
+            << " | tipsify " << std::chrono::duration<double, std::milli>(cacheTime - startTime).count() << " ms"
+            << " | fetch " << std::chrono::duration<double, std::milli>(fetchTime - cacheTime).count() << " ms" << std::endl;
+    }
+}
+
+void benchmarkMipGenerator(const std::string& filename)
+{
+    // Build the full mip chain of the image with 1, 2, 4 and all hardware threads. Throughput is
+    // given in source pixels; the chain below them adds another third.
+    int textureWidth, textureHeight, textureChannels;
+    stbi_uc* pixels = stbi_load(filename.c_str(), &textureWidth, &textureHeight, &textureChannels, STBI_rgb_alpha);
+    if (!pixels)
+    {
+        throw std::runtime_error("failed to load texture image source");
+    }
+
+    uint32_t width = static_cast<uint32_t>(textureWidth);
+    uint32_t height = static_cast<uint32_t>(textureHeight);
+    size_t maxThreads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    std::vector<size_t> threadCounts = { 1, 2, 4 };
+    threadCounts.erase(
+        std::remove_if(threadCounts.begin(), threadCounts.end(), [maxThreads](size_t n) { return n >= maxThreads; }),
+        threadCounts.end()
+    );
+    threadCounts.push_back(maxThreads);
+
+    std::cout << "mip generator: " << filename << " (" << width << "x" << height << ", "
+              << MipGenerator::getLevelCount(width, height) << " levels, " << MipGenerator::getInstructionSet() << ")" << std::endl;
+
+    std::vector<std::vector<uint8_t>> levels;
+    for (size_t threadCount : threadCounts)
+    {
+        // One untimed run first, so that the tables and the level buffers already exist.
+        ThreadPool threadPool(threadCount);
+        MipGenerator::generate(pixels, width, height, levels, threadPool);
+
+        const int runCount = 10;
+        auto startTime = std::chrono::high_resolution_clock::now();
+        for (int run = 0; run < runCount; ++ run)
+        {
+            MipGenerator::generate(pixels, width, height, levels, threadPool);
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - startTime).count() / runCount;
+
+        std::cout << std::fixed << std::setprecision(3)
+            << "  threads " << std::setw(3) << threadCount
+            << " | " << seconds * 1000.0 << " ms"
+            << " | " << std::setprecision(1) << static_cast<double>(width) * height / seconds / 1e6 << " MPix/s" << std::endl;
+    }
+
+    stbi_image_free(pixels);
+}
+
+void benchmarkObjLoader(const std::string& filename)
+{
+    // Load the same file with 1, 2, 4 and all hardware threads; the first run also warms the file
+    // cache so that every measured run reads from memory.
+    ThreadPool threadPool;
+    size_t maxThreads = threadPool.threadCount();
+
+    std::vector<size_t> threadCounts = { 1, 2, 4 };
+    threadCounts.erase(
+        std::remove_if(threadCounts.begin(), threadCounts.end(), [maxThreads](size_t n) { return n >= maxThreads; }),
+        threadCounts.end()
+    );
+    threadCounts.push_back(maxThreads);
+
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    ObjLoader::load(filename, threadPool, maxThreads, vertices, indices);
+
+    std::cout << "OBJ loader: " << filename << std::endl;
+    for (size_t threadCount : threadCounts)
+    {
+        ObjLoadStats stats {};
+        ObjLoader::load(filename, threadPool, threadCount, vertices, indices, &stats);
+
+        double processSeconds = stats.parseSeconds + stats.dedupSeconds + stats.mergeSeconds;
+        std::cout << std::fixed << std::setprecision(3)
+            << "  threads " << std::setw(3) << threadCount
+            << " | chunks " << std::setw(3) << stats.chunkCount
+            << " | parse " << stats.parseSeconds * 1000.0 << " ms"
+            << " | dedup " << stats.dedupSeconds * 1000.0 << " ms"
+            << " | merge " << stats.mergeSeconds * 1000.0 << " ms"
+            << " | " << std::setprecision(2) << stats.faceVertexCount / processSeconds / 1e6 << " M vertices/s"
+            << " (" << stats.uniqueVertexCount << " unique)" << std::endl;
+        std::cout << std::setprecision(3)
+            << "              dedup table: " << stats.dedup.lookups << " lookups"
+            << " | " << stats.dedup.collisions << " collisions"
+            << " | " << stats.dedup.hashCollisions << " hash collisions"
+            << " | avg probe " << stats.dedup.averageProbeLength()
+            << " | max probe " << stats.dedup.maxProbeLength
+            << " | " << stats.dedup.capacity << " slots" << std::endl;
+    }
+}
+
+void benchmarkOverdraw(const std::string& filename)
+{
+    // Rasterize the model at the window resolution from eight evenly spaced points of its spin,
+    // once in file order, once cache-optimized and once with the overdraw pass on top.
+    ThreadPool threadPool;
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> fileIndices;
+    ObjLoader::load(filename, threadPool, threadPool.threadCount(), vertices, fileIndices);
+
+    std::vector<uint32_t> cacheIndices = fileIndices;
+    MeshOptimizer::optimizeVertexCache(cacheIndices.data(), cacheIndices.size(), vertices.size());
+
+    std::vector<uint32_t> overdrawIndices = cacheIndices;
+    auto startTime = std::chrono::high_resolution_clock::now();
+    MeshOptimizer::optimizeOverdraw(overdrawIndices.data(), overdrawIndices.size(), vertices);
+    double optimizeMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+
+    const uint32_t viewCount = 8;
+    glm::mat4 viewProj = getProjTransform(WIDTH / static_cast<float>(HEIGHT)) * getViewTransform();
+
+    std::cout << "overdraw: " << filename << " at " << WIDTH << "x" << HEIGHT << ", " << viewCount << " views"
+              << " (overdraw pass " << std::fixed << std::setprecision(3) << optimizeMilliseconds << " ms)" << std::endl;
+
+    const std::pair<const char*, const std::vector<uint32_t>*> orders[] = {
+        { "file order", &fileIndices },
+        { "vertex cache", &cacheIndices },
+        { "vertex cache + overdraw", &overdrawIndices }
+    };
+    for (const auto& order : orders)
+    {
+        OverdrawStats overdraw {};
+        for (uint32_t view = 0; view < viewCount; ++ view)
+        {
+            // The model turns 90 degrees per second, so four seconds is a full turn.
+            glm::mat4 modelViewProj = viewProj * getModelTransform(4.f * view / viewCount);
+            overdraw.merge(MeshOptimizer::analyzeOverdraw(
+                order.second->data(), order.second->size(), vertices, modelViewProj, WIDTH, HEIGHT));
+        }
+        VertexCacheStats cache = MeshOptimizer::analyzeVertexCache(order.second->data(), order.second->size(), vertices.size());
+
+        std::cout << std::fixed << std::setprecision(3)
+            << "  " << std::left << std::setw(24) << order.first << std::right
+            << " | overdraw " << overdraw.overdraw
+            << " | ACMR " << cache.acmr << std::endl;
+    }
+}
+
+void benchmarkRecording()
+{
+    // Enough objects to split the draws across every thread of the pool, see
+    // MIN_DRAWS_PER_RECORDING_THREAD, and up to well past the 10k draws recording has to scale for.
+    HelloTriangleApplication app;
+    app.runSceneBenchmark({ 1024, 4096, 16384, 65536 }, true, false, 100);
+}
+
+void benchmarkTextureDecoder(const std::string& path)
+{
+    // Decode every image in a directory (or a single file) with 1, 2, 4 and all hardware threads,
+    // one image per task as the texture loader does. The files are read up front, so only decoding
+    // is measured; throughput is given in decoded pixels and in compressed bytes.
+    std::vector<std::string> filenames;
+    if (std::filesystem::is_directory(path))
+    {
+        for (const auto& entry : std::filesystem::directory_iterator(path))
+        {
+            if (entry.is_regular_file()) { filenames.push_back(entry.path().string()); }
+        }
+        std::sort(filenames.begin(), filenames.end());
+    }
+    else
+    {
+        filenames.push_back(path);
+    }
+
+    struct EncodedImage
+    {
+        std::string                     filename;
+        std::vector<uint8_t>            data;
+        uint32_t                        width;
+        uint32_t                        height;
+    };
+
+    std::vector<EncodedImage> images;
+    uint64_t encodedBytes = 0;
+    uint64_t pixelCount = 0;
+    for (const auto& filename : filenames)
+    {
+        std::ifstream file(filename, std::ios::ate | std::ios::binary);
+        if (!file.is_open()) { continue; }
+
+        EncodedImage image {};
+        image.filename = filename;
+        image.data.resize(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        file.read(reinterpret_cast<char*>(image.data.data()), static_cast<std::streamsize>(image.data.size()));
+        if (!file || !TextureDecoder::readInfo(image.data.data(), image.data.size(), image.width, image.height))
+        {
+            continue;
+        }
+
+        encodedBytes += image.data.size();
+        pixelCount += static_cast<uint64_t>(image.width) * image.height;
+        images.push_back(std::move(image));
+    }
+
+    if (images.empty())
+    {
+        throw std::runtime_error("no decodable images found");
+    }
+
+    std::cout << "texture decoder: " << path << " (" << images.size() << " images, " << pixelCount / 1e6 << " MPix, "
+              << encodedBytes / (1024.0 * 1024.0) << " MB)" << std::endl;
+    for (const auto& image : images)
+    {
+        std::cout << "  " << image.filename << ": " << image.width << "x" << image.height << ", "
+                  << TextureDecoder::getDecoderName(image.data.data(), image.data.size()) << std::endl;
+    }
+
+    size_t maxThreads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    std::vector<size_t> threadCounts = { 1, 2, 4 };
+    threadCounts.erase(
+        std::remove_if(threadCounts.begin(), threadCounts.end(), [maxThreads](size_t n) { return n >= maxThreads; }),
+        threadCounts.end()
+    );
+    threadCounts.push_back(maxThreads);
+
+    std::vector<std::vector<uint8_t>> pixels(images.size());
+    for (size_t i = 0; i < images.size(); ++ i)
+    {
+        pixels[i].resize(static_cast<size_t>(images[i].width) * images[i].height * 4);
+    }
+
+    for (size_t threadCount : threadCounts)
+    {
+        ThreadPool threadPool(threadCount);
+        auto startTime = std::chrono::high_resolution_clock::now();
+        threadPool.parallelFor(images.size(), [&](size_t i) {
+            const EncodedImage& image = images[i];
+            TextureDecoder::decode(image.data.data(), image.data.size(), pixels[i].data(), image.width, image.height);
+        });
+        double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - startTime).count();
+
+        std::cout << std::fixed << std::setprecision(3)
+            << "  threads " << std::setw(3) << threadCount
+            << " | " << seconds * 1000.0 << " ms"
+            << " | " << std::setprecision(1) << pixelCount / seconds / 1e6 << " MPix/s"
+            << " | " << encodedBytes / seconds / (1024.0 * 1024.0) << " MB/s" << std::endl;
+    }
+}
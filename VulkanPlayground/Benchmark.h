@@ -0,0 +1,25 @@
+#pragma once
+
+#include <string>
+
+/* ************************************************************************************************
+ * Global Functions
+ * ************************************************************************************************/
+// Command line entry point for the benchmarks, which all run on the CPU alone but for the recording
+// one and the second half of the instancing one; returns false if the arguments do not name a benchmark, in which case the application runs as
+// usual.
+bool runBenchmark(int argc, char** argv);
+
+// Also the allocator's unit test: runs it against a fake device and throws if an allocation breaks
+// its alignment, overlaps another one or shares a granularity page with a resource of the other kind.
+void benchmarkDeviceAllocator();
+void benchmarkIndexCodec(const std::string& filename);
+void benchmarkInstancing();
+void benchmarkLodChain(const std::string& filename);
+void benchmarkMeshOptimizer(const std::string& filename);
+void benchmarkMipGenerator(const std::string& filename);
+void benchmarkObjLoader(const std::string& filename);
+void benchmarkOverdraw(const std::string& filename);
+// Draws the scene on the device at up to 65536 objects with one recording thread up to all of them.
+void benchmarkRecording();
+void benchmarkTextureDecoder(const std::string& path);
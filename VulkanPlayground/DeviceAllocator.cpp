@@ -0,0 +1,510 @@
+#include "DeviceAllocator.h"
+
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+
+/*! ***********************************************************************************************
+ * \class   DeviceAllocator
+ * \author  Leon Vincii
+ * \date    2026.10.16
+ * ************************************************************************************************/
+// Smallest range handed out, 256 bytes; nonCoherentAtomSize and the usual alignments divide it.
+const uint32_t DeviceAllocator::MIN_ORDER = 8;
+
+/* ************************************************************************************************
+ * Public Ctor & Dtor
+ * ************************************************************************************************/
+DeviceAllocator::DeviceAllocator() :
+    m_functions                 ()
+  , m_heapUsage                 ()
+  , m_memoryProperties          ()
+  , m_mutex                     ()
+  , m_pools                     ()
+  , m_separateOptimal           (false)
+{}
+
+DeviceAllocator::~DeviceAllocator()
+{
+    destroy();
+}
+
+/* ************************************************************************************************
+ * Public Functions
+ * ************************************************************************************************/
+void DeviceAllocator::init(VkInstance instance, VkPhysicalDevice physicalDevice, VkDevice device, bool memoryBudget,
+    VkDeviceSize blockSize)
+{
+    VkPhysicalDeviceProperties properties {};
+    vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+    VkPhysicalDeviceMemoryProperties memoryProperties {};
+    vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memoryProperties);
+
+    DeviceMemoryFunctions functions {};
+    functions.allocate = [device](uint32_t memoryTypeIndex, VkDeviceSize size) {
+        VkMemoryAllocateInfo allocInfo {};
+        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocInfo.allocationSize = size;
+        allocInfo.memoryTypeIndex = memoryTypeIndex;
+
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        if (vkAllocateMemory(device, &allocInfo, nullptr, &memory) != VK_SUCCESS)
+        {
+            return static_cast<VkDeviceMemory>(VK_NULL_HANDLE);
+        }
+        return memory;
+    };
+    functions.free = [device](VkDeviceMemory memory) {
+        vkFreeMemory(device, memory, nullptr);
+    };
+    functions.map = [device](VkDeviceMemory memory, VkDeviceSize size) {
+        void* data = nullptr;
+        if (vkMapMemory(device, memory, 0, size, 0, &data) != VK_SUCCESS)
+        {
+            return static_cast<void*>(nullptr);
+        }
+        return data;
+    };
+    // A Vulkan 1.0 loader does not export vkGetPhysicalDeviceMemoryProperties2().
+    auto getMemoryProperties2 = reinterpret_cast<PFN_vkGetPhysicalDeviceMemoryProperties2>(
+        vkGetInstanceProcAddr(instance, "vkGetPhysicalDeviceMemoryProperties2")
+    );
+    if (memoryBudget && getMemoryProperties2 != nullptr)
+    {
+        functions.queryBudget = [physicalDevice, getMemoryProperties2](DeviceHeapBudget* budgets) {
+            VkPhysicalDeviceMemoryBudgetPropertiesEXT budgetProperties {};
+            budgetProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT;
+            VkPhysicalDeviceMemoryProperties2 memoryProperties2 {};
+            memoryProperties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2;
+            memoryProperties2.pNext = &budgetProperties;
+            getMemoryProperties2(physicalDevice, &memoryProperties2);
+
+            for (uint32_t i = 0; i < memoryProperties2.memoryProperties.memoryHeapCount; ++ i)
+            {
+                budgets[i].budget = budgetProperties.heapBudget[i];
+                budgets[i].usage = budgetProperties.heapUsage[i];
+            }
+        };
+    }
+
+    init(std::move(functions), memoryProperties, properties.limits.bufferImageGranularity, blockSize);
+}
+
+void DeviceAllocator::init(DeviceMemoryFunctions functions, const VkPhysicalDeviceMemoryProperties& memoryProperties,
+    VkDeviceSize bufferImageGranularity, VkDeviceSize blockSize)
+{
+    destroy();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_functions = std::move(functions);
+    m_heapUsage.assign(memoryProperties.memoryHeapCount, 0);
+    m_memoryProperties = memoryProperties;
+    m_separateOptimal = bufferImageGranularity > 1;
+
+    // Two pools per memory type, the second one for optimal tiling images. Blocks are powers of two,
+    // so that the whole block is one buddy range; small heaps get smaller blocks, so that a single
+    // block does not take most of the heap.
+    m_pools.resize(2 * static_cast<size_t>(memoryProperties.memoryTypeCount));
+    for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; ++ i)
+    {
+        VkDeviceSize heapSize = memoryProperties.memoryHeaps[memoryProperties.memoryTypes[i].heapIndex].size;
+        VkDeviceSize poolBlockSize = std::max<VkDeviceSize>(std::min(blockSize, heapSize / 8), 1);
+        uint32_t order = getOrder(poolBlockSize);
+        if ((VkDeviceSize(1) << order) > poolBlockSize) { -- order; }
+        order = std::max(order, MIN_ORDER + 1);
+
+        for (size_t kind = 0; kind < 2; ++ kind)
+        {
+            m_pools[2 * i + kind].memoryTypeIndex = i;
+            m_pools[2 * i + kind].heapIndex = memoryProperties.memoryTypes[i].heapIndex;
+            m_pools[2 * i + kind].blockSize = VkDeviceSize(1) << order;
+        }
+    }
+}
+
+void DeviceAllocator::destroy()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto& pool : m_pools)
+    {
+        for (auto& block : pool.blocks)
+        {
+            if (block.memory == VK_NULL_HANDLE) { continue; }
+
+            if (block.allocationCount > 0)
+            {
+                std::cerr << "device allocator: " << block.allocationCount << " allocations of memory type "
+                          << pool.memoryTypeIndex << " still live at shutdown" << std::endl;
+            }
+            destroyBlock(pool, block);
+        }
+    }
+    m_pools.clear();
+}
+
+DeviceAllocation DeviceAllocator::allocate(const VkMemoryRequirements& requirements, MemoryUsage usage,
+    bool optimal)
+{
+    std::vector<uint32_t> memoryTypes = getMemoryTypes(requirements.memoryTypeBits, usage);
+    if (memoryTypes.empty())
+    {
+        throw std::runtime_error("failed to find a suitable memory type");
+    }
+
+    // Go down the memory types from the best one for as long as their heaps are out of budget. Only if
+    // all of them are, exceed a budget rather than fail; the driver may then page memory out.
+    std::lock_guard<std::mutex> lock(m_mutex);
+    DeviceAllocation allocation {};
+    for (uint32_t memoryTypeIndex : memoryTypes)
+    {
+        if (allocateFromType(requirements, memoryTypeIndex, optimal, true, allocation)) { return allocation; }
+    }
+    for (uint32_t memoryTypeIndex : memoryTypes)
+    {
+        if (allocateFromType(requirements, memoryTypeIndex, optimal, false, allocation))
+        {
+            std::cerr << "device allocator: heap " << m_memoryProperties.memoryTypes[memoryTypeIndex].heapIndex
+                      << " is over its budget" << std::endl;
+            return allocation;
+        }
+    }
+
+    throw std::runtime_error("failed to allocate device memory");
+}
+
+DeviceAllocation DeviceAllocator::allocate(const VkMemoryRequirements& requirements, uint32_t memoryTypeIndex,
+    bool optimal)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (memoryTypeIndex >= m_memoryProperties.memoryTypeCount)
+    {
+        throw std::runtime_error("invalid memory type for device allocation");
+    }
+
+    DeviceAllocation allocation {};
+    if (!allocateFromType(requirements, memoryTypeIndex, optimal, false, allocation))
+    {
+        throw std::runtime_error("failed to allocate device memory");
+    }
+    return allocation;
+}
+
+void DeviceAllocator::free(const DeviceAllocation& allocation)
+{
+    if (allocation.memory == VK_NULL_HANDLE) { return; }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Pool& pool = m_pools[allocation.pool];
+    Block& block = pool.blocks[allocation.block];
+    block.allocationCount -= 1;
+    block.usedBytes -= allocation.size;
+
+    if (block.dedicated)
+    {
+        destroyBlock(pool, block);
+        return;
+    }
+
+    // Merge the range with its buddy for as long as that is free as well.
+    block.allocatedBytes -= VkDeviceSize(1) << allocation.order;
+    VkDeviceSize offset = allocation.offset;
+    uint32_t level = allocation.order - MIN_ORDER;
+    while (level + 1 < block.freeRanges.size())
+    {
+        VkDeviceSize buddy = offset ^ (VkDeviceSize(1) << (level + MIN_ORDER));
+        auto it = block.freeRanges[level].find(buddy);
+        if (it == block.freeRanges[level].end()) { break; }
+
+        block.freeRanges[level].erase(it);
+        offset = std::min(offset, buddy);
+        ++ level;
+    }
+    block.freeRanges[level].insert(offset);
+
+    // Keep one empty block per pool around, so that allocations coming and going at the edge of a
+    // block do not allocate and free device memory each time.
+    if (block.allocationCount > 0) { return; }
+
+    for (const auto& other : pool.blocks)
+    {
+        if (&other != &block && other.memory != VK_NULL_HANDLE && !other.dedicated && other.allocationCount == 0)
+        {
+            destroyBlock(pool, block);
+            return;
+        }
+    }
+}
+
+std::vector<DeviceHeapBudget> DeviceAllocator::getBudgets() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return queryBudgets();
+}
+
+std::vector<uint32_t> DeviceAllocator::getMemoryTypes(uint32_t memoryTypeBits, MemoryUsage usage) const
+{
+    /***
+     * Every usage requires some property flags, and prefers or avoids others. The memory types that
+     * have the required flags are ranked by the preferred flags they have less the avoided ones; ties
+     * keep the order of the device, which lists faster types first. Device local memory is only
+     * preferred for GPU-only resources, so that those can still fall back to host memory.
+     ***/
+    VkMemoryPropertyFlags required = 0;
+    VkMemoryPropertyFlags preferred = 0;
+    VkMemoryPropertyFlags avoided = 0;
+    switch (usage)
+    {
+    case MemoryUsage::GpuOnly:
+        preferred = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+        avoided = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+        break;
+    case MemoryUsage::Upload:
+        required = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+        avoided = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+        break;
+    case MemoryUsage::Readback:
+        required = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+        preferred = VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
+        break;
+    case MemoryUsage::Dynamic:
+        required = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+        preferred = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+        break;
+    }
+
+    // Lazily allocated and protected memory only suit special resources.
+    const VkMemoryPropertyFlags excluded = VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT | VK_MEMORY_PROPERTY_PROTECTED_BIT;
+    auto countBits = [](VkMemoryPropertyFlags flags) {
+        int count = 0;
+        for (; flags != 0; flags &= flags - 1) { ++ count; }
+        return count;
+    };
+
+    std::vector<uint32_t> memoryTypes;
+    std::vector<int> scores(m_memoryProperties.memoryTypeCount, 0);
+    for (uint32_t i = 0; i < m_memoryProperties.memoryTypeCount; ++ i)
+    {
+        VkMemoryPropertyFlags flags = m_memoryProperties.memoryTypes[i].propertyFlags;
+        if (!(memoryTypeBits & (1u << i)) || (flags & required) != required || (flags & excluded)) { continue; }
+
+        scores[i] = countBits(flags & preferred) - countBits(flags & avoided);
+        memoryTypes.push_back(i);
+    }
+
+    std::stable_sort(memoryTypes.begin(), memoryTypes.end(),
+        [&scores](uint32_t a, uint32_t b) { return scores[a] > scores[b]; });
+    return memoryTypes;
+}
+
+DeviceAllocatorStats DeviceAllocator::getStats() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    DeviceAllocatorStats stats {};
+    for (const auto& pool : m_pools)
+    {
+        addStats(pool, stats);
+    }
+    return stats;
+}
+
+DeviceAllocatorStats DeviceAllocator::getStats(uint32_t memoryTypeIndex) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    DeviceAllocatorStats stats {};
+    if (2 * static_cast<size_t>(memoryTypeIndex) + 1 < m_pools.size())
+    {
+        addStats(m_pools[2 * memoryTypeIndex], stats);
+        addStats(m_pools[2 * memoryTypeIndex + 1], stats);
+    }
+    return stats;
+}
+
+/* ************************************************************************************************
+ * Private Functions
+ * ************************************************************************************************/
+void DeviceAllocator::addStats(const Pool& pool, DeviceAllocatorStats& stats) const
+{
+    for (const auto& block : pool.blocks)
+    {
+        if (block.memory == VK_NULL_HANDLE) { continue; }
+
+        stats.deviceAllocationCount += 1;
+        stats.blockCount += block.dedicated ? 0 : 1;
+        stats.dedicatedCount += block.dedicated ? 1 : 0;
+        stats.allocationCount += block.allocationCount;
+        stats.reservedBytes += block.size;
+        stats.allocatedBytes += block.allocatedBytes;
+        stats.usedBytes += block.usedBytes;
+
+        for (size_t level = block.freeRanges.size(); level > 0; -- level)
+        {
+            if (!block.freeRanges[level - 1].empty())
+            {
+                stats.largestFreeRange = std::max(stats.largestFreeRange, VkDeviceSize(1) << (level - 1 + MIN_ORDER));
+                break;
+            }
+        }
+    }
+}
+
+bool DeviceAllocator::allocateFromType(const VkMemoryRequirements& requirements, uint32_t memoryTypeIndex,
+    bool optimal, bool withinBudget, DeviceAllocation& allocation)
+{
+    allocation = DeviceAllocation {};
+    allocation.size = std::max<VkDeviceSize>(requirements.size, 1);
+    allocation.pool = 2 * memoryTypeIndex + (optimal && m_separateOptimal ? 1 : 0);
+    allocation.order = getOrder(std::max(allocation.size, requirements.alignment));
+
+    Pool& pool = m_pools[allocation.pool];
+    VkDeviceSize rangeSize = VkDeviceSize(1) << allocation.order;
+    uint32_t blockIndex = UINT32_MAX;
+
+    if (rangeSize > pool.blockSize / 2)
+    {
+        // Offset 0 of an allocation of its own meets any alignment.
+        blockIndex = createBlock(pool, allocation.size, true, withinBudget);
+    }
+    else
+    {
+        for (uint32_t i = 0; i < pool.blocks.size(); ++ i)
+        {
+            Block& block = pool.blocks[i];
+            if (block.memory != VK_NULL_HANDLE && !block.dedicated && allocateRange(block, allocation.order, allocation.offset))
+            {
+                blockIndex = i;
+                break;
+            }
+        }
+
+        // All blocks are full; add one, falling back to smaller ones while the heap has no room for a
+        // whole block.
+        for (VkDeviceSize size = pool.blockSize; blockIndex == UINT32_MAX && size >= rangeSize; size /= 2)
+        {
+            blockIndex = createBlock(pool, size, false, withinBudget);
+            if (blockIndex != UINT32_MAX)
+            {
+                allocateRange(pool.blocks[blockIndex], allocation.order, allocation.offset);
+            }
+        }
+    }
+
+    if (blockIndex == UINT32_MAX) { return false; }
+
+    Block& block = pool.blocks[blockIndex];
+    block.allocationCount += 1;
+    block.allocatedBytes += block.dedicated ? block.size : rangeSize;
+    block.usedBytes += allocation.size;
+
+    allocation.memory = block.memory;
+    allocation.block = blockIndex;
+    allocation.data = block.data != nullptr ? block.data + allocation.offset : nullptr;
+    return true;
+}
+
+bool DeviceAllocator::allocateRange(Block& block, uint32_t order, VkDeviceSize& offset)
+{
+    // Takes the lowest free range of the smallest size that fits and splits it down to the size asked
+    // for, putting the upper halves back as free ranges. Lowest offsets first keeps blocks packed.
+    if (order > block.order) { return false; }
+
+    size_t level = order - MIN_ORDER;
+    size_t sourceLevel = level;
+    while (sourceLevel < block.freeRanges.size() && block.freeRanges[sourceLevel].empty())
+    {
+        ++ sourceLevel;
+    }
+    if (sourceLevel == block.freeRanges.size()) { return false; }
+
+    offset = *block.freeRanges[sourceLevel].begin();
+    block.freeRanges[sourceLevel].erase(block.freeRanges[sourceLevel].begin());
+    while (sourceLevel > level)
+    {
+        -- sourceLevel;
+        block.freeRanges[sourceLevel].insert(offset + (VkDeviceSize(1) << (sourceLevel + MIN_ORDER)));
+    }
+    return true;
+}
+
+uint32_t DeviceAllocator::createBlock(Pool& pool, VkDeviceSize size, bool dedicated, bool withinBudget)
+{
+    // Returns the index of the new block, or UINT32_MAX if the device has no memory left for it or,
+    // with withinBudget, if it would take the heap over its budget.
+    if (withinBudget)
+    {
+        DeviceHeapBudget budget = queryBudgets()[pool.heapIndex];
+        if (budget.usage + size > budget.budget) { return UINT32_MAX; }
+    }
+
+    VkDeviceMemory memory = m_functions.allocate(pool.memoryTypeIndex, size);
+    if (memory == VK_NULL_HANDLE) { return UINT32_MAX; }
+
+    Block block {};
+    block.memory = memory;
+    block.size = size;
+    block.dedicated = dedicated;
+    if (m_memoryProperties.memoryTypes[pool.memoryTypeIndex].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+    {
+        block.data = static_cast<uint8_t*>(m_functions.map(memory, size));
+        if (block.data == nullptr)
+        {
+            m_functions.free(memory);
+            return UINT32_MAX;
+        }
+    }
+    m_heapUsage[pool.heapIndex] += size;
+
+    // The whole block starts out as one free range.
+    if (!dedicated)
+    {
+        block.order = getOrder(size);
+        block.freeRanges.resize(block.order - MIN_ORDER + 1);
+        block.freeRanges.back().insert(0);
+    }
+
+    auto slot = std::find_if(pool.blocks.begin(), pool.blocks.end(),
+        [](const Block& other) { return other.memory == VK_NULL_HANDLE; });
+    if (slot == pool.blocks.end())
+    {
+        pool.blocks.push_back(std::move(block));
+        return static_cast<uint32_t>(pool.blocks.size() - 1);
+    }
+
+    *slot = std::move(block);
+    return static_cast<uint32_t>(slot - pool.blocks.begin());
+}
+
+void DeviceAllocator::destroyBlock(Pool& pool, Block& block)
+{
+    // Freeing the memory also unmaps it.
+    m_functions.free(block.memory);
+    m_heapUsage[pool.heapIndex] -= block.size;
+    block = Block {};
+}
+
+std::vector<DeviceHeapBudget> DeviceAllocator::queryBudgets() const
+{
+    std::vector<DeviceHeapBudget> budgets(m_memoryProperties.memoryHeapCount);
+    if (m_functions.queryBudget)
+    {
+        m_functions.queryBudget(budgets.data());
+        return budgets;
+    }
+
+    for (uint32_t i = 0; i < m_memoryProperties.memoryHeapCount; ++ i)
+    {
+        budgets[i].budget = m_memoryProperties.memoryHeaps[i].size / 10 * 8;
+        budgets[i].usage = m_heapUsage[i];
+    }
+    return budgets;
+}
+
+// Static Functions -------------------------------------------------------------------------------/
+uint32_t DeviceAllocator::getOrder(VkDeviceSize size)
+{
+    uint32_t order = MIN_ORDER;
+    while ((VkDeviceSize(1) << order) < size)
+    {
+        ++ order;
+    }
+    return order;
+}
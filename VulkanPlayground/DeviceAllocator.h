@@ -0,0 +1,196 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <vector>
+
+/* ************************************************************************************************
+ * Global Enums
+ * ************************************************************************************************/
+// How a resource is accessed, which decides the memory it is placed in.
+enum class MemoryUsage
+{
+    // Filled once through a staging copy and then only read by the GPU: device local memory.
+    GpuOnly,
+    // Written once by the CPU and read once by the GPU, i.e. staging: host visible memory, preferably
+    // outside the device local heap, whose host visible part is scarce.
+    Upload,
+    // Written by the GPU and read by the CPU: host visible memory, preferably cached.
+    Readback,
+    // Rewritten by the CPU every frame and read by the GPU: device local memory that is host visible
+    // (resizable BAR, or unified memory) where there is some, host visible memory otherwise.
+    Dynamic
+};
+
+/* ************************************************************************************************
+ * Global Structs
+ * ************************************************************************************************/
+// A range of device memory handed out by DeviceAllocator. Resources are bound at offset within
+// memory; data points at offset if the memory is host visible, which it stays mapped as.
+struct DeviceAllocation
+{
+    VkDeviceMemory                  memory = VK_NULL_HANDLE;
+    VkDeviceSize                    offset = 0;
+    VkDeviceSize                    size = 0;
+    uint8_t*                        data = nullptr;
+    // Where the range came from, for DeviceAllocator::free().
+    uint32_t                        pool = 0;
+    uint32_t                        block = 0;
+    uint32_t                        order = 0;
+};
+
+// Totals over the allocator or one memory type. Device allocations are the vkAllocateMemory calls
+// behind the blocks and dedicated allocations; reserved bytes are their sizes. Used bytes are the
+// sizes asked for, allocated bytes the same after rounding to the buddy sizes.
+struct DeviceAllocatorStats
+{
+    size_t                          deviceAllocationCount = 0;
+    size_t                          blockCount = 0;
+    size_t                          dedicatedCount = 0;
+    size_t                          allocationCount = 0;
+    VkDeviceSize                    reservedBytes = 0;
+    VkDeviceSize                    allocatedBytes = 0;
+    VkDeviceSize                    usedBytes = 0;
+    VkDeviceSize                    largestFreeRange = 0;
+};
+
+// How much of a heap the process may use, and uses, including memory allocated outside the allocator.
+struct DeviceHeapBudget
+{
+    VkDeviceSize                    budget = 0;
+    VkDeviceSize                    usage = 0;
+};
+
+// What the allocator needs of a device. allocate() returns a null handle on failure; map() is only
+// called for host visible memory and maps the whole allocation. queryBudget() fills one entry per
+// heap; without it, the budget is taken to be 80% of each heap and the usage to be the allocator's.
+struct DeviceMemoryFunctions
+{
+    std::function<VkDeviceMemory(uint32_t memoryTypeIndex, VkDeviceSize size)> allocate;
+    std::function<void(VkDeviceMemory memory)> free;
+    std::function<void*(VkDeviceMemory memory, VkDeviceSize size)> map;
+    std::function<void(DeviceHeapBudget* budgets)> queryBudget;
+};
+
+/*! ***********************************************************************************************
+ * \class   DeviceAllocator
+ * \brief   Sub-allocates buffers and images from large blocks of device memory instead of giving
+ *          each its own vkAllocateMemory, which is slow and capped at maxMemoryAllocationCount.
+ *          Every memory type has its own blocks, managed as buddy systems: a range is the smallest
+ *          power of two that holds both the size and the alignment, and since buddy ranges start at
+ *          a multiple of their size, the alignment comes for free. Freed ranges merge with their
+ *          buddies again. Requests larger than half a block get a dedicated allocation.
+ *
+ *          Linear resources (buffers) and optimal tiling images must not share a page of
+ *          bufferImageGranularity bytes, so where the device has such pages the two kinds are kept
+ *          in separate blocks. Host visible blocks are mapped once, for as long as they live.
+ *
+ *          Resources are placed by their MemoryUsage. New blocks are only taken from a heap while it
+ *          stays within its budget, from VK_EXT_memory_budget where the device has it; otherwise the
+ *          next best memory type is tried, and only if none has room is a budget exceeded.
+ *
+ *          The device is reached through DeviceMemoryFunctions only, so the allocator also runs
+ *          against a fake one on the CPU, see benchmarkDeviceAllocator(). Safe on any thread.
+ * \author  Leon Vincii
+ * \date    2026.10.16
+ * ************************************************************************************************/
+class DeviceAllocator
+{
+public:
+    /* ********************************************************************************************
+     * Public Ctor & Dtor
+     * ********************************************************************************************/
+    DeviceAllocator();
+    ~DeviceAllocator();
+
+    DeviceAllocator(const DeviceAllocator&) = delete;
+    DeviceAllocator& operator=(const DeviceAllocator&) = delete;
+
+    /* ********************************************************************************************
+     * Public Functions
+     * ********************************************************************************************/
+    // Allocates through device. memoryBudget is set if VK_EXT_memory_budget is enabled on it, which
+    // also needs Vulkan 1.1; the budgets are then queried through a command loaded from instance.
+    // blockSize is rounded down to a power of two and, for small heaps, limited to an eighth of the heap.
+    void init(VkInstance instance, VkPhysicalDevice physicalDevice, VkDevice device, bool memoryBudget,
+        VkDeviceSize blockSize);
+    void init(DeviceMemoryFunctions functions, const VkPhysicalDeviceMemoryProperties& memoryProperties,
+        VkDeviceSize bufferImageGranularity, VkDeviceSize blockSize);
+    // Frees every block. Allocations that are still live are reported and must not be used any more.
+    void destroy();
+
+    // Throws if no memory type that suits the usage has room. optimal is set for images with optimal
+    // tiling.
+    DeviceAllocation allocate(const VkMemoryRequirements& requirements, MemoryUsage usage, bool optimal);
+    // Like above, but in the given memory type only, regardless of its budget.
+    DeviceAllocation allocate(const VkMemoryRequirements& requirements, uint32_t memoryTypeIndex, bool optimal);
+    // Allocations with null memory are ignored.
+    void free(const DeviceAllocation& allocation);
+
+    std::vector<DeviceHeapBudget> getBudgets() const;
+    // Memory types that suit the usage and the resource, best first.
+    std::vector<uint32_t> getMemoryTypes(uint32_t memoryTypeBits, MemoryUsage usage) const;
+    DeviceAllocatorStats getStats() const;
+    DeviceAllocatorStats getStats(uint32_t memoryTypeIndex) const;
+
+private:
+    /* ********************************************************************************************
+     * Private Structs
+     * ********************************************************************************************/
+    // One vkAllocateMemory. freeRanges[i] holds the offsets of the free ranges of 2^(MIN_ORDER + i)
+    // bytes; a dedicated allocation has none and is split no further.
+    struct Block
+    {
+        VkDeviceMemory                  memory = VK_NULL_HANDLE;
+        uint8_t*                        data = nullptr;
+        VkDeviceSize                    size = 0;
+        uint32_t                        order = 0;
+        bool                            dedicated = false;
+        std::vector<std::set<VkDeviceSize>> freeRanges;
+        size_t                          allocationCount = 0;
+        VkDeviceSize                    allocatedBytes = 0;
+        VkDeviceSize                    usedBytes = 0;
+    };
+
+    // The blocks of one memory type and resource kind. Freed blocks leave a null slot behind, which
+    // the next block takes, so that the block index of an allocation stays valid.
+    struct Pool
+    {
+        uint32_t                        memoryTypeIndex = 0;
+        uint32_t                        heapIndex = 0;
+        VkDeviceSize                    blockSize = 0;
+        std::vector<Block>              blocks;
+    };
+
+    /* ********************************************************************************************
+     * Private Functions
+     * ********************************************************************************************/
+    void addStats(const Pool& pool, DeviceAllocatorStats& stats) const;
+    bool allocateFromType(const VkMemoryRequirements& requirements, uint32_t memoryTypeIndex, bool optimal,
+        bool withinBudget, DeviceAllocation& allocation);
+    bool allocateRange(Block& block, uint32_t order, VkDeviceSize& offset);
+    uint32_t createBlock(Pool& pool, VkDeviceSize size, bool dedicated, bool withinBudget);
+    void destroyBlock(Pool& pool, Block& block);
+    std::vector<DeviceHeapBudget> queryBudgets() const;
+
+    // Static Functions ---------------------------------------------------------------------------/
+    static uint32_t getOrder(VkDeviceSize size);
+
+    /* ********************************************************************************************
+     * Private Attributes
+     * ********************************************************************************************/
+    DeviceMemoryFunctions           m_functions;
+    // Device memory the allocator holds per heap.
+    std::vector<VkDeviceSize>       m_heapUsage;
+    VkPhysicalDeviceMemoryProperties m_memoryProperties;
+    mutable std::mutex              m_mutex;
+    std::vector<Pool>               m_pools;
+    bool                            m_separateOptimal;
+
+    // Constants ----------------------------------------------------------------------------------/
+    static const uint32_t           MIN_ORDER;
+};
@@ -4,17 +4,14 @@
 #define GLM_FORCE_RADIANS
 #include <glm/gtc/matrix_transform.hpp>
 
-#define STB_IMAGE_IMPLEMENTATION
-#include <stb_image.h>
-
-#define TINYOBJLOADER_IMPLEMENTATION
-#include <tiny_obj_loader.h>
-
+#include <algorithm>
 #include <chrono>
 #include <cstdint>
+#include <filesystem>
 #include <fstream>
+#include <iomanip>
+#include <limits>
 #include <set>
-#include <unordered_map>
 
 /* ************************************************************************************************
  * Global Functions
@@ -43,6 +40,25 @@ void DestroyDebugUtilsMessengerEXT(VkInstance instance, VkDebugUtilsMessengerEXT
     }
 }
 
+glm::mat4 getModelTransform(float seconds)
+{
+    // Spin around the z axis at 90 degrees per second.
+    return glm::rotate(glm::mat4(1.f), seconds * glm::radians(90.f), glm::vec3(0.f, 0.f, 1.f));
+}
+
+glm::mat4 getProjTransform(float aspectRatio)
+{
+    glm::mat4 proj = glm::perspective(glm::radians(45.f), aspectRatio, .1f, 10.f);
+    // Flip the Y coordinate as GLM was originally designed for OpenGL, where the Y coordinate is inverted.
+    proj[1][1] *= -1;
+    return proj;
+}
+
+glm::mat4 getViewTransform()
+{
+    return glm::lookAt(glm::vec3(2.f, 2.f, 2.f), glm::vec3(0.f, 0.f, 0.f), glm::vec3(0.f, 0.f, 1.f));
+}
+
 /*! ***********************************************************************************************
  * \class   HelloTriangleApplication
  * \author  Leon Vincii
@@ -52,11 +68,17 @@ void DestroyDebugUtilsMessengerEXT(VkInstance instance, VkDebugUtilsMessengerEXT
   * Public Ctor & Dtor
   * ***********************************************************************************************/
 HelloTriangleApplication::HelloTriangleApplication() :
-    m_colorImage                ()
+    m_allocator                 ()
+  , m_apiVersion                (VK_API_VERSION_1_0)
+  , m_bindlessDescriptorPool    ()
+  , m_bindlessDescriptorSetLayout ()
+  , m_bindlessDescriptorSets    ()
+  , m_bindlessTextureCount      (0)
+  , m_boundingSphere            (0.f)
+  , m_colorImage                ()
   , m_colorImageMemory          ()
   , m_colorImageView            ()
-  , m_commandBuffers            ()
-  , m_commandPool               ()
+  , m_commandPoolTransfer       ()
   , m_commandPoolTransient      ()
   , m_currentFrame              (0)
   , m_debugMessenger            ()
@@ -67,17 +89,46 @@ HelloTriangleApplication::HelloTriangleApplication() :
   , m_descriptorSetLayout       ()
   , m_descriptorSets            ()
   , m_device                    ()
+  , m_deviceFeatures            ()
+  , m_drawCommandBuffer         ()
+  , m_drawCommandBufferMemory   ()
+  , m_drawCountBuffer           ()
+  , m_drawCountBufferMemory     ()
+  , m_drawIndexedIndirectCount  (nullptr)
+  , m_drawIndirectCount         (false)
+  , m_frameCommands             ()
   , m_graphicsPipeline          ()
   , m_graphicsQueue             ()
   , m_indexBuffer               ()
   , m_indexBufferMemory         ()
+  , m_indexCount                (0)
+  , m_indexType                 (VK_INDEX_TYPE_UINT32)
   , m_indices                   ()
   , m_instance                  ()
-  , m_mipLevels                 (0)
+  , m_instanceBuffer            ()
+  , m_instanceBufferMemory      ()
+  , m_instancedDraws            (enableInstancing)
+  , m_lodBuffer                 ()
+  , m_lodBufferMemory           ()
+  , m_lods                      ()
+  , m_maxDrawIndirectCount      (1)
+  , m_meshCache                 ()
+  , m_meshlets                  ()
+  , m_meshletTriangles          ()
+  , m_meshletVertices           ()
   , m_msaaSamples               (VK_SAMPLE_COUNT_1_BIT)
+  , m_objectBuffer              ()
+  , m_objectBufferMemory        ()
+  , m_objectPositions           ()
   , m_physicalDevice            (VK_NULL_HANDLE)
+  , m_placeholderImage          ()
+  , m_placeholderImageMemory    ()
+  , m_placeholderImageView      ()
   , m_pipelineLayout            ()
   , m_presentQueue              ()
+  , m_queueFamilyIndices        ()
+  , m_recordingThreadLimit      (0)
+  , m_recordingThreadPool       ()
   , m_renderPass                ()
   , m_surface                   ()
   , m_swapchain                 ()
@@ -86,18 +137,28 @@ HelloTriangleApplication::HelloTriangleApplication() :
   , m_swapchainImages           ()
   , m_swapchainImageFormat      ()
   , m_swapchainImageViews       ()
-  , m_textureImage              ()
-  , m_textureImageMemory        ()
-  , m_textureImageView          ()
   , m_textureSampler            ()
-  , m_uniformBuffers            ()
-  , m_uniformBuffersMemory      ()
+  , m_threadPool                ()
+  , m_timestampMask             (0)
+  , m_timestampPeriod           (0.f)
+  , m_timestampQueryPool        ()
+  , m_transferQueue             ()
+  , m_uniformBuffer             ()
+  , m_uniformBufferMemory       ()
+  , m_uniformRing               ()
   , m_vertices                  ()
   , m_vertexBuffer              ()
   , m_vertexBufferMemory        ()
+  , m_vertexDecode              ()
   , m_window                    ()
     // Auxiliaries --------------------------------------------------------------------------------/
+  , m_firstFramePresented       (false)
+  , m_frameCount                (0)
   , m_framebufferResized        (false)
+  , m_gpuFrameCount             (0)
+  , m_gpuSeconds                (0.0)
+  , m_recordingSeconds          (0.0)
+  , m_startTime                 ()
     // Constants ----------------------------------------------------------------------------------/
   , m_MAX_FRAMES_IN_FLIGHT      (2)
     // Semaphores ---------------------------------------------------------------------------------/
@@ -105,6 +166,45 @@ HelloTriangleApplication::HelloTriangleApplication() :
   , m_imageUsageFences          ()
   , m_cmdBufferExecFences       ()
   , m_renderFinishedSemaphores  ()
+    // Uploads ------------------------------------------------------------------------------------/
+  , m_openUpload                ()
+  , m_uploads                   ()
+  , m_uploadStats               ()
+    // GPU Culling --------------------------------------------------------------------------------/
+  , m_cullDescriptorPool        ()
+  , m_cullDescriptorSetLayout   ()
+  , m_cullPipeline              ()
+  , m_cullPipelineLayout        ()
+  , m_cullingStats              ()
+  , m_depthPyramid              ()
+  , m_depthPyramidLevelViews    ()
+  , m_depthPyramidMemory        ()
+  , m_depthPyramidReady         (false)
+  , m_depthPyramidSampler       ()
+  , m_depthPyramidView          ()
+  , m_depthReduceDescriptorPool ()
+  , m_depthReduceDescriptorSetLayout ()
+  , m_depthReduceDescriptorSets ()
+  , m_depthReducePipeline       ()
+  , m_depthReducePipelineLayout ()
+  , m_frameCulling              ()
+    // Texture Loading ----------------------------------------------------------------------------/
+  , m_stagingRegion             ()
+  , m_stagingRing               ()
+  , m_textureBatchesInFlight    (0)
+  , m_textureLoads              ()
+  , m_textureLoadStats          ()
+  , m_textureLoadStatsMutex     ()
+    // Texture Streaming --------------------------------------------------------------------------/
+  , m_textures                  ()
+  , m_textureMemory             (0)
+  , m_retiredTextures           ()
+    // Asset Streaming ----------------------------------------------------------------------------/
+  , m_descriptorSetsDirty       ()
+  , m_modelFuture               ()
+  , m_modelReady                (false)
+  , m_streamingThreadPool       (1)
+  , m_textureThreadPool         ()
 {}
 
 /* ************************************************************************************************
@@ -112,6 +212,8 @@ HelloTriangleApplication::HelloTriangleApplication() :
  * ************************************************************************************************/
 void HelloTriangleApplication::run()
 {
+    m_startTime = std::chrono::high_resolution_clock::now();
+
     // Initialise GLFW window.
     initWindow();
     initVulkan();
@@ -119,31 +221,210 @@ void HelloTriangleApplication::run()
     cleanup();
 }
 
+void HelloTriangleApplication::runSceneBenchmark(const std::vector<uint32_t>& objectCounts, bool sweepThreads,
+    bool compareInstancing, uint32_t frameCount)
+{
+    /***
+     * The frames are drawn, submitted and presented as in mainLoop(), from when the model has streamed
+     * in. Every scene is swapped in with the device idle and first drawn for a few frames that are not
+     * measured, which upload it and point every frame's descriptor sets at it. Only the direct draws
+     * are split across threads; the indirect and instanced ones are recorded on the main thread. To
+     * compare instancing, the counts are drawn once with a draw per object and once instanced, with the
+     * pipeline recreated along with the swapchain in between. The GPU time of a frame is taken between
+     * timestamps around its commands, so it includes any wait for its swapchain image.
+     ***/
+    const uint32_t warmupFrameCount = 2 * static_cast<uint32_t>(m_MAX_FRAMES_IN_FLIGHT);
+
+    m_startTime = std::chrono::high_resolution_clock::now();
+    initWindow();
+    initVulkan();
+    while (!m_modelReady && !glfwWindowShouldClose(m_window))
+    {
+        glfwPollEvents();
+        drawFrame();
+    }
+
+    std::vector<bool> instancedModes { m_instancedDraws };
+    if (compareInstancing && !enableIndirectDraw)
+    {
+        instancedModes = { false, true };
+    }
+
+    for (bool instanced : instancedModes)
+    {
+        if (instanced != m_instancedDraws)
+        {
+            m_instancedDraws = instanced;
+            recreateSwapchain();
+        }
+
+        std::vector<size_t> threadCounts { m_recordingThreadPool.threadCount() };
+        if (sweepThreads && enableParallelRecording && !enableIndirectDraw && !m_instancedDraws)
+        {
+            threadCounts.clear();
+            for (size_t threadCount = 1; threadCount < m_recordingThreadPool.threadCount(); threadCount *= 2)
+            {
+                threadCounts.push_back(threadCount);
+            }
+            threadCounts.push_back(m_recordingThreadPool.threadCount());
+        }
+
+        std::cout << "scene benchmark: "
+                  << (enableIndirectDraw ? "indirect draws" : m_instancedDraws ? "instanced draws" : "draws")
+                  << ", " << frameCount << " frames each" << std::endl;
+        for (uint32_t objectCount : objectCounts)
+        {
+            vkDeviceWaitIdle(m_device);
+            destroyScene();
+            createScene(objectCount);
+
+            for (size_t threadCount : threadCounts)
+            {
+                m_recordingThreadLimit = threadCount;
+                for (uint32_t i = 0; i < warmupFrameCount && !glfwWindowShouldClose(m_window); ++ i)
+                {
+                    glfwPollEvents();
+                    drawFrame();
+                }
+
+                double recordingSeconds = m_recordingSeconds;
+                double gpuSeconds = m_gpuSeconds;
+                uint64_t gpuFrameCount = m_gpuFrameCount;
+                auto startTime = std::chrono::high_resolution_clock::now();
+                uint32_t drawnCount = 0;
+                for (; drawnCount < frameCount && !glfwWindowShouldClose(m_window); ++ drawnCount)
+                {
+                    glfwPollEvents();
+                    drawFrame();
+                }
+                if (drawnCount == 0) { break; }
+                double frameSeconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - startTime).count();
+
+                std::cout << std::fixed << std::setprecision(3)
+                    << "  " << std::setw(6) << objectCount << " objects, " << std::setw(2) << threadCount << " threads: "
+                    << std::setw(8) << (m_recordingSeconds - recordingSeconds) * 1000.0 / drawnCount << " ms recording, "
+                    << std::setw(8) << frameSeconds * 1000.0 / drawnCount << " ms per frame";
+                if (m_gpuFrameCount > gpuFrameCount)
+                {
+                    std::cout << ", " << std::setw(8) << (m_gpuSeconds - gpuSeconds) * 1000.0 / (m_gpuFrameCount - gpuFrameCount)
+                              << " ms on the GPU";
+                }
+                std::cout << std::endl;
+            }
+        }
+    }
+    m_recordingThreadLimit = m_recordingThreadPool.threadCount();
+
+    vkDeviceWaitIdle(m_device);
+    cleanup();
+}
+
 /* ************************************************************************************************
  * Private Functions
  * ************************************************************************************************/
 void HelloTriangleApplication::cleanup()
 {
+    // Wait for the streaming jobs and release whatever they still hold.
+    finishAssetStreaming();
+
+    // Report how the resources ended up packed into device memory.
+    DeviceAllocatorStats memoryStats = m_allocator.getStats();
+    std::cout << "device memory: " << memoryStats.allocationCount << " allocations in "
+              << memoryStats.deviceAllocationCount << " device allocations (" << memoryStats.blockCount << " blocks, "
+              << memoryStats.dedicatedCount << " dedicated), used " << memoryStats.usedBytes / 1048576.0
+              << " MiB, reserved " << memoryStats.reservedBytes / 1048576.0 << " MiB" << std::endl;
+    std::vector<DeviceHeapBudget> budgets = m_allocator.getBudgets();
+    for (size_t i = 0; i < budgets.size(); ++ i)
+    {
+        std::cout << "  heap " << i << ": " << budgets[i].usage / 1048576.0 << " of " << budgets[i].budget / 1048576.0
+                  << " MiB budget" << std::endl;
+    }
+
+    // Report what recording the frames took on the CPU.
+    if (m_frameCount > 0)
+    {
+        std::cout << "command recording: " << m_objectPositions.size()
+                  << (enableIndirectDraw ? " indirect draws" : m_instancedDraws ? " instances" : " draws") << " on up to "
+                  << m_recordingThreadPool.threadCount() << " threads, " << m_recordingSeconds * 1000.0 / m_frameCount
+                  << " ms per frame" << std::endl;
+    }
+    if (m_gpuFrameCount > 0)
+    {
+        std::cout << "gpu time: " << m_gpuSeconds * 1000.0 / m_gpuFrameCount << " ms per frame over "
+                  << m_gpuFrameCount << " frames" << std::endl;
+    }
+
+    // Report what the culling has culled, and whether the GPU agreed with the CPU on the frustum.
+    if (m_cullingStats.frameCount > 0)
+    {
+        double frameCount = static_cast<double>(m_cullingStats.frameCount);
+        std::cout << "gpu culling: " << m_cullingStats.objectCount / frameCount << " objects per frame, "
+                  << m_cullingStats.frustumCulled / frameCount << " outside the frustum, "
+                  << m_cullingStats.occlusionCulled / frameCount << " occluded, " << m_cullingStats.drawn / frameCount
+                  << " drawn; " << m_cullingStats.mismatchCount << " of " << m_cullingStats.frameCount
+                  << " frames differ from the CPU by up to " << m_cullingStats.largestMismatch << " objects" << std::endl;
+    }
+
+    // Destroy the staging region; freeing its memory also unmaps it.
+    vkDestroyBuffer(m_device, m_stagingRegion.buffer, nullptr);
+    m_allocator.free(m_stagingRegion.allocation);
+
     // Destroy swapchain.
     destroySwapchain();
 
     // Destroy descriptor set layouts.
     vkDestroyDescriptorSetLayout(m_device, m_descriptorSetLayout, nullptr);
+    vkDestroyDescriptorSetLayout(m_device, m_bindlessDescriptorSetLayout, nullptr);
 
     // Destroy samplers.
     vkDestroySampler(m_device, m_textureSampler, nullptr);
 
+    // Destroy the culling pipelines and what they are bound with.
+    for (const auto& culling : m_frameCulling)
+    {
+        vkDestroyBuffer(m_device, culling.counterBuffer, nullptr);
+        m_allocator.free(culling.counterBufferMemory);
+    }
+    vkDestroyDescriptorPool(m_device, m_cullDescriptorPool, nullptr);
+    vkDestroySampler(m_device, m_depthPyramidSampler, nullptr);
+    vkDestroyPipeline(m_device, m_cullPipeline, nullptr);
+    vkDestroyPipelineLayout(m_device, m_cullPipelineLayout, nullptr);
+    vkDestroyDescriptorSetLayout(m_device, m_cullDescriptorSetLayout, nullptr);
+    vkDestroyPipeline(m_device, m_depthReducePipeline, nullptr);
+    vkDestroyPipelineLayout(m_device, m_depthReducePipelineLayout, nullptr);
+    vkDestroyDescriptorSetLayout(m_device, m_depthReduceDescriptorSetLayout, nullptr);
+
     // Destroy image views, images and free their memory.
-    vkDestroyImageView(m_device, m_textureImageView, nullptr);
-    vkDestroyImage(m_device, m_textureImage, nullptr);
-    vkFreeMemory(m_device, m_textureImageMemory, nullptr);
+    for (const auto& texture : m_textures)
+    {
+        destroyTexture(texture);
+    }
+    for (const auto& texture : m_retiredTextures)
+    {
+        destroyTexture(texture);
+    }
+
+    vkDestroyImageView(m_device, m_placeholderImageView, nullptr);
+    vkDestroyImage(m_device, m_placeholderImage, nullptr);
+    m_allocator.free(m_placeholderImageMemory);
 
     // Destroy buffers and free their memory.
     vkDestroyBuffer(m_device, m_vertexBuffer, nullptr);
-    vkFreeMemory(m_device, m_vertexBufferMemory, nullptr);
+    m_allocator.free(m_vertexBufferMemory);
 
     vkDestroyBuffer(m_device, m_indexBuffer, nullptr);
-    vkFreeMemory(m_device, m_indexBufferMemory, nullptr);
+    m_allocator.free(m_indexBufferMemory);
+
+    destroyScene();
+
+    vkDestroyBuffer(m_device, m_lodBuffer, nullptr);
+    m_allocator.free(m_lodBufferMemory);
+
+    vkDestroyBuffer(m_device, m_uniformBuffer, nullptr);
+    m_allocator.free(m_uniformBufferMemory);
+
+    // Unmap the mesh cache.
+    m_meshCache.close();
 
     // Destroy semaphores.
     for (size_t i = 0; i < m_MAX_FRAMES_IN_FLIGHT; ++ i)
@@ -153,9 +434,24 @@ void HelloTriangleApplication::cleanup()
         vkDestroyFence(m_device, m_cmdBufferExecFences[i], nullptr);
     }
 
-    // Destroy command pools.
-    vkDestroyCommandPool(m_device, m_commandPool, nullptr);
+    // Destroy command pools, which frees their command buffers.
+    for (const auto& frame : m_frameCommands)
+    {
+        vkDestroyCommandPool(m_device, frame.commandPool, nullptr);
+        for (auto commandPool : frame.secondaryCommandPools)
+        {
+            vkDestroyCommandPool(m_device, commandPool, nullptr);
+        }
+    }
     vkDestroyCommandPool(m_device, m_commandPoolTransient, nullptr);
+    vkDestroyQueryPool(m_device, m_timestampQueryPool, nullptr);
+    if (m_commandPoolTransfer != VK_NULL_HANDLE)
+    {
+        vkDestroyCommandPool(m_device, m_commandPoolTransfer, nullptr);
+    }
+
+    // Free the device memory blocks, which everything above has been sub-allocated from.
+    m_allocator.destroy();
 
     // Destroy logical device.
     vkDestroyDevice(m_device, nullptr);
@@ -185,107 +481,350 @@ void HelloTriangleApplication::createColorResources()
     createImage(
         m_swapchainExtent.width, m_swapchainExtent.height, 1, m_msaaSamples, colorFormat,
         VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT | VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT,
-        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_colorImage, m_colorImageMemory
+        MemoryUsage::GpuOnly, m_colorImage, m_colorImageMemory
     );
-    m_colorImageView = createImageView(m_colorImage, 1, colorFormat, VK_IMAGE_ASPECT_COLOR_BIT);
+    m_colorImageView = createImageView(m_colorImage, 0, 1, colorFormat, VK_IMAGE_ASPECT_COLOR_BIT);
 }
 
 void HelloTriangleApplication::createCommandBuffers()
 {
-    m_commandBuffers.resize(m_swapchainFramebuffers.size());
+    /***
+     * Every frame in flight gets a pool for its primary command buffer and one per recording thread
+     * for a secondary command buffer each. The command buffers are recorded every frame in drawFrame(),
+     * once the levels of detail to draw are known, so nothing is recorded here. They do not depend on
+     * the swapchain and are not recreated with it, and neither does the query pool the frames write
+     * their timestamps to.
+     ***/
+    VkCommandPoolCreateInfo poolInfo {};
+    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    poolInfo.queueFamilyIndex = m_queueFamilyIndices.graphicsFamily.value();
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+
+    auto createCommandBuffer = [this, &poolInfo](VkCommandBufferLevel level, VkCommandPool& commandPool,
+        VkCommandBuffer& commandBuffer) {
+        if (vkCreateCommandPool(m_device, &poolInfo, nullptr, &commandPool) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create frame command pool");
+        }
+
+        VkCommandBufferAllocateInfo commandBufferAllocInfo {};
+        commandBufferAllocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        commandBufferAllocInfo.commandPool = commandPool;
+        commandBufferAllocInfo.level = level;
+        commandBufferAllocInfo.commandBufferCount = 1;
+
+        if (vkAllocateCommandBuffers(m_device, &commandBufferAllocInfo, &commandBuffer) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to allocate command buffers");
+        }
+    };
+
+    m_recordingThreadLimit = m_recordingThreadPool.threadCount();
+    m_frameCommands.resize(m_MAX_FRAMES_IN_FLIGHT);
+    for (auto& frame : m_frameCommands)
+    {
+        createCommandBuffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY, frame.commandPool, frame.commandBuffer);
+
+        frame.secondaryCommandPools.resize(m_recordingThreadPool.threadCount());
+        frame.secondaryCommandBuffers.resize(m_recordingThreadPool.threadCount());
+        for (size_t i = 0; i < frame.secondaryCommandPools.size(); ++ i)
+        {
+            createCommandBuffer(
+                VK_COMMAND_BUFFER_LEVEL_SECONDARY, frame.secondaryCommandPools[i], frame.secondaryCommandBuffers[i]
+            );
+        }
+    }
+
+    // The frames measure their commands on the GPU where the graphics queue writes timestamps at all.
+    uint32_t queueFamilyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(m_physicalDevice, &queueFamilyCount, nullptr);
+    std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(m_physicalDevice, &queueFamilyCount, queueFamilies.data());
+    uint32_t validBits = queueFamilies[m_queueFamilyIndices.graphicsFamily.value()].timestampValidBits;
+    if (validBits == 0) { return; }
+
+    VkPhysicalDeviceProperties properties {};
+    vkGetPhysicalDeviceProperties(m_physicalDevice, &properties);
+    m_timestampPeriod = properties.limits.timestampPeriod;
+    m_timestampMask = validBits < 64 ? (uint64_t(1) << validBits) - 1 : ~uint64_t(0);
+
+    VkQueryPoolCreateInfo queryPoolInfo {};
+    queryPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    queryPoolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    queryPoolInfo.queryCount = 2 * static_cast<uint32_t>(m_MAX_FRAMES_IN_FLIGHT);
+
+    if (vkCreateQueryPool(m_device, &queryPoolInfo, nullptr, &m_timestampQueryPool) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create timestamp query pool");
+    }
+}
+
+void HelloTriangleApplication::createCommandPools()
+{
+    QueueFamilyIndices queueFamilyIndices = findQueueFamilies(m_physicalDevice);
 
-    VkCommandBufferAllocateInfo commandBufferAllocInfo {};
-    commandBufferAllocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-    commandBufferAllocInfo.commandPool = m_commandPool;
-    commandBufferAllocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-    commandBufferAllocInfo.commandBufferCount = static_cast<uint32_t>(m_commandBuffers.size());
+    // The command pools of the frames are created along with their command buffers.
+    VkCommandPoolCreateInfo poolInfo {};
+    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    poolInfo.queueFamilyIndex = queueFamilyIndices.graphicsFamily.value();
+
+    // Create a separate transient command pool for short-lived command buffers (e.g., buffer copy commands).
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
 
-    if (vkAllocateCommandBuffers(m_device, &commandBufferAllocInfo, m_commandBuffers.data()) != VK_SUCCESS)
+    if (vkCreateCommandPool(m_device, &poolInfo, nullptr, &m_commandPoolTransient) != VK_SUCCESS)
     {
-        throw std::runtime_error("failed to allocate command buffers");
+        throw std::runtime_error("failed to create transient command pool");
     }
 
-    for (size_t i = 0; i < m_commandBuffers.size(); ++ i)
+    // Upload command buffers for the transfer queue, if there is one, come from a pool of its own.
+    if (m_transferQueue != VK_NULL_HANDLE)
     {
-        VkCommandBufferBeginInfo beginInfo {};
-        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-        beginInfo.flags = 0;
-        beginInfo.pInheritanceInfo = nullptr;
+        poolInfo.queueFamilyIndex = m_queueFamilyIndices.transferFamily.value();
+        if (vkCreateCommandPool(m_device, &poolInfo, nullptr, &m_commandPoolTransfer) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create transfer command pool");
+        }
+    }
+}
+
+void HelloTriangleApplication::createCullingResources()
+{
+    /***
+     * Everything of the culling but the depth pyramid, which depends on the swapchain: the compute
+     * pipelines that cull the objects and build the pyramid, the sampler both read depth with, and
+     * for every frame in flight a buffer its counters are read back from and the descriptor set the
+     * culling is bound with. The sets are only written once the draw commands exist.
+     ***/
+    auto createComputePipeline = [this](const std::vector<VkDescriptorSetLayoutBinding>& bindings,
+        uint32_t pushConstantSize, const std::string& filename, VkDescriptorSetLayout& descriptorSetLayout,
+        VkPipelineLayout& pipelineLayout, VkPipeline& pipeline) {
+        VkDescriptorSetLayoutCreateInfo layoutInfo {};
+        layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+        layoutInfo.pBindings = bindings.data();
+        if (vkCreateDescriptorSetLayout(m_device, &layoutInfo, nullptr, &descriptorSetLayout) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create descriptor set layout");
+        }
 
-        // Start command buffer recording.
-        if (vkBeginCommandBuffer(m_commandBuffers[i], &beginInfo) != VK_SUCCESS)
+        VkPushConstantRange pushConstantRange {};
+        pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        pushConstantRange.offset = 0;
+        pushConstantRange.size = pushConstantSize;
+
+        VkPipelineLayoutCreateInfo pipelineLayoutInfo {};
+        pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        pipelineLayoutInfo.setLayoutCount = 1;
+        pipelineLayoutInfo.pSetLayouts = &descriptorSetLayout;
+        pipelineLayoutInfo.pushConstantRangeCount = 1;
+        pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+        if (vkCreatePipelineLayout(m_device, &pipelineLayoutInfo, nullptr, &pipelineLayout) != VK_SUCCESS)
         {
-            throw std::runtime_error("failed to begin recording command buffer");
+            throw std::runtime_error("failed to create pipeline layout");
         }
 
-        // Begin render pass.
-        std::array<VkClearValue, 2> clearValues {};
-        clearValues[0].color = { 0.0f, 0.0f, 0.0f, 1.0f };
-        clearValues[1].depthStencil = { 1.0f, 0 };
+        VkShaderModule shaderModule = createShaderModule(readFile(filename));
 
-        VkRenderPassBeginInfo renderPassInfo {};
-        renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-        renderPassInfo.renderPass = m_renderPass;
-        renderPassInfo.framebuffer = m_swapchainFramebuffers[i];
-        renderPassInfo.renderArea.offset = { 0, 0 };
-        renderPassInfo.renderArea.extent = m_swapchainExtent;
-        renderPassInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
-        renderPassInfo.pClearValues = clearValues.data();
+        VkComputePipelineCreateInfo pipelineInfo {};
+        pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+        pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+        pipelineInfo.stage.module = shaderModule;
+        pipelineInfo.stage.pName = "main";
+        pipelineInfo.layout = pipelineLayout;
 
-        vkCmdBeginRenderPass(m_commandBuffers[i], &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+        VkResult result = vkCreateComputePipelines(m_device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &pipeline);
+        vkDestroyShaderModule(m_device, shaderModule, nullptr);
+        if (result != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create compute pipeline");
+        }
+    };
 
-        // Bind graphics pipeline.
-        vkCmdBindPipeline(m_commandBuffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, m_graphicsPipeline);
+    auto binding = [](uint32_t index, VkDescriptorType type) {
+        VkDescriptorSetLayoutBinding layoutBinding {};
+        layoutBinding.binding = index;
+        layoutBinding.descriptorType = type;
+        layoutBinding.descriptorCount = 1;
+        layoutBinding.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        layoutBinding.pImmutableSamplers = nullptr;
+        return layoutBinding;
+    };
 
-        // Bind the vertex buffer.
-        VkBuffer vertexBuffers[] = { m_vertexBuffer };
-        VkDeviceSize offsets[] = { 0 };
-        vkCmdBindVertexBuffers(m_commandBuffers[i], 0, 1, vertexBuffers, offsets);
+    // Objects, draw commands, draw count, counters, the depth pyramid and the levels of detail.
+    createComputePipeline(
+        {
+            binding(0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER), binding(1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER),
+            binding(2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER), binding(3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER),
+            binding(4, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER), binding(5, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER)
+        },
+        sizeof(CullingConstants), "shaders/cull.spv", m_cullDescriptorSetLayout, m_cullPipelineLayout,
+        m_cullPipeline
+    );
+    // Depth buffer, source and destination level; the level and the sample count are pushed.
+    createComputePipeline(
+        {
+            binding(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER), binding(1, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE),
+            binding(2, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE)
+        },
+        2 * sizeof(uint32_t), m_msaaSamples > VK_SAMPLE_COUNT_1_BIT ? "shaders/depth_reduce_ms.spv" : "shaders/depth_reduce.spv",
+        m_depthReduceDescriptorSetLayout, m_depthReducePipelineLayout, m_depthReducePipeline
+    );
 
-        // Bind the index buffer.
-        vkCmdBindIndexBuffer(m_commandBuffers[i], m_indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+    // Depth is only ever fetched texel by texel.
+    VkSamplerCreateInfo samplerInfo {};
+    samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    samplerInfo.magFilter = VK_FILTER_NEAREST;
+    samplerInfo.minFilter = VK_FILTER_NEAREST;
+    samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+    samplerInfo.minLod = 0.f;
+    samplerInfo.maxLod = VK_LOD_CLAMP_NONE;
 
-        // Bind the right descriptor set for each swapchain image to the descriptors in the shader.
-        vkCmdBindDescriptorSets(
-            m_commandBuffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipelineLayout, 0, 1,
-            &m_descriptorSets[i], 0, nullptr
-        );
+    if (vkCreateSampler(m_device, &samplerInfo, nullptr, &m_depthPyramidSampler) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create depth pyramid sampler");
+    }
+
+    // Create descriptor pool and sets for the frames in flight.
+    std::array<VkDescriptorPoolSize, 2> poolSizes {};
+    poolSizes[0].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    poolSizes[0].descriptorCount = m_MAX_FRAMES_IN_FLIGHT * 5;
+    poolSizes[1].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    poolSizes[1].descriptorCount = m_MAX_FRAMES_IN_FLIGHT;
+
+    VkDescriptorPoolCreateInfo poolInfo {};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+    poolInfo.pPoolSizes = poolSizes.data();
+    poolInfo.maxSets = m_MAX_FRAMES_IN_FLIGHT;
+
+    if (vkCreateDescriptorPool(m_device, &poolInfo, nullptr, &m_cullDescriptorPool) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create culling descriptor pool");
+    }
 
-        // Draw using the command in the command buffer.
-        vkCmdDrawIndexed(m_commandBuffers[i], static_cast<uint32_t>(m_indices.size()), 1, 0, 0, 0);
+    m_frameCulling.resize(m_MAX_FRAMES_IN_FLIGHT);
+    for (auto& culling : m_frameCulling)
+    {
+        // The counters are written by the GPU and read by the CPU, so they live in readback memory,
+        // which stays mapped.
+        createBuffer(
+            sizeof(CullingCounters), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+            MemoryUsage::Readback, culling.counterBuffer, culling.counterBufferMemory
+        );
 
-        // End render pass.
-        vkCmdEndRenderPass(m_commandBuffers[i]);
+        VkDescriptorSetAllocateInfo allocInfo {};
+        allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocInfo.descriptorPool = m_cullDescriptorPool;
+        allocInfo.descriptorSetCount = 1;
+        allocInfo.pSetLayouts = &m_cullDescriptorSetLayout;
 
-        // Finish command buffer recording.
-        if (vkEndCommandBuffer(m_commandBuffers[i]) != VK_SUCCESS)
+        if (vkAllocateDescriptorSets(m_device, &allocInfo, &culling.descriptorSet) != VK_SUCCESS)
         {
-            throw std::runtime_error("failed to record command buffer");
+            throw std::runtime_error("failed to allocate culling descriptor sets");
         }
     }
 }
 
-void HelloTriangleApplication::createCommandPools()
+void HelloTriangleApplication::createDepthPyramid()
 {
-    QueueFamilyIndices queueFamilyIndices = findQueueFamilies(m_physicalDevice);
+    /***
+     * Level 0 has the size of the depth buffer and every further level half the size of the one above,
+     * down to a single texel. Every level is written through a view of its own and read through the
+     * view of the level below, so each gets a descriptor set for its reduction. The pyramid stays in
+     * the general layout, into which the first frame to build it moves it, and is not ready before.
+     ***/
+    uint32_t width = m_swapchainExtent.width;
+    uint32_t height = m_swapchainExtent.height;
+    uint32_t levelCount = static_cast<uint32_t>(std::floor(std::log2(std::max(width, height)))) + 1;
 
-    // Create normal command pool.
-    VkCommandPoolCreateInfo poolInfo {};
-    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
-    poolInfo.queueFamilyIndex = queueFamilyIndices.graphicsFamily.value();
-    poolInfo.flags = 0;
+    createImage(
+        width, height, levelCount, VK_SAMPLE_COUNT_1_BIT, VK_FORMAT_R32_SFLOAT, VK_IMAGE_TILING_OPTIMAL,
+        VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, MemoryUsage::GpuOnly, m_depthPyramid,
+        m_depthPyramidMemory
+    );
+    m_depthPyramidView = createImageView(m_depthPyramid, 0, levelCount, VK_FORMAT_R32_SFLOAT, VK_IMAGE_ASPECT_COLOR_BIT);
+    m_depthPyramidLevelViews.resize(levelCount);
+    for (uint32_t i = 0; i < levelCount; ++ i)
+    {
+        m_depthPyramidLevelViews[i] = createImageView(
+            m_depthPyramid, i, 1, VK_FORMAT_R32_SFLOAT, VK_IMAGE_ASPECT_COLOR_BIT
+        );
+    }
+
+    // Create descriptor pool and sets for the reductions.
+    std::array<VkDescriptorPoolSize, 2> poolSizes {};
+    poolSizes[0].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    poolSizes[0].descriptorCount = levelCount;
+    poolSizes[1].type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+    poolSizes[1].descriptorCount = levelCount * 2;
+
+    VkDescriptorPoolCreateInfo poolInfo {};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+    poolInfo.pPoolSizes = poolSizes.data();
+    poolInfo.maxSets = levelCount;
 
-    if (vkCreateCommandPool(m_device, &poolInfo, nullptr, &m_commandPool) != VK_SUCCESS)
+    if (vkCreateDescriptorPool(m_device, &poolInfo, nullptr, &m_depthReduceDescriptorPool) != VK_SUCCESS)
     {
-        throw std::runtime_error("failed to create command pool");
+        throw std::runtime_error("failed to create depth reduction descriptor pool");
     }
 
-    // Create a separate transient command pool for short-lived command buffers (e.g., buffer copy commands).
-    poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+    std::vector<VkDescriptorSetLayout> descriptorSetLayouts(levelCount, m_depthReduceDescriptorSetLayout);
+    VkDescriptorSetAllocateInfo allocInfo {};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = m_depthReduceDescriptorPool;
+    allocInfo.descriptorSetCount = levelCount;
+    allocInfo.pSetLayouts = descriptorSetLayouts.data();
 
-    if (vkCreateCommandPool(m_device, &poolInfo, nullptr, &m_commandPoolTransient) != VK_SUCCESS)
+    m_depthReduceDescriptorSets.resize(levelCount);
+    if (vkAllocateDescriptorSets(m_device, &allocInfo, m_depthReduceDescriptorSets.data()) != VK_SUCCESS)
     {
-        throw std::runtime_error("failed to create transient command pool");
+        throw std::runtime_error("failed to allocate depth reduction descriptor sets");
+    }
+
+    // Level 0 reads the depth buffer instead of a level above; its source is bound but never read.
+    for (uint32_t i = 0; i < levelCount; ++ i)
+    {
+        VkDescriptorImageInfo depthInfo {};
+        depthInfo.imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+        depthInfo.imageView = m_depthImageView;
+        depthInfo.sampler = m_depthPyramidSampler;
+
+        VkDescriptorImageInfo sourceInfo {};
+        sourceInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+        sourceInfo.imageView = m_depthPyramidLevelViews[i > 0 ? i - 1 : 0];
+
+        VkDescriptorImageInfo destinationInfo {};
+        destinationInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+        destinationInfo.imageView = m_depthPyramidLevelViews[i];
+
+        std::array<VkWriteDescriptorSet, 3> writeDescriptors {};
+        std::array<const VkDescriptorImageInfo*, 3> imageInfos = { &depthInfo, &sourceInfo, &destinationInfo };
+        for (uint32_t binding = 0; binding < writeDescriptors.size(); ++ binding)
+        {
+            writeDescriptors[binding].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            writeDescriptors[binding].dstSet = m_depthReduceDescriptorSets[i];
+            writeDescriptors[binding].dstBinding = binding;
+            writeDescriptors[binding].dstArrayElement = 0;
+            writeDescriptors[binding].descriptorType = binding == 0 ?
+                VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER : VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+            writeDescriptors[binding].descriptorCount = 1;
+            writeDescriptors[binding].pImageInfo = imageInfos[binding];
+        }
+
+        vkUpdateDescriptorSets(
+            m_device, static_cast<uint32_t>(writeDescriptors.size()), writeDescriptors.data(), 0, nullptr
+        );
+    }
+
+    m_depthPyramidReady = false;
+    for (auto& culling : m_frameCulling)
+    {
+        culling.descriptorSetDirty = true;
     }
 }
 
@@ -296,25 +835,28 @@ void HelloTriangleApplication::createDepthResources()
     // Create depth image.
     createImage(
         m_swapchainExtent.width, m_swapchainExtent.height, 1, m_msaaSamples, depthFormat,
-        VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
-        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_depthImage, m_depthImageMemory
+        VK_IMAGE_TILING_OPTIMAL,
+        VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | (enableGpuCulling ? VK_IMAGE_USAGE_SAMPLED_BIT : 0),
+        MemoryUsage::GpuOnly, m_depthImage, m_depthImageMemory
     );
 
     // Create depth image view.
-    m_depthImageView = createImageView(m_depthImage, 1, depthFormat, VK_IMAGE_ASPECT_DEPTH_BIT);
+    m_depthImageView = createImageView(m_depthImage, 0, 1, depthFormat, VK_IMAGE_ASPECT_DEPTH_BIT);
 }
 
 void HelloTriangleApplication::createDescriptorSetlayout()
 {
-    // Describe the binding for uniform buffer object.
+    // Describe the binding for uniform buffer object, which is a block of the uniform ring picked by a
+    // dynamic offset when the set is bound.
     VkDescriptorSetLayoutBinding uboLayoutBinding {};
     uboLayoutBinding.binding = 0;
-    uboLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    uboLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
     uboLayoutBinding.descriptorCount = 1;
     uboLayoutBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
     uboLayoutBinding.pImmutableSamplers = nullptr;
 
-    // Describe the binding for combined image sampler.
+    // Describe the binding for combined image sampler, unless the textures are bindless and have a set
+    // of their own.
     VkDescriptorSetLayoutBinding samplerLayoutBinding {};
     samplerLayoutBinding.binding = 1;
     samplerLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
@@ -322,97 +864,155 @@ void HelloTriangleApplication::createDescriptorSetlayout()
     samplerLayoutBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
     samplerLayoutBinding.pImmutableSamplers = nullptr;
 
+    // Describe the binding for the objects' transforms, which indirect draws read by instance index.
+    VkDescriptorSetLayoutBinding objectLayoutBinding {};
+    objectLayoutBinding.binding = 2;
+    objectLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    objectLayoutBinding.descriptorCount = 1;
+    objectLayoutBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+    objectLayoutBinding.pImmutableSamplers = nullptr;
+
     // Create descriptor set layout object.
-    std::array<VkDescriptorSetLayoutBinding, 2> layoutBindings = {
-        uboLayoutBinding, samplerLayoutBinding
-    };
+    std::vector<VkDescriptorSetLayoutBinding> layoutBindings = { uboLayoutBinding };
+    if (m_bindlessTextureCount == 0)
+    {
+        layoutBindings.push_back(samplerLayoutBinding);
+    }
+    if (enableIndirectDraw)
+    {
+        layoutBindings.push_back(objectLayoutBinding);
+    }
     VkDescriptorSetLayoutCreateInfo layoutInfo {};
     layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-    layoutInfo.bindingCount = 2;
+    layoutInfo.bindingCount = static_cast<uint32_t>(layoutBindings.size());
     layoutInfo.pBindings = layoutBindings.data();
 
     if (vkCreateDescriptorSetLayout(m_device, &layoutInfo, nullptr, &m_descriptorSetLayout) != VK_SUCCESS)
     {
         throw std::runtime_error("failed to create descriptor set layout");
     }
+
+    if (m_bindlessTextureCount == 0) { return; }
+
+    /***
+     * Bindless, the array of all textures is set 1. Only the slots of loaded textures are written, the
+     * rest stays empty. Update-after-bind is what lifts the array size from the per-stage sampler
+     * limit, which can be as low as 16, to the much higher update-after-bind limits. A layout with
+     * update-after-bind must not hold dynamic buffers, which is why the array is kept apart from the
+     * uniform block.
+     ***/
+    VkDescriptorSetLayoutBinding bindlessLayoutBinding {};
+    bindlessLayoutBinding.binding = 0;
+    bindlessLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    bindlessLayoutBinding.descriptorCount = m_bindlessTextureCount;
+    bindlessLayoutBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+    bindlessLayoutBinding.pImmutableSamplers = nullptr;
+
+    VkDescriptorBindingFlags bindingFlags =
+        VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT;
+    VkDescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsInfo {};
+    bindingFlagsInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+    bindingFlagsInfo.bindingCount = 1;
+    bindingFlagsInfo.pBindingFlags = &bindingFlags;
+
+    VkDescriptorSetLayoutCreateInfo bindlessLayoutInfo {};
+    bindlessLayoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    bindlessLayoutInfo.pNext = &bindingFlagsInfo;
+    bindlessLayoutInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+    bindlessLayoutInfo.bindingCount = 1;
+    bindlessLayoutInfo.pBindings = &bindlessLayoutBinding;
+
+    if (vkCreateDescriptorSetLayout(m_device, &bindlessLayoutInfo, nullptr, &m_bindlessDescriptorSetLayout) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create bindless descriptor set layout");
+    }
 }
 
 void HelloTriangleApplication::createDescriptorSets()
 {
-    std::vector<VkDescriptorSetLayout> descriptorSetLayouts(m_swapchainImages.size(), m_descriptorSetLayout);
+    // One set per frame in flight, which its command buffers bind once; the draws only differ in push
+    // constants. A frame's set is updated while its fence has signalled, so no submission reads it.
+    std::vector<VkDescriptorSetLayout> descriptorSetLayouts(m_MAX_FRAMES_IN_FLIGHT, m_descriptorSetLayout);
 
     VkDescriptorSetAllocateInfo allocInfo {};
     allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
     allocInfo.descriptorPool = m_descriptorPool;
-    allocInfo.descriptorSetCount = static_cast<uint32_t>(m_swapchainImages.size());
+    allocInfo.descriptorSetCount = static_cast<uint32_t>(m_MAX_FRAMES_IN_FLIGHT);
     allocInfo.pSetLayouts = descriptorSetLayouts.data();
 
-    m_descriptorSets.resize(m_swapchainImages.size());
+    m_descriptorSets.resize(m_MAX_FRAMES_IN_FLIGHT);
     if (vkAllocateDescriptorSets(m_device, &allocInfo, m_descriptorSets.data()) != VK_SUCCESS)
     {
         throw std::runtime_error("failed to allocate descriptor sets");
     }
 
-    // Update every descriptor within the descriptor sets.
-    for (size_t i = 0; i < m_swapchainImages.size(); ++ i)
-    {
-        VkDescriptorBufferInfo bufferInfo {};
-        bufferInfo.buffer = m_uniformBuffers[i];
-        bufferInfo.offset = 0;
-        bufferInfo.range = sizeof(UniformBufferObject);
-
-        VkDescriptorImageInfo imageInfo {};
-        imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-        imageInfo.imageView = m_textureImageView;
-        imageInfo.sampler = m_textureSampler;
-
-        std::array<VkWriteDescriptorSet, 2> writeDescriptors {};
-
-        writeDescriptors[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-        writeDescriptors[0].dstSet = m_descriptorSets[i];
-        writeDescriptors[0].dstBinding = 0;
-        writeDescriptors[0].dstArrayElement = 0;
-        writeDescriptors[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-        writeDescriptors[0].descriptorCount = 1;
-        writeDescriptors[0].pBufferInfo = &bufferInfo;
-
-        writeDescriptors[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-        writeDescriptors[1].dstSet = m_descriptorSets[i];
-        writeDescriptors[1].dstBinding = 1;
-        writeDescriptors[1].dstArrayElement = 0;
-        writeDescriptors[1].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-        writeDescriptors[1].descriptorCount = 1;
-        writeDescriptors[1].pImageInfo = &imageInfo;
+    // Bindless, every frame also has a texture array set, from the update-after-bind pool.
+    m_bindlessDescriptorSets.clear();
+    if (m_bindlessTextureCount > 0)
+    {
+        std::vector<VkDescriptorSetLayout> bindlessLayouts(m_MAX_FRAMES_IN_FLIGHT, m_bindlessDescriptorSetLayout);
+        allocInfo.descriptorPool = m_bindlessDescriptorPool;
+        allocInfo.pSetLayouts = bindlessLayouts.data();
 
-        vkUpdateDescriptorSets(
-            m_device, static_cast<uint32_t>(writeDescriptors.size()), writeDescriptors.data(), 0,
-            nullptr
-        );
+        m_bindlessDescriptorSets.resize(m_MAX_FRAMES_IN_FLIGHT);
+        if (vkAllocateDescriptorSets(m_device, &allocInfo, m_bindlessDescriptorSets.data()) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to allocate bindless descriptor sets");
+        }
+    }
+
+    // Update every descriptor within the descriptor sets.
+    m_descriptorSetsDirty.assign(m_MAX_FRAMES_IN_FLIGHT, true);
+    for (size_t i = 0; i < m_descriptorSets.size(); ++ i)
+    {
+        updateDescriptorSet(i);
     }
 }
 
 void HelloTriangleApplication::createDescriptorPool()
 {
     // Describe which descriptor types the descriptor sets are going to contain and how many of them.
-    std::array<VkDescriptorPoolSize, 2> poolSizes {};
+    uint32_t setCount = static_cast<uint32_t>(m_MAX_FRAMES_IN_FLIGHT);
+    std::vector<VkDescriptorPoolSize> poolSizes(1);
+    poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+    poolSizes[0].descriptorCount = setCount;
 
-    poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-    poolSizes[0].descriptorCount = static_cast<uint32_t>(m_swapchainImages.size());
-
-    poolSizes[1].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    poolSizes[1].descriptorCount = static_cast<uint32_t>(m_swapchainImages.size());
+    if (m_bindlessTextureCount == 0)
+    {
+        poolSizes.push_back({ VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, setCount });
+    }
+    if (enableIndirectDraw)
+    {
+        poolSizes.push_back({ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, setCount });
+    }
 
     // Create descriptor pool.
     VkDescriptorPoolCreateInfo poolInfo {};
     poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
     poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
     poolInfo.pPoolSizes = poolSizes.data();
-    poolInfo.maxSets = static_cast<uint32_t>(m_swapchainImages.size());
+    poolInfo.maxSets = setCount;
 
     if (vkCreateDescriptorPool(m_device, &poolInfo, nullptr, &m_descriptorPool) != VK_SUCCESS)
     {
         throw std::runtime_error("failed to create descriptor pool");
     }
+
+    if (m_bindlessTextureCount == 0) { return; }
+
+    // The bindless texture arrays come from a pool of their own, as only it may be update-after-bind.
+    VkDescriptorPoolSize bindlessPoolSize {};
+    bindlessPoolSize.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    bindlessPoolSize.descriptorCount = setCount * m_bindlessTextureCount;
+
+    poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+    poolInfo.poolSizeCount = 1;
+    poolInfo.pPoolSizes = &bindlessPoolSize;
+
+    if (vkCreateDescriptorPool(m_device, &poolInfo, nullptr, &m_bindlessDescriptorPool) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create bindless descriptor pool");
+    }
 }
 
 void HelloTriangleApplication::createFramebuffers()
@@ -449,8 +1049,14 @@ void HelloTriangleApplication::createFramebuffers()
 
 void HelloTriangleApplication::createGraphicsPipeline()
 {
-    auto vertShader = readFile("shaders/vert.spv");
-    auto fragShader = readFile("shaders/frag.spv");
+    // The indirect and instanced vertex shaders decode every vertex layout, which is the identity for
+    // Float.
+    auto vertShader = readFile(
+        enableIndirectDraw ? "shaders/vert_indirect.spv" :
+        m_instancedDraws ? "shaders/vert_instanced.spv" :
+        VERTEX_LAYOUT == VertexLayout::Float ? "shaders/vert.spv" : "shaders/vert_packed.spv"
+    );
+    auto fragShader = readFile(m_bindlessTextureCount > 0 ? "shaders/frag_bindless.spv" : "shaders/frag.spv");
 
     VkShaderModule vertShaderModule = createShaderModule(vertShader);
     VkShaderModule fragShaderModule = createShaderModule(fragShader);
@@ -470,14 +1076,33 @@ void HelloTriangleApplication::createGraphicsPipeline()
 
     VkPipelineShaderStageCreateInfo shaderStages[] = { vertShaderStageInfo, fragShaderStageInfo };
 
-    // Vertex input.
-    auto bindDescription = Vertex::getBindingDescription();
-    auto attrDescriptions = Vertex::getAttributeDescriptions();
+    // Vertex input, matching the layout the vertex buffer was packed in, and instanced, the placements
+    // of the instances from a second binding.
+    std::vector<VkVertexInputAttributeDescription> attrDescriptions;
+    std::vector<VkVertexInputBindingDescription> bindDescriptions;
+    if (VERTEX_LAYOUT == VertexLayout::Float)
+    {
+        auto descriptions = Vertex::getAttributeDescriptions();
+        attrDescriptions.assign(descriptions.begin(), descriptions.end());
+        bindDescriptions.push_back(Vertex::getBindingDescription());
+    }
+    else
+    {
+        auto descriptions = PackedVertex::getAttributeDescriptions(VERTEX_LAYOUT);
+        attrDescriptions.assign(descriptions.begin(), descriptions.end());
+        bindDescriptions.push_back(PackedVertex::getBindingDescription());
+    }
+    if (m_instancedDraws)
+    {
+        auto descriptions = InstanceData::getAttributeDescriptions();
+        attrDescriptions.insert(attrDescriptions.end(), descriptions.begin(), descriptions.end());
+        bindDescriptions.push_back(InstanceData::getBindingDescription());
+    }
 
     VkPipelineVertexInputStateCreateInfo vertexInputInfo {};
     vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-    vertexInputInfo.vertexBindingDescriptionCount = 1;
-    vertexInputInfo.pVertexBindingDescriptions = &bindDescription;
+    vertexInputInfo.vertexBindingDescriptionCount = static_cast<uint32_t>(bindDescriptions.size());
+    vertexInputInfo.pVertexBindingDescriptions = bindDescriptions.data();
     vertexInputInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(attrDescriptions.size());
     vertexInputInfo.pVertexAttributeDescriptions = attrDescriptions.data();
 
@@ -567,10 +1192,21 @@ void HelloTriangleApplication::createGraphicsPipeline()
     // Specify uniform values (pipeline layout).
     VkPipelineLayoutCreateInfo pipelineLayoutInfo {};
     pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-    pipelineLayoutInfo.setLayoutCount = 1;
-    pipelineLayoutInfo.pSetLayouts = &m_descriptorSetLayout;
-    pipelineLayoutInfo.pushConstantRangeCount = 0;
-    pipelineLayoutInfo.pPushConstantRanges = nullptr;
+    // Set 0 is the frame's, set 1 the bindless texture array.
+    VkDescriptorSetLayout setLayouts[] = { m_descriptorSetLayout, m_bindlessDescriptorSetLayout };
+    pipelineLayoutInfo.setLayoutCount = m_bindlessTextureCount > 0 ? 2 : 1;
+    pipelineLayoutInfo.pSetLayouts = setLayouts;
+    // Draws place their object by a push constant transform, and bindless, pick their texture by a
+    // push constant index.
+    VkPushConstantRange pushConstantRanges[2] {};
+    pushConstantRanges[0].stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+    pushConstantRanges[0].offset = offsetof(PushConstants, transform);
+    pushConstantRanges[0].size = sizeof(PushConstants::transform);
+    pushConstantRanges[1].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+    pushConstantRanges[1].offset = offsetof(PushConstants, textureIndex);
+    pushConstantRanges[1].size = sizeof(PushConstants::textureIndex);
+    pipelineLayoutInfo.pushConstantRangeCount = m_bindlessTextureCount > 0 ? 2 : 1;
+    pipelineLayoutInfo.pPushConstantRanges = pushConstantRanges;
 
     if (vkCreatePipelineLayout(m_device, &pipelineLayoutInfo, nullptr, &m_pipelineLayout) != VK_SUCCESS)
     {
@@ -615,60 +1251,36 @@ void HelloTriangleApplication::createImageViews()
     for (size_t i = 0; i < m_swapchainImageViews.size(); ++i)
     {
         m_swapchainImageViews[i] = createImageView(
-            m_swapchainImages[i], 1, m_swapchainImageFormat, VK_IMAGE_ASPECT_COLOR_BIT
+            m_swapchainImages[i], 0, 1, m_swapchainImageFormat, VK_IMAGE_ASPECT_COLOR_BIT
         );
     }
 }
 
-void HelloTriangleApplication::createIndexBuffer()
+void HelloTriangleApplication::createInstance()
 {
-    // Create staging buffer (visible on CPU).
-    VkDeviceSize bufferSize = sizeof(m_indices[0]) * m_indices.size();
-    VkBuffer stagingBuffer;
-    VkDeviceMemory stagingBufferMemory;
-    createBuffer(
-        bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-        stagingBuffer, stagingBufferMemory
+    if (enableValidationLayers && !checkValidationLayerSupport()) {
+        throw std::runtime_error("validation layers requested, but not available");
+    }
+
+    VkApplicationInfo appInfo {};
+    appInfo.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
+    appInfo.pApplicationName = "Vulkan Playground";
+    appInfo.applicationVersion = VK_MAKE_VERSION(1, 0, 0);
+    appInfo.pEngineName = "No Engine";
+    appInfo.engineVersion = VK_MAKE_VERSION(1, 0, 0);
+    // Vulkan 1.2 for descriptor indexing and indirect draw counts, where the loader has it; a Vulkan 1.0
+    // loader has no vkEnumerateInstanceVersion() and rejects any later version. createLogicalDevice()
+    // only relies on what both the instance and the device have.
+    auto enumerateInstanceVersion = reinterpret_cast<PFN_vkEnumerateInstanceVersion>(
+        vkGetInstanceProcAddr(nullptr, "vkEnumerateInstanceVersion")
     );
-
-    // Map the staging buffer memory into CPU accessible memory.
-    void* data;
-    vkMapMemory(m_device, stagingBufferMemory, 0, bufferSize, 0, &data);
-
-    // Copy the vertices to the (mapped) buffer memory.
-    memcpy(data, m_indices.data(), static_cast<size_t>(bufferSize));
-
-    // Unmap the staging buffer memory.
-    vkUnmapMemory(m_device, stagingBufferMemory);
-
-    // Create destination buffer (not visible on CPU).
-    createBuffer(
-        bufferSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
-        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_indexBuffer, m_indexBufferMemory
-    );
-
-    // Copy buffer from staging buffer to destination buffer.
-    copyBuffer(stagingBuffer, m_indexBuffer, bufferSize);
-
-    // Clean up staging buffer and its memory.
-    vkDestroyBuffer(m_device, stagingBuffer, nullptr);
-    vkFreeMemory(m_device, stagingBufferMemory, nullptr);
-}
-
-void HelloTriangleApplication::createInstance()
-{
-    if (enableValidationLayers && !checkValidationLayerSupport()) {
-        throw std::runtime_error("validation layers requested, but not available");
-    }
-
-    VkApplicationInfo appInfo {};
-    appInfo.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
-    appInfo.pApplicationName = "Vulkan Playground";
-    appInfo.applicationVersion = VK_MAKE_VERSION(1, 0, 0);
-    appInfo.pEngineName = "No Engine";
-    appInfo.engineVersion = VK_MAKE_VERSION(1, 0, 0);
-    appInfo.apiVersion = VK_API_VERSION_1_0;
+    m_apiVersion = VK_API_VERSION_1_0;
+    if (enumerateInstanceVersion != nullptr && enumerateInstanceVersion(&m_apiVersion) != VK_SUCCESS)
+    {
+        m_apiVersion = VK_API_VERSION_1_0;
+    }
+    m_apiVersion = std::min(m_apiVersion, VK_API_VERSION_1_2);
+    appInfo.apiVersion = m_apiVersion;
 
     VkInstanceCreateInfo createInfo {};
     createInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
@@ -701,11 +1313,19 @@ void HelloTriangleApplication::createInstance()
 void HelloTriangleApplication::createLogicalDevice()
 {
     QueueFamilyIndices indices = findQueueFamilies(m_physicalDevice);
+    if (!enableTransferQueue)
+    {
+        indices.transferFamily.reset();
+    }
 
     std::vector<VkDeviceQueueCreateInfo> queueCreateInfoVec;
     std::set<uint32_t> uniqueQueueFamilies = {
         indices.graphicsFamily.value(), indices.presentFamily.value()
     };
+    if (indices.transferFamily.has_value())
+    {
+        uniqueQueueFamilies.insert(indices.transferFamily.value());
+    }
 
     float queuePriority = 1.0f;
     for (uint32_t queueFamily : uniqueQueueFamilies)
@@ -719,20 +1339,130 @@ void HelloTriangleApplication::createLogicalDevice()
         queueCreateInfoVec.push_back(queueCreateInfo);
     }
 
-    // Specify the used device features.
+    // Specify the used device features. BC texture sampling is optional; without it textures fall
+    // back to uncompressed RGBA8.
+    VkPhysicalDeviceFeatures supportedFeatures {};
+    vkGetPhysicalDeviceFeatures(m_physicalDevice, &supportedFeatures);
+
     VkPhysicalDeviceFeatures deviceFeatures {};
     deviceFeatures.samplerAnisotropy = VK_TRUE;
     deviceFeatures.sampleRateShading = VK_TRUE;
+    deviceFeatures.textureCompressionBC = supportedFeatures.textureCompressionBC;
+    // Without multiDrawIndirect, every indirect draw takes a single command. Indirect draws pass the
+    // object index as the first instance, which cannot be done without.
+    deviceFeatures.multiDrawIndirect = enableIndirectDraw ? supportedFeatures.multiDrawIndirect : VK_FALSE;
+    deviceFeatures.drawIndirectFirstInstance = enableIndirectDraw;
+    if (enableIndirectDraw && !supportedFeatures.drawIndirectFirstInstance)
+    {
+        throw std::runtime_error("indirect draws are not supported without drawIndirectFirstInstance");
+    }
+    m_deviceFeatures = deviceFeatures;
+
+    VkPhysicalDeviceProperties properties {};
+    vkGetPhysicalDeviceProperties(m_physicalDevice, &properties);
+    m_maxDrawIndirectCount = deviceFeatures.multiDrawIndirect ? properties.limits.maxDrawIndirectCount : 1;
+    // The device is only used as the version that both it and the instance have. Commands added after
+    // Vulkan 1.0 are loaded rather than linked, as a Vulkan 1.0 loader does not export them.
+    uint32_t apiVersion = std::min(properties.apiVersion, m_apiVersion);
+    auto getPhysicalDeviceFeatures2 = reinterpret_cast<PFN_vkGetPhysicalDeviceFeatures2>(
+        vkGetInstanceProcAddr(m_instance, "vkGetPhysicalDeviceFeatures2")
+    );
+    auto getPhysicalDeviceProperties2 = reinterpret_cast<PFN_vkGetPhysicalDeviceProperties2>(
+        vkGetInstanceProcAddr(m_instance, "vkGetPhysicalDeviceProperties2")
+    );
+
+    // Bindless textures need a partially bound, update-after-bind array of a size known only at run
+    // time. Without these features, m_bindlessTextureCount stays 0 and textures are bound one per set.
+    if (enableBindlessTextures && apiVersion >= VK_API_VERSION_1_2 && getPhysicalDeviceFeatures2 != nullptr &&
+        getPhysicalDeviceProperties2 != nullptr)
+    {
+        VkPhysicalDeviceDescriptorIndexingFeatures indexingFeatures {};
+        indexingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES;
+        VkPhysicalDeviceFeatures2 features2 {};
+        features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+        features2.pNext = &indexingFeatures;
+        getPhysicalDeviceFeatures2(m_physicalDevice, &features2);
+
+        VkPhysicalDeviceDescriptorIndexingProperties indexingProperties {};
+        indexingProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES;
+        VkPhysicalDeviceProperties2 properties2 {};
+        properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+        properties2.pNext = &indexingProperties;
+        getPhysicalDeviceProperties2(m_physicalDevice, &properties2);
+
+        // The shader indexes the array with a push constant, which is dynamically uniform.
+        if (indexingFeatures.descriptorBindingPartiallyBound && indexingFeatures.runtimeDescriptorArray &&
+            indexingFeatures.descriptorBindingSampledImageUpdateAfterBind &&
+            supportedFeatures.shaderSampledImageArrayDynamicIndexing)
+        {
+            // A combined image sampler counts as a sampled image and as a sampler.
+            m_bindlessTextureCount = std::min({
+                MAX_BINDLESS_TEXTURES,
+                indexingProperties.maxPerStageDescriptorUpdateAfterBindSampledImages,
+                indexingProperties.maxPerStageDescriptorUpdateAfterBindSamplers,
+                indexingProperties.maxDescriptorSetUpdateAfterBindSampledImages,
+                indexingProperties.maxDescriptorSetUpdateAfterBindSamplers
+            });
+        }
+    }
+    if (enableBindlessTextures && m_bindlessTextureCount == 0)
+    {
+        std::cerr << "bindless textures are not supported, binding textures one per set" << std::endl;
+    }
+
+    // Reading the draw count from a buffer is optional in Vulkan 1.2; without it, culled indirect draws
+    // take the count from the CPU. Only the culling writes a count.
+    if (enableGpuCulling && apiVersion >= VK_API_VERSION_1_2 && getPhysicalDeviceFeatures2 != nullptr)
+    {
+        VkPhysicalDeviceVulkan12Features vulkan12Features {};
+        vulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+        VkPhysicalDeviceFeatures2 features2 {};
+        features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+        features2.pNext = &vulkan12Features;
+        getPhysicalDeviceFeatures2(m_physicalDevice, &features2);
+
+        m_drawIndirectCount = vulkan12Features.drawIndirectCount == VK_TRUE;
+    }
+
+    // VK_EXT_memory_budget tells the allocator how much of each heap the process may use; without it,
+    // the allocator estimates the budgets itself. Querying it needs Vulkan 1.1.
+    uint32_t extensionCount;
+    vkEnumerateDeviceExtensionProperties(m_physicalDevice, nullptr, &extensionCount, nullptr);
+    std::vector<VkExtensionProperties> availableExtensions(extensionCount);
+    vkEnumerateDeviceExtensionProperties(m_physicalDevice, nullptr, &extensionCount, availableExtensions.data());
+
+    std::vector<const char*> deviceExtensions = g_deviceExtensions;
+    bool memoryBudget = apiVersion >= VK_API_VERSION_1_1 && std::any_of(
+        availableExtensions.begin(), availableExtensions.end(), [](const VkExtensionProperties& extension) {
+            return strcmp(extension.extensionName, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME) == 0;
+        }
+    );
+    if (memoryBudget)
+    {
+        deviceExtensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+    }
+
+    // Enable only what bindless textures and indirect draws use. Both need Vulkan 1.2, whose features
+    // are enabled together; its structure must not be chained with the descriptor indexing one.
+    bool bindless = m_bindlessTextureCount > 0;
+    deviceFeatures.shaderSampledImageArrayDynamicIndexing = bindless;
+    VkPhysicalDeviceVulkan12Features enabledVulkan12Features {};
+    enabledVulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+    enabledVulkan12Features.descriptorBindingPartiallyBound = bindless;
+    enabledVulkan12Features.runtimeDescriptorArray = bindless;
+    enabledVulkan12Features.descriptorBindingSampledImageUpdateAfterBind = bindless;
+    enabledVulkan12Features.drawIndirectCount = m_drawIndirectCount;
 
     // Create logical device.
     VkDeviceCreateInfo createInfo {};
     createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+    createInfo.pNext = bindless || m_drawIndirectCount ? &enabledVulkan12Features : nullptr;
     createInfo.pQueueCreateInfos = queueCreateInfoVec.data();
     createInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfoVec.size());
     createInfo.pEnabledFeatures = &deviceFeatures;
     // Enable required extensions.
-    createInfo.enabledExtensionCount = static_cast<uint32_t>(g_deviceExtensions.size());
-    createInfo.ppEnabledExtensionNames = g_deviceExtensions.data();
+    createInfo.enabledExtensionCount = static_cast<uint32_t>(deviceExtensions.size());
+    createInfo.ppEnabledExtensionNames = deviceExtensions.data();
 
     // These two fields are ignored in the latest Vulkan implamentation, they are set to be compatible
     // with older APIs.
@@ -752,9 +1482,61 @@ void HelloTriangleApplication::createLogicalDevice()
         throw std::runtime_error("failed to create logical device");
     }
 
+    // Only loaded once the device has the feature enabled; without the command, the count comes from
+    // the CPU after all.
+    if (m_drawIndirectCount)
+    {
+        m_drawIndexedIndirectCount = reinterpret_cast<PFN_vkCmdDrawIndexedIndirectCount>(
+            vkGetDeviceProcAddr(m_device, "vkCmdDrawIndexedIndirectCount")
+        );
+        m_drawIndirectCount = m_drawIndexedIndirectCount != nullptr;
+    }
+
     // Retrieve graphics queue handle from logical device and queue family.
     vkGetDeviceQueue(m_device, indices.graphicsFamily.value(), 0, &m_graphicsQueue);
     vkGetDeviceQueue(m_device, indices.presentFamily.value(), 0, &m_presentQueue);
+    if (indices.transferFamily.has_value())
+    {
+        vkGetDeviceQueue(m_device, indices.transferFamily.value(), 0, &m_transferQueue);
+    }
+    m_queueFamilyIndices = indices;
+
+    // Buffers and images are sub-allocated from blocks of device memory from here on.
+    m_allocator.init(m_instance, m_physicalDevice, m_device, memoryBudget, DEVICE_MEMORY_BLOCK_SIZE);
+}
+
+void HelloTriangleApplication::createModelBuffers()
+{
+    // Both copies join the open upload batch, which the first frame's submission comes after.
+    StagedModel model {};
+    model.vertices = stageVertexBuffer();
+    model.indices = stageIndexBuffer();
+    model.lods = stageLodBuffer();
+    queueUpload(
+        [this, model](VkCommandBuffer commandBuffer) { recordModelUpload(commandBuffer, model); },
+        { model.vertices, model.indices, model.lods }, nullptr
+    );
+}
+
+void HelloTriangleApplication::createPlaceholderTexture()
+{
+    // A single mid-grey texel, bound until the real texture has streamed in. Its upload goes into the
+    // open batch; the first frame is submitted after it, and its barrier makes the texel visible to
+    // the fragment shader, so nothing waits for it.
+    const uint8_t pixel[4] = { 128, 128, 128, 255 };
+    StagedTexture texture = stageTextureImage(1, 1);
+    memcpy(texture.staging.data, pixel, sizeof(pixel));
+
+    queueUpload(
+        [this, texture](VkCommandBuffer commandBuffer) { recordTextureUpload(commandBuffer, texture); },
+        { texture.staging }, nullptr
+    );
+
+    m_placeholderImage = texture.image;
+    m_placeholderImageMemory = texture.imageMemory;
+    m_placeholderImageView = createImageView(
+        m_placeholderImage, 0, texture.mipLevels, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_ASPECT_COLOR_BIT
+    );
 }
 
 void HelloTriangleApplication::createRenderPass()
@@ -777,7 +1559,8 @@ void HelloTriangleApplication::createRenderPass()
     depthAttachment.format = findDepthFormat();
     depthAttachment.samples = m_msaaSamples;
     depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-    depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    // The culling reduces the depth buffer into its depth pyramid after the render pass.
+    depthAttachment.storeOp = enableGpuCulling ? VK_ATTACHMENT_STORE_OP_STORE : VK_ATTACHMENT_STORE_OP_DONT_CARE;
     depthAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
     depthAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
     depthAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
@@ -836,6 +1619,110 @@ void HelloTriangleApplication::createRenderPass()
     }
 }
 
+void HelloTriangleApplication::createScene(uint32_t objectCount)
+{
+    // Lays the copies of the model out on a square grid in the ground plane, centred on the origin.
+    uint32_t side = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<double>(objectCount))));
+    float center = (side - 1) * .5f;
+
+    m_objectPositions.resize(objectCount);
+    for (uint32_t i = 0; i < objectCount; ++ i)
+    {
+        m_objectPositions[i] = glm::vec3(
+            (i % side - center) * SCENE_OBJECT_SPACING, (i / side - center) * SCENE_OBJECT_SPACING, 0.f
+        );
+    }
+
+    // Instanced draws read the objects' placements from a host visible buffer with a region per frame in
+    // flight, which each frame fills as it records its draw.
+    if (m_instancedDraws)
+    {
+        createBuffer(
+            sizeof(InstanceData) * m_objectPositions.size() * m_MAX_FRAMES_IN_FLIGHT, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+            MemoryUsage::Dynamic, m_instanceBuffer, m_instanceBufferMemory
+        );
+    }
+
+    if (!enableIndirectDraw) { return; }
+
+    // Without culling, every frame writes the commands for its objects' levels of detail into a host
+    // visible region of its own, as instanced draws do their placements. The culling writes them on the
+    // GPU instead, into a single device local region, and counts them.
+    VkDeviceSize commandSize = sizeof(VkDrawIndexedIndirectCommand) * m_objectPositions.size();
+    if (enableGpuCulling)
+    {
+        createBuffer(
+            commandSize, VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+            MemoryUsage::GpuOnly, m_drawCommandBuffer, m_drawCommandBufferMemory
+        );
+        createBuffer(
+            sizeof(uint32_t),
+            VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+            MemoryUsage::GpuOnly, m_drawCountBuffer, m_drawCountBufferMemory
+        );
+    }
+    else
+    {
+        createBuffer(
+            commandSize * m_MAX_FRAMES_IN_FLIGHT, VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, MemoryUsage::Dynamic,
+            m_drawCommandBuffer, m_drawCommandBufferMemory
+        );
+    }
+
+    // Indirect draws read the objects' transforms from a device local storage buffer, filled once
+    // through the staging region.
+    VkDeviceSize bufferSize = sizeof(ObjectData) * m_objectPositions.size();
+    StagingBuffer staging = allocateStagingBuffer(bufferSize, alignof(ObjectData));
+    auto objects = reinterpret_cast<ObjectData*>(staging.data);
+    for (size_t i = 0; i < m_objectPositions.size(); ++ i)
+    {
+        objects[i].transform = glm::translate(glm::mat4(1.f), m_objectPositions[i]);
+    }
+
+    createBuffer(
+        bufferSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, MemoryUsage::GpuOnly,
+        m_objectBuffer, m_objectBufferMemory
+    );
+
+    queueUpload(
+        [this, staging, bufferSize](VkCommandBuffer commandBuffer) {
+            VkBufferCopy copyRegion {};
+            copyRegion.srcOffset = staging.offset;
+            copyRegion.dstOffset = 0;
+            copyRegion.size = bufferSize;
+            vkCmdCopyBuffer(commandBuffer, staging.buffer, m_objectBuffer, 1, &copyRegion);
+
+            VkBufferMemoryBarrier barrier {};
+            barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+            barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+            barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.buffer = m_objectBuffer;
+            barrier.offset = 0;
+            barrier.size = VK_WHOLE_SIZE;
+            VkPipelineStageFlags dstStage = VK_PIPELINE_STAGE_VERTEX_SHADER_BIT |
+                (enableGpuCulling ? VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT : 0);
+            recordUploadBarriers(commandBuffer, dstStage, { barrier }, {});
+        },
+        { staging }, nullptr
+    );
+}
+
+void HelloTriangleApplication::createStagingRegion()
+{
+    // One persistently mapped buffer for the texture uploads, shared out by m_stagingRing. Jobs decode
+    // into it directly instead of into staging buffers of their own that are mapped for each texture.
+    m_stagingRegion.size = TEXTURE_STAGING_SIZE;
+    createBuffer(
+        m_stagingRegion.size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, MemoryUsage::Upload,
+        m_stagingRegion.buffer, m_stagingRegion.allocation
+    );
+
+    m_stagingRegion.data = m_stagingRegion.allocation.data;
+    m_stagingRing.reset(m_stagingRegion.size);
+}
+
 void HelloTriangleApplication::createSyncObjects()
 {
     m_imageAvailableSemaphores.resize(m_MAX_FRAMES_IN_FLIGHT);
@@ -938,66 +1825,9 @@ void HelloTriangleApplication::createSwapchain()
 
 void HelloTriangleApplication::createTextureImage()
 {
-    int textureWidth, textureHeight, textureChannels;
-    stbi_uc* pixels = stbi_load(TEXTURE_DIR.c_str(), &textureWidth, &textureHeight, &textureChannels, STBI_rgb_alpha);
-    VkDeviceSize imageSize = static_cast<uint64_t>(textureWidth) * static_cast<uint64_t>(textureHeight) * 4;
-    m_mipLevels = static_cast<uint32_t>(std::floor(std::log2(std::max(textureWidth, textureHeight)))) + 1;
-
-    if (!pixels)
-    {
-        throw std::runtime_error("failed to load texture image source");
-    }
-
-    // Create a staging buffer for the texture image.
-    VkBuffer stagingBuffer;
-    VkDeviceMemory stagingBufferMemory;
-    createBuffer(
-        imageSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-        stagingBuffer, stagingBufferMemory
-    );
-
-    // Copy the pixel value to the staging buffer.
-    void* data;
-    vkMapMemory(m_device, stagingBufferMemory, 0, imageSize, 0, &data);
-    memcpy(data, pixels, static_cast<size_t>(imageSize));
-    vkUnmapMemory(m_device, stagingBufferMemory);
-
-    // Clean up the original pixel array.
-    stbi_image_free(pixels);
-
-    // Create texture image object on GPU and bind with its allocated memory.
-    createImage(
-        textureWidth, textureHeight, m_mipLevels, VK_SAMPLE_COUNT_1_BIT, VK_FORMAT_R8G8B8A8_SRGB,
-        VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT |
-        VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_textureImage, m_textureImageMemory
-    );
-
-    // Copy the staging buffer to the texture image, which involves two steps:
-    // 1. transition the texture image to VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-    // 2. execute the buffer to image copy operation.
-    transitionImageLayout(
-        m_textureImage, m_mipLevels, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_LAYOUT_UNDEFINED,
-        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL
-    );
-    copyBufferToImage(
-        stagingBuffer, m_textureImage, static_cast<uint32_t>(textureWidth),
-        static_cast<uint32_t>(textureHeight)
-    );
-
-    // Generate mipmaps (and also transition the image layout to VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL.
-    generateMipmaps(m_textureImage, VK_FORMAT_R8G8B8A8_SRGB, textureWidth, textureHeight, m_mipLevels);
-
-    // Clean up staging buffer and its memory.
-    vkDestroyBuffer(m_device, stagingBuffer, nullptr);
-    vkFreeMemory(m_device, stagingBufferMemory, nullptr);
-}
-
-void HelloTriangleApplication::createTextureImageView()
-{
-    m_textureImageView = createImageView(
-        m_textureImage, m_mipLevels, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_ASPECT_COLOR_BIT
-    );
+    // Goes through the same loader as the streamed textures, but waits for it.
+    queueTextureLoad(TEXTURE_DIR, [this](const StagedTexture& texture) { addTexture(texture); });
+    waitForTextureLoads();
 }
 
 void HelloTriangleApplication::createTextureSampler()
@@ -1021,7 +1851,9 @@ void HelloTriangleApplication::createTextureSampler()
     samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
     samplerInfo.mipLodBias = 0.f;
     samplerInfo.minLod = 0.f;
-    samplerInfo.maxLod = static_cast<float>(m_mipLevels);
+    // The image view bounds the mip chain, so the sampler does not depend on the texture and can be
+    // created before the texture has streamed in.
+    samplerInfo.maxLod = VK_LOD_CLAMP_NONE;
 
     if (vkCreateSampler(m_device, &samplerInfo, nullptr, &m_textureSampler) != VK_SUCCESS)
     {
@@ -1029,58 +1861,54 @@ void HelloTriangleApplication::createTextureSampler()
     }
 }
 
-void HelloTriangleApplication::createUniformBuffers()
-{
-    VkDeviceSize bufferSize = sizeof(UniformBufferObject);
-
-    m_uniformBuffers.resize(m_swapchainImages.size());
-    m_uniformBuffersMemory.resize(m_swapchainImages.size());
-
-    // Create a uniform buffer for each swapchain image.
-    for (size_t i = 0; i < m_swapchainImages.size(); ++ i)
-    {
-        createBuffer(
-            bufferSize, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
-            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-            m_uniformBuffers[i], m_uniformBuffersMemory[i]
-        );
-    }
-}
-
-void HelloTriangleApplication::createVertexBuffer()
+void HelloTriangleApplication::createUniformRing()
 {
-    // Create staging buffer (visible on CPU).
-    VkDeviceSize bufferSize = sizeof(m_vertices[0]) * m_vertices.size();
-    VkBuffer stagingBuffer;
-    VkDeviceMemory stagingBufferMemory;
-    createBuffer(
-        bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-        stagingBuffer, stagingBufferMemory
-    );
-
-    // Map the staging buffer memory into CPU accessible memory.
-    void* data;
-    vkMapMemory(m_device, stagingBufferMemory, 0, bufferSize, 0, &data);
-
-    // Copy the vertices to the (mapped) buffer memory.
-    memcpy(data, m_vertices.data(), static_cast<size_t>(bufferSize));
-
-    // Unmap the staging buffer memory.
-    vkUnmapMemory(m_device, stagingBufferMemory);
+    // One persistently mapped uniform buffer for all frames in flight, instead of a buffer per
+    // swapchain image. Blocks within it are bound by dynamic offsets, so they have to start at
+    // multiples of minUniformBufferOffsetAlignment.
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(m_physicalDevice, &properties);
+    VkDeviceSize alignment = properties.limits.minUniformBufferOffsetAlignment;
 
-    // Create destination buffer (not visible on CPU).
+    VkDeviceSize bufferSize = UniformRing::getSize(UNIFORM_FRAME_SIZE, m_MAX_FRAMES_IN_FLIGHT, alignment);
     createBuffer(
-        bufferSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
-        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_vertexBuffer, m_vertexBufferMemory
+        bufferSize, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, MemoryUsage::Dynamic, m_uniformBuffer, m_uniformBufferMemory
     );
+    m_uniformRing.reset(m_uniformBufferMemory.data, UNIFORM_FRAME_SIZE, m_MAX_FRAMES_IN_FLIGHT, alignment);
+}
 
-    // Copy buffer from staging buffer to destination buffer.
-    copyBuffer(stagingBuffer, m_vertexBuffer, bufferSize);
-
-    // Clean up staging buffer and its memory.
-    vkDestroyBuffer(m_device, stagingBuffer, nullptr);
-    vkFreeMemory(m_device, stagingBufferMemory, nullptr);
+void HelloTriangleApplication::destroyScene()
+{
+    // Destroys what createScene() has created, with the device idle. The descriptor sets that refer to
+    // the scene's buffers are rewritten before their frames draw again.
+    vkDestroyBuffer(m_device, m_objectBuffer, nullptr);
+    m_allocator.free(m_objectBufferMemory);
+    m_objectBuffer = VK_NULL_HANDLE;
+    m_objectBufferMemory = DeviceAllocation {};
+
+    vkDestroyBuffer(m_device, m_instanceBuffer, nullptr);
+    m_allocator.free(m_instanceBufferMemory);
+    m_instanceBuffer = VK_NULL_HANDLE;
+    m_instanceBufferMemory = DeviceAllocation {};
+
+    vkDestroyBuffer(m_device, m_drawCommandBuffer, nullptr);
+    m_allocator.free(m_drawCommandBufferMemory);
+    m_drawCommandBuffer = VK_NULL_HANDLE;
+    m_drawCommandBufferMemory = DeviceAllocation {};
+
+    vkDestroyBuffer(m_device, m_drawCountBuffer, nullptr);
+    m_allocator.free(m_drawCountBufferMemory);
+    m_drawCountBuffer = VK_NULL_HANDLE;
+    m_drawCountBufferMemory = DeviceAllocation {};
+
+    // Counters still to be read back were culled from the old objects and are dropped.
+    m_objectPositions.clear();
+    m_descriptorSetsDirty.assign(m_descriptorSetsDirty.size(), true);
+    for (auto& culling : m_frameCulling)
+    {
+        culling.descriptorSetDirty = true;
+        culling.pending = false;
+    }
 }
 
 void HelloTriangleApplication::destroySwapchain()
@@ -1088,31 +1916,32 @@ void HelloTriangleApplication::destroySwapchain()
     // Destroy color image, image view and memory.
     vkDestroyImageView(m_device, m_colorImageView, nullptr);
     vkDestroyImage(m_device, m_colorImage, nullptr);
-    vkFreeMemory(m_device, m_colorImageMemory, nullptr);
+    m_allocator.free(m_colorImageMemory);
 
     // Destroy depth image, image view and memory.
     vkDestroyImageView(m_device, m_depthImageView, nullptr);
     vkDestroyImage(m_device, m_depthImage, nullptr);
-    vkFreeMemory(m_device, m_depthImageMemory, nullptr);
+    m_allocator.free(m_depthImageMemory);
 
-    // Destroy framebuffers.
-    for (auto framebuffer : m_swapchainFramebuffers)
+    // Destroy depth pyramid and the descriptor pool of its reductions.
+    vkDestroyDescriptorPool(m_device, m_depthReduceDescriptorPool, nullptr);
+    for (auto imageView : m_depthPyramidLevelViews)
     {
-        vkDestroyFramebuffer(m_device, framebuffer, nullptr);
+        vkDestroyImageView(m_device, imageView, nullptr);
     }
+    vkDestroyImageView(m_device, m_depthPyramidView, nullptr);
+    vkDestroyImage(m_device, m_depthPyramid, nullptr);
+    m_allocator.free(m_depthPyramidMemory);
 
-    // Free command buffers.
-    vkFreeCommandBuffers(m_device, m_commandPool, static_cast<uint32_t>(m_commandBuffers.size()), m_commandBuffers.data());
-
-    // Destroy uniform buffers.
-    for (size_t i = 0; i < m_swapchainImages.size(); ++ i)
+    // Destroy framebuffers.
+    for (auto framebuffer : m_swapchainFramebuffers)
     {
-        vkDestroyBuffer(m_device, m_uniformBuffers[i], nullptr);
-        vkFreeMemory(m_device, m_uniformBuffersMemory[i], nullptr);
+        vkDestroyFramebuffer(m_device, framebuffer, nullptr);
     }
 
-    // Destroy descriptor pool.
+    // Destroy descriptor pools.
     vkDestroyDescriptorPool(m_device, m_descriptorPool, nullptr);
+    vkDestroyDescriptorPool(m_device, m_bindlessDescriptorPool, nullptr);
 
     // Destroy pipeline.
     vkDestroyPipeline(m_device, m_graphicsPipeline, nullptr);
@@ -1133,11 +1962,35 @@ void HelloTriangleApplication::destroySwapchain()
     vkDestroySwapchainKHR(m_device, m_swapchain, nullptr);
 }
 
+void HelloTriangleApplication::destroyTexture(const Texture& texture)
+{
+    // A retired view may be all there is; null handles are ignored.
+    vkDestroyImageView(m_device, texture.view, nullptr);
+    vkDestroyImage(m_device, texture.image, nullptr);
+    m_allocator.free(texture.imageMemory);
+}
+
 void HelloTriangleApplication::drawFrame()
 {
     // Wait for the frame to be finished.
     vkWaitForFences(m_device, 1, &m_cmdBufferExecFences[m_currentFrame], VK_TRUE, UINT64_MAX);
 
+    // Its timestamps are available now.
+    FrameCommands& frame = m_frameCommands[m_currentFrame];
+    if (frame.timestamped)
+    {
+        std::array<uint64_t, 2> timestamps {};
+        if (vkGetQueryPoolResults(
+                m_device, m_timestampQueryPool, 2 * static_cast<uint32_t>(m_currentFrame), 2, sizeof(timestamps),
+                timestamps.data(), sizeof(uint64_t), VK_QUERY_RESULT_64_BIT
+            ) == VK_SUCCESS)
+        {
+            m_gpuSeconds += ((timestamps[1] - timestamps[0]) & m_timestampMask) * 1e-9 * m_timestampPeriod;
+            ++ m_gpuFrameCount;
+        }
+        frame.timestamped = false;
+    }
+
     // Acquire an image from the swapchain.
     uint32_t imageIndex;
     VkResult result = vkAcquireNextImageKHR(
@@ -1165,8 +2018,34 @@ void HelloTriangleApplication::drawFrame()
     // Mark the image as being in use by this frame.
     m_imageUsageFences[imageIndex] = m_cmdBufferExecFences[m_currentFrame];
 
-    // Update uniform buffer.
-    updateUniformBuffer(imageIndex);
+    // Swap in streamed assets at the frame boundary. The frame's previous submission has finished, so
+    // its descriptor set can be pointed at a newly streamed texture without waiting for the device.
+    ++ m_frameCount;
+    updateAssetStreaming();
+    if (m_descriptorSetsDirty[m_currentFrame])
+    {
+        updateDescriptorSet(m_currentFrame);
+    }
+
+    // Once every descriptor set refers to the current texture views, no frame uses the ones they have
+    // replaced any more.
+    if (!m_retiredTextures.empty() &&
+        std::find(m_descriptorSetsDirty.begin(), m_descriptorSetsDirty.end(), true) == m_descriptorSetsDirty.end())
+    {
+        for (const auto& texture : m_retiredTextures)
+        {
+            destroyTexture(texture);
+        }
+        m_retiredTextures.clear();
+    }
+
+    // Update uniform buffer, from which the levels of detail are selected, then record the frame. The frame's
+    // fence has signalled, so its command buffers and its region of the uniform ring are free again.
+    auto recordingStart = std::chrono::high_resolution_clock::now();
+    m_uniformRing.beginFrame(static_cast<uint32_t>(m_currentFrame));
+    UniformBufferObject ubo = updateUniformBuffer();
+    recordCommandBuffer(imageIndex, ubo);
+    m_recordingSeconds += std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - recordingStart).count();
 
     // Prepare to submit command buffer to the queue.
     VkSubmitInfo submitInfo {};
@@ -1178,7 +2057,7 @@ void HelloTriangleApplication::drawFrame()
     submitInfo.pWaitSemaphores = waitSemaphores;
     submitInfo.pWaitDstStageMask = waitStages;
     submitInfo.commandBufferCount = 1;
-    submitInfo.pCommandBuffers = &m_commandBuffers[imageIndex];
+    submitInfo.pCommandBuffers = &m_frameCommands[m_currentFrame].commandBuffer;
 
     VkSemaphore signalSemaphores[] = { m_renderFinishedSemaphores[m_currentFrame] };
     submitInfo.signalSemaphoreCount = 1;
@@ -1220,24 +2099,131 @@ void HelloTriangleApplication::drawFrame()
         throw std::runtime_error("failed to present image from swapchain");
     }
 
+    if (!m_firstFramePresented)
+    {
+        m_firstFramePresented = true;
+        std::cout << "first frame presented after " << std::chrono::duration<double, std::milli>(
+            std::chrono::high_resolution_clock::now() - m_startTime).count() << " ms" << std::endl;
+        std::cout << "startup uploads: " << m_uploadStats.uploadCount << " uploads in "
+                  << m_uploadStats.submitCount << " submissions, " << m_uploadStats.waitCount << " waits"
+                  << std::endl;
+    }
+
     // Advance current frame.
     m_currentFrame = (m_currentFrame + 1) % m_MAX_FRAMES_IN_FLIGHT;
 }
 
-void HelloTriangleApplication::generateMipmaps(VkImage image, VkFormat imageFormat, int32_t textureWidth,
-    int32_t textureHeight, uint32_t mipLevels)
+void HelloTriangleApplication::evictTextures(VkDeviceSize budget, uint64_t usedBefore, TextureStreamingBatch& batch)
+{
+    // Shrinks the least recently drawn textures to their mip tail until all textures fit into budget,
+    // sparing those drawn since usedBefore and those with an upload in flight.
+    while (m_textureMemory > budget)
+    {
+        size_t victim = m_textures.size();
+        for (size_t i = 0; i < m_textures.size(); ++ i)
+        {
+            const Texture& texture = m_textures[i];
+            if (!texture.source || texture.streaming || texture.firstLevel == texture.tailLevel ||
+                texture.lastUsedFrame >= usedBefore)
+            {
+                continue;
+            }
+            if (victim == m_textures.size() || texture.lastUsedFrame < m_textures[victim].lastUsedFrame)
+            {
+                victim = i;
+            }
+        }
+
+        if (victim == m_textures.size() || !reallocateTexture(victim, m_textures[victim].tailLevel, batch))
+        {
+            return;
+        }
+    }
+}
+
+void HelloTriangleApplication::finishAssetStreaming()
+{
+    // Texture jobs may be waiting for staging space, which only retiring their predecessors frees, so
+    // they are finished by uploading them as usual. Then every upload still in flight is retired.
+    waitForTextureLoads();
+    flushUploads();
+    while (!m_uploads.empty())
+    {
+        retireUploads(true);
+    }
+
+    // The model job may still be running; wait for it and release what it staged. The model's device
+    // buffers are members and are destroyed with the others.
+    if (m_modelFuture.valid())
+    {
+        StagedModel model = m_modelFuture.get();
+        releaseStagingBuffer(model.vertices);
+        releaseStagingBuffer(model.indices);
+        releaseStagingBuffer(model.lods);
+    }
+}
+
+void HelloTriangleApplication::flushUploads()
+{
+    // Submits the open batch, if anything has been recorded into it. Instead of waiting for the queue
+    // to go idle, its fence is polled once per frame by retireUploads(), which also submits the
+    // acquiring half of a batch on the transfer queue.
+    UploadBatch& batch = m_openUpload;
+    if (batch.commandBuffer == VK_NULL_HANDLE) { return; }
+
+    vkEndCommandBuffer(batch.commandBuffer);
+    if (batch.graphicsCommandBuffer != batch.commandBuffer)
+    {
+        vkEndCommandBuffer(batch.graphicsCommandBuffer);
+
+        VkSemaphoreCreateInfo semaphoreInfo {};
+        semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
+        if (vkCreateSemaphore(m_device, &semaphoreInfo, nullptr, &batch.semaphore) != VK_SUCCESS)
+        {
+            throw std::runtime_error("failed to create upload semaphore");
+        }
+    }
+
+    VkFenceCreateInfo fenceInfo {};
+    fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+    if (vkCreateFence(m_device, &fenceInfo, nullptr, &batch.fence) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to create upload fence");
+    }
+
+    VkSubmitInfo submitInfo {};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &batch.commandBuffer;
+    submitInfo.signalSemaphoreCount = batch.semaphore != VK_NULL_HANDLE ? 1 : 0;
+    submitInfo.pSignalSemaphores = &batch.semaphore;
+
+    VkQueue queue = batch.semaphore != VK_NULL_HANDLE ? m_transferQueue : m_graphicsQueue;
+    if (vkQueueSubmit(queue, 1, &submitInfo, batch.fence) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to submit uploads");
+    }
+
+    ++ m_uploadStats.submitCount;
+    m_uploads.push_back(std::move(batch));
+    m_openUpload = UploadBatch {};
+}
+
+void HelloTriangleApplication::generateMipmaps(VkCommandBuffer commandBuffer, VkImage image, VkFormat imageFormat,
+    int32_t textureWidth, int32_t textureHeight, uint32_t mipLevels)
 {
     // Check if image format supports linear blitting.
     VkFormatProperties formatProps;
     vkGetPhysicalDeviceFormatProperties(m_physicalDevice, imageFormat, &formatProps);
 
+    // loadTexture() builds the chain on the CPU for such formats, so this is not expected to fail.
     if (!(formatProps.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT))
     {
         throw std::runtime_error("texture image format doesn't support linear blitting");
     }
 
-    VkCommandBuffer commandBuffer = beginSingleTimeCommands();
-
     VkImageMemoryBarrier barrier {};
     barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
     barrier.image = image;
@@ -1250,7 +2236,7 @@ void HelloTriangleApplication::generateMipmaps(VkImage image, VkFormat imageForm
 
     int32_t mipWidth = textureWidth;
     int32_t mipHeight = textureHeight;
-    for (uint32_t i = 1; i < m_mipLevels; ++ i)
+    for (uint32_t i = 1; i < mipLevels; ++ i)
     {
         barrier.subresourceRange.baseMipLevel = i - 1;
         barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
@@ -1308,8 +2294,6 @@ void HelloTriangleApplication::generateMipmaps(VkImage image, VkFormat imageForm
         commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
         0, 0, nullptr, 0, nullptr, 1, &barrier
     );
-
-    endSingleTimeCommands(commandBuffer);
 }
 
 void HelloTriangleApplication::initWindow()
@@ -1341,64 +2325,170 @@ void HelloTriangleApplication::initVulkan()
     createDescriptorSetlayout();
     createGraphicsPipeline();
     createCommandPools();
+    createStagingRegion();
     createColorResources();
     createDepthResources();
+    if (enableGpuCulling)
+    {
+        createCullingResources();
+        createDepthPyramid();
+    }
     createFramebuffers();
-    createTextureImage();
-    createTextureImageView();
+    createScene(SCENE_OBJECT_COUNT);
+    if (enableAssetStreaming)
+    {
+        createPlaceholderTexture();
+    }
+    else
+    {
+        // The model's copies are recorded first, so that they go into the submission the texture
+        // loader waits for.
+        loadModel();
+        createModelBuffers();
+        createTextureImage();
+        m_modelReady = true;
+    }
     createTextureSampler();
-    loadModel();
-    createVertexBuffer();
-    createIndexBuffer();
-    createUniformBuffers();
+    createUniformRing();
     createDescriptorPool();
     createDescriptorSets();
     createCommandBuffers();
     createSyncObjects();
-}
-
-void HelloTriangleApplication::loadModel()
-{
-    tinyobj::attrib_t attrib;
-    std::vector<tinyobj::shape_t> shapes;
-    std::vector < tinyobj::material_t> materials;
-    std::string warn, err;
-
-    if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, MODEL_DIR.c_str()))
+    if (enableAssetStreaming)
     {
-        throw std::runtime_error(warn + err);
+        startAssetStreaming();
     }
 
-    for (const auto& shape : shapes)
+    // Submit whatever the initialisation has recorded in one go. The first frame uses it right away,
+    // so with a transfer queue, wait until it has been handed over to the graphics queue.
+    flushUploads();
+    if (m_transferQueue != VK_NULL_HANDLE)
     {
-        std::unordered_map<Vertex, uint32_t> uniqueVertices {};
-
-        for (const auto& index : shape.mesh.indices)
+        while (!m_uploads.empty())
         {
-            Vertex vertex {};
-
-            vertex.pos = {
-                attrib.vertices[3 * index.vertex_index + 0],
-                attrib.vertices[3 * index.vertex_index + 1],
-                attrib.vertices[3 * index.vertex_index + 2]
-            };
-            vertex.textureCoord = {
-                attrib.texcoords[2 * index.texcoord_index + 0],
-                1.f - attrib.texcoords[2 * index.texcoord_index + 1]
-            };
-
-            if (uniqueVertices.count(vertex) == 0)
-            {
-                uniqueVertices[vertex] = static_cast<uint32_t>(m_vertices.size());
-                m_vertices.push_back(vertex);
-            }
-
-            m_indices.push_back(uniqueVertices[vertex]);
+            retireUploads(true);
         }
     }
 }
 
-void HelloTriangleApplication::mainLoop()
+void HelloTriangleApplication::loadModel()
+{
+    // Try the binary mesh cache first; on a hit the vertex and index blobs are mapped straight
+    // from disk and nothing needs to be parsed or deduplicated.
+    uint64_t sourceHash = MeshCache::hashSourceFile(MODEL_DIR);
+    sourceHash = MeshCache::hashCombine(sourceHash, enableMeshOptimization);
+    sourceHash = MeshCache::hashCombine(sourceHash, enableMeshlets);
+    sourceHash = MeshCache::hashCombine(sourceHash, enableLods ? MAX_LOD_COUNT : 1);
+    if (m_meshCache.open(MODEL_CACHE_DIR, sourceHash) && m_meshCache.vertexStride() == sizeof(Vertex) &&
+        (m_meshCache.meshletCount() == 0 || m_meshCache.meshletStride() == sizeof(Meshlet)) &&
+        m_meshCache.lodCount() > 0 && m_meshCache.lodStride() == sizeof(MeshLod))
+    {
+        m_indexCount = m_meshCache.indexCount();
+        setBoundingSphere(m_meshCache.boundsMin(), m_meshCache.boundsMax());
+
+        // Meshlets and levels of detail are small and read by the CPU, so they are copied out
+        // rather than used mapped.
+        auto meshlets = static_cast<const Meshlet*>(m_meshCache.meshletData());
+        m_meshlets.assign(meshlets, meshlets + m_meshCache.meshletCount());
+        m_meshletVertices.assign(m_meshCache.meshletVertexData(),
+            m_meshCache.meshletVertexData() + m_meshCache.meshletVertexCount());
+        m_meshletTriangles.assign(m_meshCache.meshletTriangleData(),
+            m_meshCache.meshletTriangleData() + m_meshCache.meshletTriangleCount());
+        auto lods = static_cast<const MeshLod*>(m_meshCache.lodData());
+        m_lods.assign(lods, lods + m_meshCache.lodCount());
+        return;
+    }
+    m_meshCache.close();
+
+    // Parse and deduplicate the model on all worker threads.
+    ObjLoader::load(MODEL_DIR, m_threadPool, m_threadPool.threadCount(), m_vertices, m_indices);
+
+    glm::vec3 boundsMin(std::numeric_limits<float>::max());
+    glm::vec3 boundsMax(std::numeric_limits<float>::lowest());
+    for (const auto& vertex : m_vertices)
+    {
+        boundsMin = glm::min(boundsMin, vertex.pos);
+        boundsMax = glm::max(boundsMax, vertex.pos);
+    }
+    setBoundingSphere(boundsMin, boundsMax);
+
+    // Triangles come out in file order, which is rarely cache friendly.
+    VertexCacheStats before {};
+    if (enableMeshOptimization)
+    {
+        before = MeshOptimizer::analyzeVertexCache(m_indices.data(), m_indices.size(), m_vertices.size());
+        MeshOptimizer::optimizeVertexCache(m_indices.data(), m_indices.size(), m_vertices.size());
+        MeshOptimizer::optimizeOverdraw(m_indices.data(), m_indices.size(), m_vertices);
+    }
+
+    // Append the coarser levels of detail behind LOD 0 in the same index buffer. The error limit is
+    // relative to the model size, so that it means the same for every model.
+    if (enableLods)
+    {
+        float errorLimit = LOD_ERROR_LIMIT * glm::length(boundsMax - boundsMin);
+        MeshSimplifier::buildLodChain(m_vertices, m_indices, m_lods, MAX_LOD_COUNT, errorLimit);
+    }
+    else
+    {
+        m_lods.assign(1, MeshLod { 0, static_cast<uint32_t>(m_indices.size()), 0.f, 0.f });
+    }
+
+    if (enableMeshOptimization)
+    {
+        for (size_t i = 1; i < m_lods.size(); ++ i)
+        {
+            MeshOptimizer::optimizeVertexCache(&m_indices[m_lods[i].firstIndex], m_lods[i].indexCount, m_vertices.size());
+        }
+        // LOD 0 comes first and uses every vertex, so the fetch order follows LOD 0.
+        MeshOptimizer::optimizeVertexFetch(m_vertices, m_indices);
+        VertexCacheStats after = MeshOptimizer::analyzeVertexCache(m_indices.data(), m_lods[0].indexCount, m_vertices.size());
+
+        std::cout << "mesh optimization: ACMR " << before.acmr << " -> " << after.acmr
+                  << ", ATVR " << before.atvr << " -> " << after.atvr << std::endl;
+    }
+
+    for (size_t i = 0; i < m_lods.size(); ++ i)
+    {
+        std::cout << "LOD " << i << ": " << m_lods[i].indexCount / 3 << " triangles, error " << m_lods[i].error << std::endl;
+    }
+
+    m_indexCount = static_cast<uint32_t>(m_indices.size());
+
+    // Meshlets are cut from the final LOD 0 order so that they inherit its locality.
+    if (enableMeshlets)
+    {
+        MeshletBuilder::build(m_vertices, m_indices.data(), m_lods[0].indexCount, m_meshlets, m_meshletVertices,
+            m_meshletTriangles);
+    }
+
+    // Write the deduplicated mesh out so that the next start-up can skip all of the above. A failed
+    // write is not fatal, the model is simply parsed again next time.
+    MeshCacheContents contents {};
+    contents.vertexData = m_vertices.data();
+    contents.vertexStride = sizeof(Vertex);
+    contents.vertexCount = static_cast<uint32_t>(m_vertices.size());
+    contents.indexData = m_indices.data();
+    contents.indexCount = m_indexCount;
+    contents.boundsMin = boundsMin;
+    contents.boundsMax = boundsMax;
+    contents.meshletData = m_meshlets.data();
+    contents.meshletStride = sizeof(Meshlet);
+    contents.meshletCount = static_cast<uint32_t>(m_meshlets.size());
+    contents.meshletVertexData = m_meshletVertices.data();
+    contents.meshletVertexCount = static_cast<uint32_t>(m_meshletVertices.size());
+    contents.meshletTriangleData = m_meshletTriangles.data();
+    contents.meshletTriangleCount = static_cast<uint32_t>(m_meshletTriangles.size());
+    contents.lodData = m_lods.data();
+    contents.lodStride = sizeof(MeshLod);
+    contents.lodCount = static_cast<uint32_t>(m_lods.size());
+
+    if (!MeshCache::write(MODEL_CACHE_DIR, sourceHash, contents))
+    {
+        std::cerr << "failed to write mesh cache " << MODEL_CACHE_DIR << std::endl;
+    }
+}
+
+void HelloTriangleApplication::mainLoop()
 {
     while (!glfwWindowShouldClose(m_window))
     {
@@ -1410,6 +2500,235 @@ void HelloTriangleApplication::mainLoop()
     vkDeviceWaitIdle(m_device);
 }
 
+void HelloTriangleApplication::queueTextureLoad(const std::string& filename,
+    std::function<void(const StagedTexture&)> onUploaded)
+{
+    // Loads queued while the loader is idle start a new report.
+    if (m_textureLoads.empty() && m_textureBatchesInFlight == 0)
+    {
+        std::lock_guard<std::mutex> lock(m_textureLoadStatsMutex);
+        m_textureLoadStats = TextureLoadStats {};
+        m_textureLoadStats.startTime = std::chrono::high_resolution_clock::now();
+    }
+
+    TextureLoad load {};
+    load.filename = filename;
+    load.onUploaded = std::move(onUploaded);
+    load.future = m_textureThreadPool.submit([this, filename]() {
+        StagedTexture texture = loadTexture(filename);
+
+        std::lock_guard<std::mutex> lock(m_textureLoadStatsMutex);
+        ++ m_textureLoadStats.textureCount;
+        m_textureLoadStats.texelCount += static_cast<uint64_t>(texture.width) * texture.height;
+        m_textureLoadStats.stagedBytes += texture.staging.size;
+        m_textureLoadStats.lastDecodeTime = std::chrono::high_resolution_clock::now();
+        return texture;
+    });
+    m_textureLoads.push_back(std::move(load));
+}
+
+void HelloTriangleApplication::queueUpload(const std::function<void(VkCommandBuffer)>& record,
+    std::vector<StagingBuffer> stagingBuffers, std::function<void()> swapIn)
+{
+    // Records into the open batch, beginning it first if needed. The staging buffers are released and
+    // swapIn() is called once the batch has been submitted and has completed. record() only records
+    // transfers into the command buffer it gets, which may belong to the transfer queue; anything
+    // else goes through recordUploadBarriers() or into the batch's graphics command buffer.
+    UploadBatch& batch = m_openUpload;
+    if (batch.commandBuffer == VK_NULL_HANDLE)
+    {
+        auto beginCommandBuffer = [this](VkCommandPool commandPool) {
+            VkCommandBufferAllocateInfo allocInfo {};
+            allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+            allocInfo.commandPool = commandPool;
+            allocInfo.commandBufferCount = 1;
+
+            VkCommandBuffer commandBuffer;
+            if (vkAllocateCommandBuffers(m_device, &allocInfo, &commandBuffer) != VK_SUCCESS)
+            {
+                throw std::runtime_error("failed to allocate upload command buffer");
+            }
+
+            VkCommandBufferBeginInfo beginInfo {};
+            beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+            beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+            vkBeginCommandBuffer(commandBuffer, &beginInfo);
+            return commandBuffer;
+        };
+
+        batch.graphicsCommandBuffer = beginCommandBuffer(m_commandPoolTransient);
+        batch.commandBuffer = m_transferQueue != VK_NULL_HANDLE ?
+            beginCommandBuffer(m_commandPoolTransfer) : batch.graphicsCommandBuffer;
+    }
+
+    record(batch.commandBuffer);
+    batch.stagingBuffers.insert(batch.stagingBuffers.end(), stagingBuffers.begin(), stagingBuffers.end());
+    if (swapIn)
+    {
+        batch.swapIns.push_back(std::move(swapIn));
+    }
+    ++ m_uploadStats.uploadCount;
+}
+
+void HelloTriangleApplication::recordCommandBuffer(uint32_t imageIndex, const UniformBufferObject& ubo)
+{
+    /***
+     * The frame's command buffers were last submitted with its fence, which has signalled, so their
+     * pools are reset as a whole. With enough objects, the draws are split into one chunk per
+     * recording thread, each recorded into the secondary command buffer of its thread's pool, and the
+     * primary command buffer just executes them inside the render pass. Indirect and instanced draws
+     * take the same few commands for any number of objects and are always recorded inline; with GPU
+     * culling, the compute passes that write the indirect commands go before and after the render pass.
+     ***/
+    FrameCommands& frame = m_frameCommands[m_currentFrame];
+    vkResetCommandPool(m_device, frame.commandPool, 0);
+
+    // Until the model has streamed in, the frame is just the cleared render pass. Every draw reads the
+    // same uniform block, which goes into the ring once per frame.
+    size_t objectCount = m_modelReady ? m_objectPositions.size() : 0;
+    uint32_t uniformOffset = m_uniformRing.push(&ubo, sizeof(ubo));
+    size_t chunkCount = 0;
+    if (enableParallelRecording && !enableIndirectDraw && !m_instancedDraws)
+    {
+        chunkCount = std::min<size_t>(
+            std::min(frame.secondaryCommandBuffers.size(), m_recordingThreadLimit),
+            (objectCount + MIN_DRAWS_PER_RECORDING_THREAD - 1) / MIN_DRAWS_PER_RECORDING_THREAD
+        );
+    }
+    bool secondary = chunkCount > 1;
+
+    VkCommandBufferBeginInfo beginInfo {};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    beginInfo.pInheritanceInfo = nullptr;
+
+    // Start command buffer recording.
+    if (vkBeginCommandBuffer(frame.commandBuffer, &beginInfo) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to begin recording command buffer");
+    }
+
+    // Bracket the frame's commands with timestamps, which drawFrame() reads once its fence has signalled.
+    uint32_t firstQuery = 2 * static_cast<uint32_t>(m_currentFrame);
+    if (m_timestampQueryPool != VK_NULL_HANDLE)
+    {
+        vkCmdResetQueryPool(frame.commandBuffer, m_timestampQueryPool, firstQuery, 2);
+        vkCmdWriteTimestamp(frame.commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, m_timestampQueryPool, firstQuery);
+    }
+
+    // Cull the objects into the draw commands, which cannot be done inside the render pass.
+    if (enableGpuCulling && objectCount > 0)
+    {
+        recordCulling(frame.commandBuffer, ubo);
+    }
+
+    // Begin render pass.
+    std::array<VkClearValue, 2> clearValues {};
+    clearValues[0].color = { 0.0f, 0.0f, 0.0f, 1.0f };
+    clearValues[1].depthStencil = { 1.0f, 0 };
+
+    VkRenderPassBeginInfo renderPassInfo {};
+    renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+    renderPassInfo.renderPass = m_renderPass;
+    renderPassInfo.framebuffer = m_swapchainFramebuffers[imageIndex];
+    renderPassInfo.renderArea.offset = { 0, 0 };
+    renderPassInfo.renderArea.extent = m_swapchainExtent;
+    renderPassInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
+    renderPassInfo.pClearValues = clearValues.data();
+
+    vkCmdBeginRenderPass(
+        frame.commandBuffer, &renderPassInfo,
+        secondary ? VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS : VK_SUBPASS_CONTENTS_INLINE
+    );
+
+    // The model samples the first texture, which keeps it from being evicted.
+    if (objectCount > 0 && !m_textures.empty())
+    {
+        m_textures[0].lastUsedFrame = m_frameCount;
+    }
+
+    if (enableIndirectDraw)
+    {
+        if (objectCount > 0)
+        {
+            recordIndirectDraws(frame.commandBuffer, ubo, uniformOffset);
+        }
+    }
+    else if (m_instancedDraws)
+    {
+        if (objectCount > 0)
+        {
+            recordInstancedDraws(frame.commandBuffer, ubo, uniformOffset);
+        }
+    }
+    else if (!secondary)
+    {
+        recordDraws(frame.commandBuffer, ubo, uniformOffset, 0, objectCount);
+    }
+    else
+    {
+        // The secondary command buffers continue the render pass, on the frame's framebuffer.
+        VkCommandBufferInheritanceInfo inheritanceInfo {};
+        inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+        inheritanceInfo.renderPass = m_renderPass;
+        inheritanceInfo.subpass = 0;
+        inheritanceInfo.framebuffer = m_swapchainFramebuffers[imageIndex];
+
+        m_recordingThreadPool.parallelFor(chunkCount, [&](size_t chunk) {
+            VkCommandBuffer commandBuffer = frame.secondaryCommandBuffers[chunk];
+            vkResetCommandPool(m_device, frame.secondaryCommandPools[chunk], 0);
+
+            VkCommandBufferBeginInfo secondaryBeginInfo {};
+            secondaryBeginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+            secondaryBeginInfo.flags = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT |
+                                       VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+            secondaryBeginInfo.pInheritanceInfo = &inheritanceInfo;
+
+            if (vkBeginCommandBuffer(commandBuffer, &secondaryBeginInfo) != VK_SUCCESS)
+            {
+                throw std::runtime_error("failed to begin recording secondary command buffer");
+            }
+
+            size_t firstObject = objectCount * chunk / chunkCount;
+            size_t lastObject = objectCount * (chunk + 1) / chunkCount;
+            recordDraws(commandBuffer, ubo, uniformOffset, firstObject, lastObject - firstObject);
+
+            if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS)
+            {
+                throw std::runtime_error("failed to record secondary command buffer");
+            }
+        });
+
+        vkCmdExecuteCommands(
+            frame.commandBuffer, static_cast<uint32_t>(chunkCount), frame.secondaryCommandBuffers.data()
+        );
+    }
+
+    // End render pass.
+    vkCmdEndRenderPass(frame.commandBuffer);
+
+    // Build the depth pyramid the next frame culls against.
+    if (enableGpuCulling && objectCount > 0)
+    {
+        recordDepthPyramid(frame.commandBuffer);
+    }
+
+    if (m_timestampQueryPool != VK_NULL_HANDLE)
+    {
+        vkCmdWriteTimestamp(
+            frame.commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, m_timestampQueryPool, firstQuery + 1
+        );
+        frame.timestamped = true;
+    }
+
+    // Finish command buffer recording.
+    if (vkEndCommandBuffer(frame.commandBuffer) != VK_SUCCESS)
+    {
+        throw std::runtime_error("failed to record command buffer");
+    }
+}
+
 void HelloTriangleApplication::recreateSwapchain()
 {
     // Pause swapchain recreation when window is minimised.
@@ -1434,11 +2753,88 @@ void HelloTriangleApplication::recreateSwapchain()
     createGraphicsPipeline();
     createColorResources();
     createDepthResources();
+    if (enableGpuCulling)
+    {
+        createDepthPyramid();
+    }
     createFramebuffers();
-    createUniformBuffers();
     createDescriptorPool();
     createDescriptorSets();
-    createCommandBuffers();
+}
+
+void HelloTriangleApplication::reportTextureLoads()
+{
+    std::lock_guard<std::mutex> lock(m_textureLoadStatsMutex);
+    const TextureLoadStats& stats = m_textureLoadStats;
+
+    // Decoding is measured from queueing the first texture to the last job finishing; uploading from
+    // submitting each batch to seeing its fence signalled, which the per-frame polling rounds up.
+    double decodeSeconds = std::chrono::duration<double>(stats.lastDecodeTime - stats.startTime).count();
+    double stagedMegabytes = stats.stagedBytes / (1024.0 * 1024.0);
+    std::cout << "texture loading: " << stats.textureCount << " textures on " << m_textureThreadPool.threadCount()
+              << " threads | decode " << stats.texelCount / 1e6 << " MPix in " << decodeSeconds * 1000.0 << " ms ("
+              << stats.texelCount / 1e6 / decodeSeconds << " MPix/s) | upload " << stagedMegabytes << " MB in "
+              << stats.batchCount << " batches, " << stats.uploadSeconds * 1000.0 << " ms ("
+              << stagedMegabytes / stats.uploadSeconds << " MB/s)" << std::endl;
+}
+
+void HelloTriangleApplication::retireUploads(bool wait)
+{
+    // Release the staging memory of every batch whose fence has signalled and swap its resources in.
+    // Batches complete in submission order, so waiting for the oldest one is enough to make progress.
+    for (auto it = m_uploads.begin(); it != m_uploads.end();)
+    {
+        if (wait && it == m_uploads.begin())
+        {
+            vkWaitForFences(m_device, 1, &it->fence, VK_TRUE, UINT64_MAX);
+            ++ m_uploadStats.waitCount;
+        }
+        if (vkGetFenceStatus(m_device, it->fence) != VK_SUCCESS)
+        {
+            ++ it;
+            continue;
+        }
+
+        // The transfer queue has finished, so the acquiring half no longer holds up the graphics queue.
+        // The batch is looked at again, for its fence now signals once the acquire has completed.
+        if (it->semaphore != VK_NULL_HANDLE && !it->acquired)
+        {
+            VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+            VkSubmitInfo submitInfo {};
+            submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+            submitInfo.waitSemaphoreCount = 1;
+            submitInfo.pWaitSemaphores = &it->semaphore;
+            submitInfo.pWaitDstStageMask = &waitStage;
+            submitInfo.commandBufferCount = 1;
+            submitInfo.pCommandBuffers = &it->graphicsCommandBuffer;
+
+            vkResetFences(m_device, 1, &it->fence);
+            if (vkQueueSubmit(m_graphicsQueue, 1, &submitInfo, it->fence) != VK_SUCCESS)
+            {
+                throw std::runtime_error("failed to submit upload acquire");
+            }
+
+            it->acquired = true;
+            continue;
+        }
+
+        for (const auto& swapIn : it->swapIns)
+        {
+            swapIn();
+        }
+        for (const auto& staging : it->stagingBuffers)
+        {
+            releaseStagingBuffer(staging);
+        }
+        vkFreeCommandBuffers(m_device, m_commandPoolTransient, 1, &it->graphicsCommandBuffer);
+        if (it->semaphore != VK_NULL_HANDLE)
+        {
+            vkFreeCommandBuffers(m_device, m_commandPoolTransfer, 1, &it->commandBuffer);
+            vkDestroySemaphore(m_device, it->semaphore, nullptr);
+        }
+        vkDestroyFence(m_device, it->fence, nullptr);
+        it = m_uploads.erase(it);
+    }
 }
 
 void HelloTriangleApplication::setupDebugMessenger()
@@ -1454,11 +2850,92 @@ void HelloTriangleApplication::setupDebugMessenger()
     }
 }
 
-void HelloTriangleApplication::transitionImageLayout(VkImage image, uint32_t mipLevels, VkFormat format,
-    VkImageLayout oldLayout, VkImageLayout newLayout)
+void HelloTriangleApplication::startAssetStreaming()
+{
+    /***
+     * The jobs do all the CPU work (decoding, parsing, mesh processing, packing) and fill their
+     * staging buffers; creating and mapping Vulkan objects is allowed from any thread. Recording and
+     * submitting the copies stays on the main thread, which owns the queue and the command pools, and
+     * happens in updateAssetStreaming() once a job has finished.
+     ***/
+    queueTextureLoad(TEXTURE_DIR, [this](const StagedTexture& texture) {
+        addTexture(texture);
+        std::cout << "texture streamed in after " << std::chrono::duration<double, std::milli>(
+            std::chrono::high_resolution_clock::now() - m_startTime).count() << " ms" << std::endl;
+    });
+
+    m_modelFuture = m_streamingThreadPool.submit([this]() {
+        loadModel();
+
+        StagedModel model {};
+        model.vertices = stageVertexBuffer();
+        model.indices = stageIndexBuffer();
+        model.lods = stageLodBuffer();
+        return model;
+    });
+}
+
+void HelloTriangleApplication::submitTextureUploads()
 {
-    VkCommandBuffer commandBuffer = beginSingleTimeCommands();
+    // Every texture whose job has finished since the last call goes into the open upload batch, which
+    // is submitted with the rest of the frame's uploads. get() rethrows anything a job has thrown.
+    std::vector<StagedTexture> textures;
+    std::vector<std::function<void(const StagedTexture&)>> callbacks;
+    for (auto it = m_textureLoads.begin(); it != m_textureLoads.end();)
+    {
+        if (it->future.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        {
+            ++ it;
+            continue;
+        }
+
+        textures.push_back(it->future.get());
+        callbacks.push_back(std::move(it->onUploaded));
+        it = m_textureLoads.erase(it);
+    }
+
+    if (textures.empty()) { return; }
+
+    std::vector<StagingBuffer> stagingBuffers;
+    for (const auto& texture : textures)
+    {
+        stagingBuffers.push_back(texture.staging);
+    }
+
+    ++ m_textureBatchesInFlight;
+    auto submitTime = std::chrono::high_resolution_clock::now();
+    queueUpload(
+        [this, textures](VkCommandBuffer commandBuffer) {
+            for (const auto& texture : textures)
+            {
+                recordTextureUpload(commandBuffer, texture);
+            }
+        },
+        std::move(stagingBuffers),
+        [this, textures, callbacks, submitTime]() {
+            for (size_t i = 0; i < textures.size(); ++ i)
+            {
+                callbacks[i](textures[i]);
+            }
+
+            -- m_textureBatchesInFlight;
+            {
+                std::lock_guard<std::mutex> lock(m_textureLoadStatsMutex);
+                ++ m_textureLoadStats.batchCount;
+                m_textureLoadStats.uploadSeconds += std::chrono::duration<double>(
+                    std::chrono::high_resolution_clock::now() - submitTime).count();
+            }
+            if (m_textureLoads.empty() && m_textureBatchesInFlight == 0)
+            {
+                reportTextureLoads();
+            }
+        }
+    );
+}
 
+void HelloTriangleApplication::transitionImageLayout(VkCommandBuffer commandBuffer, VkImage image, uint32_t baseMipLevel,
+    uint32_t mipLevels, VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout)
+{
     VkAccessFlags srcAccessMask, dstAccessMask;
     VkPipelineStageFlags srcStage, dstStage;
 
@@ -1491,7 +2968,7 @@ void HelloTriangleApplication::transitionImageLayout(VkImage image, uint32_t mip
     barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
     barrier.image = image;
     barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    barrier.subresourceRange.baseMipLevel = 0;
+    barrier.subresourceRange.baseMipLevel = baseMipLevel;
     barrier.subresourceRange.levelCount = mipLevels;
     barrier.subresourceRange.baseArrayLayer = 0;
     barrier.subresourceRange.layerCount = 1;
@@ -1499,15 +2976,161 @@ void HelloTriangleApplication::transitionImageLayout(VkImage image, uint32_t mip
     barrier.dstAccessMask = dstAccessMask;
 
     vkCmdPipelineBarrier(commandBuffer, srcStage, dstStage, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+}
+
+void HelloTriangleApplication::updateAssetStreaming()
+{
+    // Swap in the resources whose upload has completed. The texture only replaces the placeholder in a
+    // descriptor set once the frame that last used the set has finished, see drawFrame().
+    retireUploads(false);
+
+    // Record the uploads of finished jobs. get() rethrows anything a job has thrown.
+    submitTextureUploads();
+
+    // Stream finer mip levels in and evict textures over the budget.
+    updateTextureStreaming();
+
+    if (m_modelFuture.valid() && m_modelFuture.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+    {
+        StagedModel model = m_modelFuture.get();
+        queueUpload(
+            [this, model](VkCommandBuffer commandBuffer) { recordModelUpload(commandBuffer, model); },
+            { model.vertices, model.indices, model.lods },
+            [this]() {
+                m_modelReady = true;
+                std::cout << "model streamed in after " << std::chrono::duration<double, std::milli>(
+                    std::chrono::high_resolution_clock::now() - m_startTime).count() << " ms" << std::endl;
+            }
+        );
+    }
+
+    // Everything recorded above goes into one submission, ahead of the frame's.
+    flushUploads();
+}
+
+void HelloTriangleApplication::updateDescriptorSet(size_t frameIndex)
+{
+    // The offset of the frame's block within the uniform ring is added when the set is bound.
+    VkDescriptorBufferInfo bufferInfo {};
+    bufferInfo.buffer = m_uniformBuffer;
+    bufferInfo.offset = 0;
+    bufferInfo.range = sizeof(UniformBufferObject);
+
+    // Until the texture has streamed in, the placeholder is bound in its place. Bindless, every texture
+    // goes into the array element of its index.
+    size_t textureCount = m_bindlessTextureCount > 0 ? std::max<size_t>(m_textures.size(), 1) : 1;
+    std::vector<VkDescriptorImageInfo> imageInfos(textureCount);
+    for (size_t i = 0; i < textureCount; ++ i)
+    {
+        imageInfos[i].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        imageInfos[i].imageView = i < m_textures.size() ? m_textures[i].view : m_placeholderImageView;
+        imageInfos[i].sampler = m_textureSampler;
+    }
+
+    VkDescriptorBufferInfo objectBufferInfo {};
+    objectBufferInfo.buffer = m_objectBuffer;
+    objectBufferInfo.offset = 0;
+    objectBufferInfo.range = VK_WHOLE_SIZE;
+
+    std::vector<VkWriteDescriptorSet> writeDescriptors(enableIndirectDraw ? 3 : 2);
+
+    writeDescriptors[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    writeDescriptors[0].dstSet = m_descriptorSets[frameIndex];
+    writeDescriptors[0].dstBinding = 0;
+    writeDescriptors[0].dstArrayElement = 0;
+    writeDescriptors[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+    writeDescriptors[0].descriptorCount = 1;
+    writeDescriptors[0].pBufferInfo = &bufferInfo;
+
+    writeDescriptors[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    writeDescriptors[1].dstSet = m_bindlessTextureCount > 0 ? m_bindlessDescriptorSets[frameIndex] : m_descriptorSets[frameIndex];
+    writeDescriptors[1].dstBinding = m_bindlessTextureCount > 0 ? 0 : 1;
+    writeDescriptors[1].dstArrayElement = 0;
+    writeDescriptors[1].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    writeDescriptors[1].descriptorCount = static_cast<uint32_t>(imageInfos.size());
+    writeDescriptors[1].pImageInfo = imageInfos.data();
+
+    if (enableIndirectDraw)
+    {
+        writeDescriptors[2].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writeDescriptors[2].dstSet = m_descriptorSets[frameIndex];
+        writeDescriptors[2].dstBinding = 2;
+        writeDescriptors[2].dstArrayElement = 0;
+        writeDescriptors[2].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        writeDescriptors[2].descriptorCount = 1;
+        writeDescriptors[2].pBufferInfo = &objectBufferInfo;
+    }
+
+    vkUpdateDescriptorSets(
+        m_device, static_cast<uint32_t>(writeDescriptors.size()), writeDescriptors.data(), 0,
+        nullptr
+    );
+
+    m_descriptorSetsDirty[frameIndex] = false;
+}
+
+void HelloTriangleApplication::updateTextureStreaming()
+{
+    /***
+     * Every texture keeps its mip tail. Over the budget, the least recently drawn textures are shrunk
+     * to it first. A shrunk texture that is drawn again grows back to an image for its whole chain
+     * once that fits, for which textures not drawn in the last frame are evicted. The levels between
+     * the tail and the full size are then streamed into that image coarsest first, one level per
+     * texture at a time. Everything a frame starts goes into one submission.
+     ***/
+    TextureStreamingBatch batch {};
+    evictTextures(TEXTURE_MEMORY_BUDGET, std::numeric_limits<uint64_t>::max(), batch);
+
+    for (size_t i = 0; i < m_textures.size(); ++ i)
+    {
+        const Texture& texture = m_textures[i];
+        if (!texture.source || texture.streaming || texture.lastUsedFrame + 1 < m_frameCount)
+        {
+            continue;
+        }
+
+        if (texture.firstLevel > 0)
+        {
+            VkDeviceSize growth = texture.fullMemorySize - texture.memorySize;
+            if (growth > TEXTURE_MEMORY_BUDGET) { continue; }
+
+            evictTextures(TEXTURE_MEMORY_BUDGET - growth, m_frameCount - 1, batch);
+            if (m_textureMemory + growth <= TEXTURE_MEMORY_BUDGET)
+            {
+                reallocateTexture(i, 0, batch);
+            }
+        }
+        else if (texture.residentLevel > 0)
+        {
+            streamTextureLevel(i, batch);
+        }
+    }
 
-    endSingleTimeCommands(commandBuffer);
+    if (batch.records.empty()) { return; }
+
+    queueUpload(
+        [records = std::move(batch.records)](VkCommandBuffer commandBuffer) {
+            for (const auto& record : records)
+            {
+                record(commandBuffer);
+            }
+        },
+        std::move(batch.stagingBuffers),
+        [swapIns = std::move(batch.swapIns)]() {
+            for (const auto& swapIn : swapIns)
+            {
+                swapIn();
+            }
+        }
+    );
 }
 
-void HelloTriangleApplication::updateUniformBuffer(uint32_t imageIndex)
+UniformBufferObject HelloTriangleApplication::updateUniformBuffer()
 {
     /***
      * This function will generate a new transformation every frame to make the geometry spin around
-     * 90 degrees per second regardless of frame rate.
+     * 90 degrees per second regardless of frame rate. It returns the frame's uniform block, which
+     * every draw of the frame shares.
      ***/
 
     // Mark start time.
@@ -1518,23 +3141,41 @@ void HelloTriangleApplication::updateUniformBuffer(uint32_t imageIndex)
 
     UniformBufferObject ubo {};
     // Define model transformation in UBO.
-    ubo.model = glm::rotate(glm::mat4(1.f), deltaTime * glm::radians(90.f), glm::vec3(0.f, 0.f, 1.f));
+    ubo.model = getModelTransform(deltaTime);
     // Define view transformation in UBO.
-    ubo.view = glm::lookAt(glm::vec3(2.f, 2.f, 2.f), glm::vec3(0.f, 0.f, 0.f), glm::vec3(0.f, 0.f, 1.f));
+    ubo.view = getViewTransform();
     // Define proj transformation in UBO.
-    ubo.proj = glm::perspective(
-        glm::radians(45.f),
-        m_swapchainExtent.width / static_cast<float>(m_swapchainExtent.height),
-        .1f, 10.f
-    );
-    // Flip the Y coordinate as GLM was originally designed for OpenGL, where the Y coordinate is inverted.
-    ubo.proj[1][1] *= -1;
+    ubo.proj = getProjTransform(m_swapchainExtent.width / static_cast<float>(m_swapchainExtent.height));
+
+    // The vertex decode belongs to the model, which may still be streaming.
+    if (m_modelReady)
+    {
+        // Define vertex decode in UBO.
+        ubo.positionScale = m_vertexDecode.positionScale;
+        ubo.positionOffset = m_vertexDecode.positionOffset;
+        ubo.textureCoordTransform = m_vertexDecode.textureCoordTransform;
+    }
 
-    // Copy the uniform buffer object to the uniform buffer.
-    void* data;
-    vkMapMemory(m_device, m_uniformBuffersMemory[imageIndex], 0, sizeof(ubo), 0, &data);
-    memcpy(data, &ubo, sizeof(ubo));
-    vkUnmapMemory(m_device, m_uniformBuffersMemory[imageIndex]);
+    return ubo;
+}
+
+void HelloTriangleApplication::waitForTextureLoads()
+{
+    // Jobs may be waiting for staging space that only retiring uploads frees, so finished jobs keep
+    // being submitted and retired while waiting for the rest.
+    while (!m_textureLoads.empty() || m_textureBatchesInFlight > 0)
+    {
+        submitTextureUploads();
+        if (m_textureBatchesInFlight > 0)
+        {
+            flushUploads();
+            retireUploads(true);
+        }
+        else if (!m_textureLoads.empty())
+        {
+            m_textureLoads.front().future.wait_for(std::chrono::milliseconds(1));
+        }
+    }
 }
 
 void HelloTriangleApplication::framebufferResizeCallback(GLFWwindow* window, int width, int height)
@@ -1546,6 +3187,17 @@ void HelloTriangleApplication::framebufferResizeCallback(GLFWwindow* window, int
 /* ************************************************************************************************
  * Private Helper Functions
  * ************************************************************************************************/
+uint32_t HelloTriangleApplication::getMipTailLevel(uint32_t width, uint32_t height, uint32_t mipLevels)
+{
+    // The first level no larger than MIP_TAIL_SIZE in either dimension.
+    uint32_t level = 0;
+    while (level + 1 < mipLevels && std::max(width >> level, height >> level) > MIP_TAIL_SIZE)
+    {
+        ++ level;
+    }
+    return level;
+}
+
 std::vector<char> HelloTriangleApplication::readFile(const std::string& filename)
 {
     std::ifstream file(filename, std::ios::ate | std::ios::binary);
@@ -1561,33 +3213,80 @@ std::vector<char> HelloTriangleApplication::readFile(const std::string& filename
     return buffer;
 }
 
-VkCommandBuffer HelloTriangleApplication::beginSingleTimeCommands()
+void HelloTriangleApplication::addTexture(const StagedTexture& staged)
 {
-    // Create command buffers for copying buffer.
-    VkCommandBufferAllocateInfo allocInfo {};
-    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-    allocInfo.commandPool = m_commandPoolTransient;
-    allocInfo.commandBufferCount = 1;
+    // Takes over the image of a freshly uploaded texture, which covers the whole chain. Its view starts
+    // at the finest level staged, and the finer ones are streamed in from the source later.
+    if (m_bindlessTextureCount > 0 && m_textures.size() >= m_bindlessTextureCount)
+    {
+        throw std::runtime_error("too many textures for the bindless texture array");
+    }
 
-    VkCommandBuffer commandBuffer;
-    vkAllocateCommandBuffers(m_device, &allocInfo, &commandBuffer);
+    Texture texture {};
+    texture.source = staged.source;
+    texture.image = staged.image;
+    texture.imageMemory = staged.imageMemory;
+    texture.format = staged.format;
+    texture.mipLevels = staged.mipLevels;
+    texture.residentLevel = staged.baseLevel;
+    texture.tailLevel = staged.source ? getMipTailLevel(staged.width, staged.height, staged.mipLevels) : 0;
+    texture.lastUsedFrame = m_frameCount;
+    texture.view = createImageView(
+        texture.image, texture.residentLevel, texture.mipLevels - texture.residentLevel, texture.format,
+        VK_IMAGE_ASPECT_COLOR_BIT
+    );
 
-    // Start recording command buffer.
-    VkCommandBufferBeginInfo beginInfo {};
-    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-    vkBeginCommandBuffer(commandBuffer, &beginInfo);
+    VkMemoryRequirements memRequirements;
+    vkGetImageMemoryRequirements(m_device, texture.image, &memRequirements);
+    texture.memorySize = memRequirements.size;
+    texture.fullMemorySize = memRequirements.size;
+    m_textureMemory += texture.memorySize;
+
+    m_textures.push_back(texture);
+    m_descriptorSetsDirty.assign(m_descriptorSetsDirty.size(), true);
+}
+
+HelloTriangleApplication::StagingBuffer HelloTriangleApplication::allocateStagingBuffer(VkDeviceSize size,
+    VkDeviceSize alignment)
+{
+    // Takes a mapped range of the staging region, waiting while it is full. Only a request larger than
+    // the whole region gets a buffer of its own. Safe on any thread.
+    StagingBuffer staging {};
+    staging.size = size;
+    if (m_stagingRing.allocate(size, alignment, staging.offset))
+    {
+        staging.buffer = m_stagingRegion.buffer;
+        staging.data = m_stagingRegion.data + staging.offset;
+        return staging;
+    }
+
+    createBuffer(
+        size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, MemoryUsage::Upload, staging.buffer, staging.allocation
+    );
 
-    return commandBuffer;
+    staging.data = staging.allocation.data;
+    return staging;
 }
 
 /* ************************************************************************************************
  * Private Helper Functions
  * ************************************************************************************************/
-bool HelloTriangleApplication::checkDeviceExtensionSupport(VkPhysicalDevice device)
+void HelloTriangleApplication::bindDescriptorSets(VkCommandBuffer commandBuffer, uint32_t uniformOffset)
 {
-    uint32_t extensionCount;
+    // The frame's set, with the offset of its uniform block, and bindless, its texture array.
+    VkDescriptorSet descriptorSets[] = {
+        m_descriptorSets[m_currentFrame],
+        m_bindlessTextureCount > 0 ? m_bindlessDescriptorSets[m_currentFrame] : VK_NULL_HANDLE
+    };
+    vkCmdBindDescriptorSets(
+        commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipelineLayout, 0, m_bindlessTextureCount > 0 ? 2 : 1,
+        descriptorSets, 1, &uniformOffset
+    );
+}
+
+bool HelloTriangleApplication::checkDeviceExtensionSupport(VkPhysicalDevice device)
+{
+    uint32_t extensionCount;
     vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, nullptr);
     std::vector<VkExtensionProperties> availableExtensions(extensionCount);
     vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, availableExtensions.data());
@@ -1697,30 +3396,11 @@ VKAPI_ATTR VkBool32 VKAPI_CALL HelloTriangleApplication::debugCallback(
     return VK_FALSE;
 }
 
-void HelloTriangleApplication::copyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size)
+void HelloTriangleApplication::copyBufferToImage(VkCommandBuffer commandBuffer, VkBuffer buffer,
+    VkDeviceSize bufferOffset, VkImage image, uint32_t width, uint32_t height)
 {
-    // Begin a single time command buffer recording.
-    auto commandBuffer = beginSingleTimeCommands();
-
-    // Specify copy region.
-    VkBufferCopy copyRegion {};
-    copyRegion.srcOffset = 0;
-    copyRegion.dstOffset = 0;
-    copyRegion.size = size;
-
-    // Issue actual copy command.
-    vkCmdCopyBuffer(commandBuffer, srcBuffer, dstBuffer, 1, &copyRegion);
-
-    // Finish a single time command buffer recording, execute and clean up.
-    endSingleTimeCommands(commandBuffer);
-}
-
-void HelloTriangleApplication::copyBufferToImage(VkBuffer buffer, VkImage image, uint32_t width, uint32_t height)
-{
-    VkCommandBuffer commandBuffer = beginSingleTimeCommands();
-
     VkBufferImageCopy region {};
-    region.bufferOffset = 0;
+    region.bufferOffset = bufferOffset;
     region.bufferRowLength = 0;
     region.bufferImageHeight = 0;
     region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
@@ -1731,12 +3411,10 @@ void HelloTriangleApplication::copyBufferToImage(VkBuffer buffer, VkImage image,
     region.imageExtent = { width, height, 1 };
 
     vkCmdCopyBufferToImage(commandBuffer, buffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
-
-    endSingleTimeCommands(commandBuffer);
 }
 
 void HelloTriangleApplication::createBuffer(VkDeviceSize size, VkBufferUsageFlags usage,
-    VkMemoryPropertyFlags properties, VkBuffer& buffer, VkDeviceMemory& bufferMemory)
+    MemoryUsage memoryUsage, VkBuffer& buffer, DeviceAllocation& bufferMemory)
 {
     VkBufferCreateInfo bufferInfo {};
     bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
@@ -1753,27 +3431,16 @@ void HelloTriangleApplication::createBuffer(VkDeviceSize size, VkBufferUsageFlag
     VkMemoryRequirements memRequirements;
     vkGetBufferMemoryRequirements(m_device, buffer, &memRequirements);
 
-    // Allocate memory for the buffer.
-    VkMemoryAllocateInfo allocInfo {};
-    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocInfo.allocationSize = memRequirements.size;
-    allocInfo.memoryTypeIndex = findMemoryType(
-        memRequirements.memoryTypeBits,
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
-    );
-
-    if (vkAllocateMemory(m_device, &allocInfo, nullptr, &bufferMemory) != VK_SUCCESS)
-    {
-        throw std::runtime_error("failed to allocate buffer memory");
-    }
+    // Sub-allocate memory for the buffer from the memory type its usage calls for.
+    bufferMemory = m_allocator.allocate(memRequirements, memoryUsage, false);
 
     // Bind the memory to the buffer.
-    vkBindBufferMemory(m_device, buffer, bufferMemory, 0);
+    vkBindBufferMemory(m_device, buffer, bufferMemory.memory, bufferMemory.offset);
 }
 
 void HelloTriangleApplication::createImage(uint32_t width, uint32_t height, uint32_t mipLevels,
     VkSampleCountFlagBits numSamples, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage,
-    VkMemoryPropertyFlags properties, VkImage& image, VkDeviceMemory& imageMemory)
+    MemoryUsage memoryUsage, VkImage& image, DeviceAllocation& imageMemory)
 {
     // Create image object.
     VkImageCreateInfo imageInfo {};
@@ -1797,26 +3464,19 @@ void HelloTriangleApplication::createImage(uint32_t width, uint32_t height, uint
         throw std::runtime_error("failed to create texture image");
     }
 
-    // Allocate memory for the image object.
+    // Sub-allocate memory for the image object. Optimal tiling images are kept apart from buffers
+    // where bufferImageGranularity requires it.
     VkMemoryRequirements memRequirements;
     vkGetImageMemoryRequirements(m_device, image, &memRequirements);
 
-    VkMemoryAllocateInfo allocInfo {};
-    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocInfo.allocationSize = memRequirements.size;
-    allocInfo.memoryTypeIndex = findMemoryType(memRequirements.memoryTypeBits, properties);
-
-    if (vkAllocateMemory(m_device, &allocInfo, nullptr, &imageMemory) != VK_SUCCESS)
-    {
-        throw std::runtime_error("failed to allocate texture image memory");
-    }
+    imageMemory = m_allocator.allocate(memRequirements, memoryUsage, tiling == VK_IMAGE_TILING_OPTIMAL);
 
     // Bind the image object with its allocated memory.
-    vkBindImageMemory(m_device, image, imageMemory, 0);
+    vkBindImageMemory(m_device, image, imageMemory.memory, imageMemory.offset);
 }
 
-VkImageView HelloTriangleApplication::createImageView(VkImage image, uint32_t mipLevels, VkFormat format,
-    VkImageAspectFlags aspectFlags)
+VkImageView HelloTriangleApplication::createImageView(VkImage image, uint32_t baseMipLevel, uint32_t mipLevels,
+    VkFormat format, VkImageAspectFlags aspectFlags)
 {
     VkImageViewCreateInfo createInfo {};
     createInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
@@ -1828,7 +3488,7 @@ VkImageView HelloTriangleApplication::createImageView(VkImage image, uint32_t mi
     // For this case, the images will be used as colour targets without any mipmaapping levels
     // nor mutiple layers.
     createInfo.subresourceRange.aspectMask = aspectFlags;
-    createInfo.subresourceRange.baseMipLevel = 0;
+    createInfo.subresourceRange.baseMipLevel = baseMipLevel;
     createInfo.subresourceRange.levelCount = mipLevels;
     createInfo.subresourceRange.baseArrayLayer = 0;
     createInfo.subresourceRange.layerCount = 1;
@@ -1858,25 +3518,6 @@ VkShaderModule HelloTriangleApplication::createShaderModule(const std::vector<ch
     return shaderModule;
 }
 
-void HelloTriangleApplication::endSingleTimeCommands(VkCommandBuffer commandBuffer)
-{
-    // End recording command buffer.
-    vkEndCommandBuffer(commandBuffer);
-
-    // Submit the command buffer.
-    VkSubmitInfo submitInfo {};
-    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-    submitInfo.commandBufferCount = 1;
-    submitInfo.pCommandBuffers = &commandBuffer;
-    vkQueueSubmit(m_graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE);
-
-    // Wait for the execution to complete.
-    vkQueueWaitIdle(m_graphicsQueue);
-
-    // Free command buffer.
-    vkFreeCommandBuffers(m_device, m_commandPoolTransient, 1, &commandBuffer);
-}
-
 VkFormat HelloTriangleApplication::findDepthFormat()
 {
     return findSupportedFormat(
@@ -1886,40 +3527,6 @@ VkFormat HelloTriangleApplication::findDepthFormat()
     );
 }
 
-uint32_t HelloTriangleApplication::findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties)
-{
-    /***
-     * Graphics cards offer different types of memory to allocate from. Each type of memory varies
-     * in terms of allowed operations and performance characteristics. We need to combine the
-     * requirements of the buffer and our application requirements to find the right type of memory
-     * to use.
-     ***/
-
-    // First we need to query info about the available types of memory.
-    VkPhysicalDeviceMemoryProperties memProperties;
-    vkGetPhysicalDeviceMemoryProperties(m_physicalDevice, &memProperties);
-
-    // Find a memory type that is suitable for the buffer.
-    for (uint32_t i = 0; i < memProperties.memoryTypeCount; ++ i)
-    {
-        /***
-         * VkMemoryRequirements::memoryTypeBits (typeFilter) is a bitmask and contains one bit set
-         * for every supported memory type for the resource. Bit i is set if and only if the memory
-         * type i in the VkPhysicalDeviceMemoryProperties structure for the physical device is
-         * supported for the resource (vertices in this case).
-         ***/
-
-        // The bits set in typeFilter indicates the indices of the memory types that are supported
-        // for the resource in memProperties.
-        if (typeFilter & (1 << i) && (memProperties.memoryTypes[i].propertyFlags & properties) == properties)
-        {
-            return i;
-        }
-    }
-
-    throw std::runtime_error("failed to find a suitable memory type");
-}
-
 HelloTriangleApplication::QueueFamilyIndices HelloTriangleApplication::findQueueFamilies(VkPhysicalDevice device)
 {
     QueueFamilyIndices indices {};
@@ -1935,7 +3542,7 @@ HelloTriangleApplication::QueueFamilyIndices HelloTriangleApplication::findQueue
     for (const auto& queueFamily : queueFamilies)
     {
         // Find a queue family that supports drawing (graphics queue).
-        if (queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT)
+        if (queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT && !indices.graphicsFamily.has_value())
         {
             indices.graphicsFamily = i;
         }
@@ -1943,12 +3550,20 @@ HelloTriangleApplication::QueueFamilyIndices HelloTriangleApplication::findQueue
         // Find a queue family that supports presentation to the window surface (present queue).
         VkBool32 presentSupport = false;
         vkGetPhysicalDeviceSurfaceSupportKHR(device, i, m_surface, &presentSupport);
-        if (presentSupport)
+        if (presentSupport && !indices.presentFamily.has_value())
         {
             indices.presentFamily = i;
         }
 
-        if (indices.isComplete())
+        // Find a queue family that does nothing but transfers (transfer queue). Graphics and compute
+        // families support transfers as well, but share their queues' time with other work.
+        if ((queueFamily.queueFlags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT | VK_QUEUE_TRANSFER_BIT)) ==
+            VK_QUEUE_TRANSFER_BIT && !indices.transferFamily.has_value())
+        {
+            indices.transferFamily = i;
+        }
+
+        if (indices.isComplete() && indices.transferFamily.has_value())
         {
             break;
         }
@@ -2042,6 +3657,144 @@ bool HelloTriangleApplication::isDeviceSuitable(VkPhysicalDevice device)
     return true;
 }
 
+bool HelloTriangleApplication::isTextureFormatSupported(VkFormat format)
+{
+    // Block compressed formats may be listed as sampleable, but also need the feature enabled.
+    if (Ktx2File::getBlockDimension(format) == 4 && !m_deviceFeatures.textureCompressionBC)
+    {
+        return false;
+    }
+
+    VkFormatProperties formatProps;
+    vkGetPhysicalDeviceFormatProperties(m_physicalDevice, format, &formatProps);
+
+    VkFormatFeatureFlags required = VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+    return (formatProps.optimalTilingFeatures & required) == required;
+}
+
+HelloTriangleApplication::StagedTexture HelloTriangleApplication::loadTexture(const std::string& filename)
+{
+    /***
+     * 1. A KTX2 file next to the source image holds the mip chain ready for upload. Files written
+     *    here record the hash of their source and settings and are rebuilt when those change; files
+     *    from other tools are used as they are.
+     * 2. Otherwise the source is decoded and its mip chain is built on the CPU, block compressed if
+     *    that is enabled and supported, and written out as KTX2 for the next run.
+     * 3. Only if CPU mipmaps are disabled and the GPU can filter the format, the source is uploaded
+     *    as RGBA8 and its mip chain is blitted on the GPU.
+     ***/
+    TextureCompression compression = TEXTURE_COMPRESSION;
+    VkFormat format = VK_FORMAT_R8G8B8A8_SRGB;
+    if (compression != TextureCompression::None)
+    {
+        format = compression == TextureCompression::Bc1 ? VK_FORMAT_BC1_RGB_SRGB_BLOCK : VK_FORMAT_BC7_SRGB_BLOCK;
+        if (!isTextureFormatSupported(format))
+        {
+            compression = TextureCompression::None;
+            format = VK_FORMAT_R8G8B8A8_SRGB;
+        }
+    }
+
+    const std::string sourceHashKey = "VulkanPlayground.sourceHash";
+    std::string ktx2Filename = std::filesystem::path(filename).replace_extension(".ktx2").string();
+    uint64_t sourceHash = MeshCache::hashSourceFile(filename);
+    sourceHash = MeshCache::hashCombine(sourceHash, static_cast<uint64_t>(compression));
+    std::string sourceHashValue = std::to_string(sourceHash);
+
+    // While streaming, only the mip tail is uploaded with the texture.
+    auto stageKtx2 = [this](std::shared_ptr<Ktx2File> file) {
+        uint32_t baseLevel = enableAssetStreaming ? getMipTailLevel(file->width(), file->height(), file->levelCount()) : 0;
+        return stageKtx2Texture(std::move(file), 0, baseLevel, true);
+    };
+
+    auto ktx2 = std::make_shared<Ktx2File>();
+    if (ktx2->load(ktx2Filename))
+    {
+        std::string recordedHash = ktx2->findValue(sourceHashKey);
+        if (!isTextureFormatSupported(static_cast<VkFormat>(ktx2->vkFormat())))
+        {
+            std::cerr << "texture " << ktx2Filename << " has a format the device cannot sample" << std::endl;
+        }
+        else if (recordedHash.empty() || recordedHash == sourceHashValue)
+        {
+            return stageKtx2(ktx2);
+        }
+    }
+
+    std::vector<char> source = readFile(filename);
+    auto sourceData = reinterpret_cast<const uint8_t*>(source.data());
+    uint32_t width, height;
+
+    if (!TextureDecoder::readInfo(sourceData, source.size(), width, height))
+    {
+        throw std::runtime_error("failed to load texture image source");
+    }
+
+    // Without a CPU mip chain, the image is decoded straight into the staging memory.
+    if (compression == TextureCompression::None && !enableCpuMipmaps && isTextureFormatSupported(format))
+    {
+        StagedTexture texture = stageTextureImage(width, height);
+        try
+        {
+            TextureDecoder::decode(sourceData, source.size(), texture.staging.data, width, height);
+        }
+        catch (...)
+        {
+            releaseStagingBuffer(texture.staging);
+            vkDestroyImage(m_device, texture.image, nullptr);
+            m_allocator.free(texture.imageMemory);
+            throw;
+        }
+
+        return texture;
+    }
+
+    auto startTime = std::chrono::high_resolution_clock::now();
+    std::vector<uint8_t> pixels(static_cast<size_t>(width) * height * 4);
+    TextureDecoder::decode(sourceData, source.size(), pixels.data(), width, height);
+
+    std::vector<std::vector<uint8_t>> levels;
+    MipGenerator::generate(pixels.data(), width, height, levels, m_threadPool);
+
+    std::cout << "texture mipmaps: " << filename << " " << width << "x" << height << " ("
+              << TextureDecoder::getDecoderName(sourceData, source.size()) << "), " << levels.size()
+              << " levels (" << MipGenerator::getInstructionSet() << "), "
+              << std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count()
+              << " ms" << std::endl;
+
+    if (compression != TextureCompression::None)
+    {
+        startTime = std::chrono::high_resolution_clock::now();
+        float error = 0.f;
+        size_t encodedSize = 0;
+        for (uint32_t level = 0; level < levels.size(); ++ level)
+        {
+            uint32_t levelWidth = std::max(width >> level, 1u);
+            uint32_t levelHeight = std::max(height >> level, 1u);
+            std::vector<uint8_t> encoded(TextureCompressor::getEncodedSize(compression, levelWidth, levelHeight));
+            float levelError = TextureCompressor::encode(
+                compression, levels[level].data(), levelWidth, levelHeight, encoded.data(), m_threadPool
+            );
+            if (level == 0) { error = levelError; }
+
+            encodedSize += encoded.size();
+            levels[level].swap(encoded);
+        }
+
+        std::cout << "texture compression: " << filename << " -> " << encodedSize << " bytes, RMS error " << error
+                  << ", " << std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count()
+                  << " ms" << std::endl;
+    }
+
+    ktx2->create(format, width, height, levels, { { sourceHashKey, sourceHashValue } });
+    if (!ktx2->save(ktx2Filename))
+    {
+        std::cerr << "failed to write texture " << ktx2Filename << std::endl;
+    }
+
+    return stageKtx2(ktx2);
+}
+
 void HelloTriangleApplication::populateDebugMessengerCreateInfo(VkDebugUtilsMessengerCreateInfoEXT& createInfo)
 {
     createInfo = {};
@@ -2085,6 +3838,671 @@ HelloTriangleApplication::SwapchainSupportDetails HelloTriangleApplication::quer
     return details;
 }
 
+bool HelloTriangleApplication::reallocateTexture(size_t index, uint32_t firstLevel, TextureStreamingBatch& batch)
+{
+    // Replaces the image of a texture by one for the levels from firstLevel down, which frees memory or
+    // makes room for finer levels. Only the mip tail is uploaded into it; the rest is streamed in
+    // again. False if the staging region has no room this frame.
+    Texture& texture = m_textures[index];
+    StagedTexture staged = stageKtx2Texture(texture.source, firstLevel, texture.tailLevel, false);
+    if (staged.image == VK_NULL_HANDLE) { return false; }
+
+    VkMemoryRequirements memRequirements;
+    vkGetImageMemoryRequirements(m_device, staged.image, &memRequirements);
+    m_textureMemory = m_textureMemory - texture.memorySize + memRequirements.size;
+    texture.memorySize = memRequirements.size;
+    texture.streaming = true;
+
+    batch.records.push_back([this, staged](VkCommandBuffer commandBuffer) {
+        recordTextureUpload(commandBuffer, staged);
+    });
+    batch.stagingBuffers.push_back(staged.staging);
+    batch.swapIns.push_back([this, index, firstLevel, staged]() {
+        Texture& texture = m_textures[index];
+        Texture retired {};
+        retired.image = texture.image;
+        retired.imageMemory = texture.imageMemory;
+        m_retiredTextures.push_back(retired);
+
+        texture.image = staged.image;
+        texture.imageMemory = staged.imageMemory;
+        texture.firstLevel = firstLevel;
+        texture.residentLevel = texture.tailLevel;
+        texture.streaming = false;
+        replaceTextureView(texture);
+    });
+    return true;
+}
+
+void HelloTriangleApplication::recordCulling(VkCommandBuffer commandBuffer, const UniformBufferObject& ubo)
+{
+    /***
+     * Culls every object against the frame's view and writes the draw commands of the survivors, each
+     * for the coarsest level of detail its projected error allows, to m_drawCommandBuffer. With
+     * drawIndirectCount they are compacted and counted; without, every object keeps its command and
+     * culled ones draw no instances. The previous frame's depth pyramid is only tested against once
+     * one has been built for the current swapchain.
+     ***/
+    FrameCulling& culling = m_frameCulling[m_currentFrame];
+
+    // The frame's fence has signalled, so the counters of its last culling can be read back.
+    if (culling.pending)
+    {
+        auto counters = reinterpret_cast<const CullingCounters*>(culling.counterBufferMemory.data);
+        uint32_t frustumCulled = culling.constants.objectCount -
+            ObjectCuller::countInFrustum(culling.constants, m_objectPositions);
+        uint32_t mismatch = std::max(counters->frustumCulled, frustumCulled) - std::min(counters->frustumCulled, frustumCulled);
+
+        ++ m_cullingStats.frameCount;
+        m_cullingStats.objectCount += culling.constants.objectCount;
+        m_cullingStats.frustumCulled += counters->frustumCulled;
+        m_cullingStats.occlusionCulled += counters->occlusionCulled;
+        m_cullingStats.drawn += counters->drawn;
+        m_cullingStats.mismatchCount += mismatch > 0 ? 1 : 0;
+        m_cullingStats.largestMismatch = std::max(m_cullingStats.largestMismatch, mismatch);
+    }
+
+    if (culling.descriptorSetDirty)
+    {
+        std::array<VkDescriptorBufferInfo, 5> bufferInfos {};
+        bufferInfos[0].buffer = m_objectBuffer;
+        bufferInfos[1].buffer = m_drawCommandBuffer;
+        bufferInfos[2].buffer = m_drawCountBuffer;
+        bufferInfos[3].buffer = culling.counterBuffer;
+        bufferInfos[4].buffer = m_lodBuffer;
+        for (auto& bufferInfo : bufferInfos)
+        {
+            bufferInfo.offset = 0;
+            bufferInfo.range = VK_WHOLE_SIZE;
+        }
+
+        VkDescriptorImageInfo pyramidInfo {};
+        pyramidInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+        pyramidInfo.imageView = m_depthPyramidView;
+        pyramidInfo.sampler = m_depthPyramidSampler;
+
+        // The depth pyramid is bound between the counters and the levels of detail.
+        const uint32_t pyramidBinding = 4;
+        std::array<VkWriteDescriptorSet, 6> writeDescriptors {};
+        for (uint32_t binding = 0; binding < writeDescriptors.size(); ++ binding)
+        {
+            writeDescriptors[binding].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            writeDescriptors[binding].dstSet = culling.descriptorSet;
+            writeDescriptors[binding].dstBinding = binding;
+            writeDescriptors[binding].dstArrayElement = 0;
+            writeDescriptors[binding].descriptorCount = 1;
+            if (binding != pyramidBinding)
+            {
+                writeDescriptors[binding].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+                writeDescriptors[binding].pBufferInfo = &bufferInfos[binding < pyramidBinding ? binding : binding - 1];
+            }
+            else
+            {
+                writeDescriptors[binding].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+                writeDescriptors[binding].pImageInfo = &pyramidInfo;
+            }
+        }
+
+        vkUpdateDescriptorSets(
+            m_device, static_cast<uint32_t>(writeDescriptors.size()), writeDescriptors.data(), 0, nullptr
+        );
+        culling.descriptorSetDirty = false;
+    }
+
+    culling.constants = ObjectCuller::getConstants(
+        m_boundingSphere, ubo.model, ubo.view, ubo.proj, static_cast<float>(m_swapchainExtent.height), LOD_PIXEL_ERROR
+    );
+    culling.constants.pyramidSize = glm::vec2(m_swapchainExtent.width, m_swapchainExtent.height);
+    culling.constants.objectCount = static_cast<uint32_t>(m_objectPositions.size());
+    culling.constants.lodCount = static_cast<uint32_t>(m_lods.size());
+    culling.constants.occlusion = m_depthPyramidReady ? 1 : 0;
+    culling.constants.compact = m_drawIndirectCount ? 1 : 0;
+    culling.pending = true;
+
+    // The previous frame's draws must have read the commands before they are cleared and rewritten.
+    VkMemoryBarrier barrier {};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = 0;
+    barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    vkCmdPipelineBarrier(
+        commandBuffer, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &barrier, 0,
+        nullptr, 0, nullptr
+    );
+
+    vkCmdFillBuffer(commandBuffer, m_drawCountBuffer, 0, sizeof(uint32_t), 0);
+    vkCmdFillBuffer(commandBuffer, culling.counterBuffer, 0, VK_WHOLE_SIZE, 0);
+
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    vkCmdPipelineBarrier(
+        commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &barrier, 0,
+        nullptr, 0, nullptr
+    );
+
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_cullPipeline);
+    vkCmdBindDescriptorSets(
+        commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_cullPipelineLayout, 0, 1, &culling.descriptorSet, 0, nullptr
+    );
+    vkCmdPushConstants(
+        commandBuffer, m_cullPipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(CullingConstants),
+        &culling.constants
+    );
+    vkCmdDispatch(commandBuffer, (culling.constants.objectCount + 63) / 64, 1, 1);
+
+    // The commands and the count go to the draws, the counters to the CPU once the fence has signalled.
+    barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_HOST_READ_BIT;
+    vkCmdPipelineBarrier(
+        commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_HOST_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr
+    );
+}
+
+void HelloTriangleApplication::recordDepthPyramid(VkCommandBuffer commandBuffer)
+{
+    /***
+     * Reduces the frame's depth buffer into the depth pyramid, level by level, each from the one
+     * above. The depth buffer is read as a texture between the render passes. The reduction waits for
+     * this frame's culling, which reads the previous pyramid, and the next render pass waits for the
+     * reduction before it clears the depth buffer again. A pyramid that no frame has built yet, new or
+     * recreated with the swapchain, is moved into the general layout here, in the frame that first
+     * writes it, rather than in an upload batch that may only be submitted frames later.
+     ***/
+    VkImageMemoryBarrier depthBarrier {};
+    depthBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    depthBarrier.oldLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+    depthBarrier.newLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+    depthBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    depthBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    depthBarrier.image = m_depthImage;
+    depthBarrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+    if (hasStencilComponent(findDepthFormat()))
+    {
+        depthBarrier.subresourceRange.aspectMask |= VK_IMAGE_ASPECT_STENCIL_BIT;
+    }
+    depthBarrier.subresourceRange.baseMipLevel = 0;
+    depthBarrier.subresourceRange.levelCount = 1;
+    depthBarrier.subresourceRange.baseArrayLayer = 0;
+    depthBarrier.subresourceRange.layerCount = 1;
+    depthBarrier.srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    depthBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+    std::vector<VkImageMemoryBarrier> barriers = { depthBarrier };
+    if (!m_depthPyramidReady)
+    {
+        VkImageMemoryBarrier pyramidBarrier {};
+        pyramidBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        pyramidBarrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        pyramidBarrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+        pyramidBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        pyramidBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        pyramidBarrier.image = m_depthPyramid;
+        pyramidBarrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        pyramidBarrier.subresourceRange.baseMipLevel = 0;
+        pyramidBarrier.subresourceRange.levelCount = static_cast<uint32_t>(m_depthPyramidLevelViews.size());
+        pyramidBarrier.subresourceRange.baseArrayLayer = 0;
+        pyramidBarrier.subresourceRange.layerCount = 1;
+        pyramidBarrier.srcAccessMask = 0;
+        pyramidBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+        barriers.push_back(pyramidBarrier);
+    }
+
+    vkCmdPipelineBarrier(
+        commandBuffer, VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr, 0, nullptr, static_cast<uint32_t>(barriers.size()),
+        barriers.data()
+    );
+
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_depthReducePipeline);
+
+    VkImageMemoryBarrier levelBarrier {};
+    levelBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    levelBarrier.oldLayout = VK_IMAGE_LAYOUT_GENERAL;
+    levelBarrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+    levelBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    levelBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    levelBarrier.image = m_depthPyramid;
+    levelBarrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    levelBarrier.subresourceRange.levelCount = 1;
+    levelBarrier.subresourceRange.baseArrayLayer = 0;
+    levelBarrier.subresourceRange.layerCount = 1;
+    levelBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    levelBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+
+    for (uint32_t level = 0; level < m_depthReduceDescriptorSets.size(); ++ level)
+    {
+        uint32_t width = std::max(m_swapchainExtent.width >> level, 1u);
+        uint32_t height = std::max(m_swapchainExtent.height >> level, 1u);
+        uint32_t constants[] = { level, static_cast<uint32_t>(m_msaaSamples) };
+
+        vkCmdBindDescriptorSets(
+            commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_depthReducePipelineLayout, 0, 1,
+            &m_depthReduceDescriptorSets[level], 0, nullptr
+        );
+        vkCmdPushConstants(
+            commandBuffer, m_depthReducePipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(constants), constants
+        );
+        vkCmdDispatch(commandBuffer, (width + 7) / 8, (height + 7) / 8, 1);
+
+        // The next level reads this one, and so does the next frame's culling before its reduction
+        // writes it again.
+        levelBarrier.subresourceRange.baseMipLevel = level;
+        vkCmdPipelineBarrier(
+            commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr,
+            0, nullptr, 1, &levelBarrier
+        );
+    }
+
+    depthBarrier.oldLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+    depthBarrier.newLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+    depthBarrier.srcAccessMask = 0;
+    depthBarrier.dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    vkCmdPipelineBarrier(
+        commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT, 0, 0, nullptr, 0,
+        nullptr, 1, &depthBarrier
+    );
+
+    m_depthPyramidReady = true;
+}
+
+void HelloTriangleApplication::recordDraws(VkCommandBuffer commandBuffer, const UniformBufferObject& ubo,
+    uint32_t uniformOffset, size_t firstObject, size_t objectCount)
+{
+    // Draws objectCount objects from firstObject on, each placed by a push constant transform on top of
+    // the frame's uniform block. Secondary command buffers inherit no state, so everything is bound
+    // here, once. Runs on the recording threads, which only read the model and the scene.
+    if (objectCount == 0) { return; }
+
+    // Bind graphics pipeline.
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_graphicsPipeline);
+
+    // Bind the vertex buffer.
+    VkBuffer vertexBuffers[] = { m_vertexBuffer };
+    VkDeviceSize offsets[] = { 0 };
+    vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
+
+    // Bind the index buffer.
+    vkCmdBindIndexBuffer(commandBuffer, m_indexBuffer, 0, m_indexType);
+
+    // Bind the frame's descriptor sets with the offset of its uniform block.
+    bindDescriptorSets(commandBuffer, uniformOffset);
+
+    // Bindless, the draws select the first texture from the array by its index.
+    PushConstants pushConstants {};
+    if (m_bindlessTextureCount > 0)
+    {
+        pushConstants.textureIndex = 0;
+        vkCmdPushConstants(
+            commandBuffer, m_pipelineLayout, VK_SHADER_STAGE_FRAGMENT_BIT, offsetof(PushConstants, textureIndex),
+            sizeof(pushConstants.textureIndex), &pushConstants.textureIndex
+        );
+    }
+
+    // Draw every object at the level of detail its own distance calls for.
+    for (size_t i = firstObject; i < firstObject + objectCount; ++ i)
+    {
+        const MeshLod& lod = m_lods[selectLod(ubo, m_objectPositions[i])];
+        pushConstants.transform = glm::translate(glm::mat4(1.f), m_objectPositions[i]);
+        vkCmdPushConstants(
+            commandBuffer, m_pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, offsetof(PushConstants, transform),
+            sizeof(pushConstants.transform), &pushConstants.transform
+        );
+        vkCmdDrawIndexed(commandBuffer, lod.indexCount, 1, lod.firstIndex, 0, 0);
+    }
+}
+
+void HelloTriangleApplication::recordIndirectDraws(VkCommandBuffer commandBuffer, const UniformBufferObject& ubo,
+    uint32_t uniformOffset)
+{
+    // Draws every object at its own level of detail, placed by its instance index. Culled, the commands
+    // and their count have been written by the culling. Otherwise the frame writes them into its region
+    // of the command buffer, which was last read by the frame that its fence has signalled for. The
+    // frame's uniform block holds what they all share.
+    uint32_t objectCount = static_cast<uint32_t>(m_objectPositions.size());
+    uint32_t stride = sizeof(VkDrawIndexedIndirectCommand);
+    VkDeviceSize commandOffset = 0;
+    if (!enableGpuCulling)
+    {
+        commandOffset = static_cast<VkDeviceSize>(stride) * objectCount * m_currentFrame;
+        auto commands = reinterpret_cast<VkDrawIndexedIndirectCommand*>(m_drawCommandBufferMemory.data + commandOffset);
+        for (uint32_t i = 0; i < objectCount; ++ i)
+        {
+            const MeshLod& lod = m_lods[selectLod(ubo, m_objectPositions[i])];
+            commands[i].indexCount = lod.indexCount;
+            commands[i].instanceCount = 1;
+            commands[i].firstIndex = lod.firstIndex;
+            commands[i].vertexOffset = 0;
+            commands[i].firstInstance = i;
+        }
+    }
+
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_graphicsPipeline);
+
+    VkBuffer vertexBuffers[] = { m_vertexBuffer };
+    VkDeviceSize offsets[] = { 0 };
+    vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
+    vkCmdBindIndexBuffer(commandBuffer, m_indexBuffer, 0, m_indexType);
+
+    bindDescriptorSets(commandBuffer, uniformOffset);
+
+    if (m_bindlessTextureCount > 0)
+    {
+        uint32_t textureIndex = 0;
+        vkCmdPushConstants(
+            commandBuffer, m_pipelineLayout, VK_SHADER_STAGE_FRAGMENT_BIT, offsetof(PushConstants, textureIndex),
+            sizeof(textureIndex), &textureIndex
+        );
+    }
+
+    // Only the culling counts its commands.
+    if (m_drawIndirectCount)
+    {
+        m_drawIndexedIndirectCount(
+            commandBuffer, m_drawCommandBuffer, commandOffset, m_drawCountBuffer, 0, objectCount, stride
+        );
+        return;
+    }
+
+    // A draw takes at most maxDrawIndirectCount commands, a single one without multiDrawIndirect.
+    for (uint32_t first = 0; first < objectCount; first += m_maxDrawIndirectCount)
+    {
+        vkCmdDrawIndexedIndirect(
+            commandBuffer, m_drawCommandBuffer, commandOffset + static_cast<VkDeviceSize>(first) * stride,
+            std::min(objectCount - first, m_maxDrawIndirectCount), stride
+        );
+    }
+}
+
+void HelloTriangleApplication::recordInstancedDraws(VkCommandBuffer commandBuffer, const UniformBufferObject& ubo,
+    uint32_t uniformOffset)
+{
+    /***
+     * Draws the objects with one instanced draw per level of detail, so that every object is drawn at
+     * the level its own distance calls for. The frame writes the placements into its region of the
+     * instance buffer, grouped by level, and each draw starts at its group's first instance. The region
+     * was last read by the frame that its fence has signalled for, and the memory is coherent, so it
+     * is rewritten in place and bound by its offset.
+     ***/
+    uint32_t objectCount = static_cast<uint32_t>(m_objectPositions.size());
+    std::vector<uint32_t> objectLods(objectCount);
+    std::vector<uint32_t> firstInstances(m_lods.size() + 1, 0);
+    for (uint32_t i = 0; i < objectCount; ++ i)
+    {
+        objectLods[i] = selectLod(ubo, m_objectPositions[i]);
+        ++ firstInstances[objectLods[i] + 1];
+    }
+    for (size_t lod = 1; lod < firstInstances.size(); ++ lod)
+    {
+        firstInstances[lod] += firstInstances[lod - 1];
+    }
+
+    VkDeviceSize instanceOffset = sizeof(InstanceData) * objectCount * m_currentFrame;
+    auto instances = reinterpret_cast<InstanceData*>(m_instanceBufferMemory.data + instanceOffset);
+    std::vector<uint32_t> nextInstances(firstInstances.begin(), firstInstances.end() - 1);
+    for (uint32_t i = 0; i < objectCount; ++ i)
+    {
+        InstanceData& instance = instances[nextInstances[objectLods[i]] ++];
+        instance.positionScale = glm::vec4(m_objectPositions[i], 1.f);
+        instance.rotation = glm::vec4(0.f, 0.f, 0.f, 1.f);
+    }
+
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_graphicsPipeline);
+
+    VkBuffer vertexBuffers[] = { m_vertexBuffer, m_instanceBuffer };
+    VkDeviceSize offsets[] = { 0, instanceOffset };
+    vkCmdBindVertexBuffers(commandBuffer, 0, 2, vertexBuffers, offsets);
+    vkCmdBindIndexBuffer(commandBuffer, m_indexBuffer, 0, m_indexType);
+
+    bindDescriptorSets(commandBuffer, uniformOffset);
+
+    if (m_bindlessTextureCount > 0)
+    {
+        uint32_t textureIndex = 0;
+        vkCmdPushConstants(
+            commandBuffer, m_pipelineLayout, VK_SHADER_STAGE_FRAGMENT_BIT, offsetof(PushConstants, textureIndex),
+            sizeof(textureIndex), &textureIndex
+        );
+    }
+
+    for (size_t i = 0; i < m_lods.size(); ++ i)
+    {
+        uint32_t instanceCount = firstInstances[i + 1] - firstInstances[i];
+        if (instanceCount > 0)
+        {
+            vkCmdDrawIndexed(
+                commandBuffer, m_lods[i].indexCount, instanceCount, m_lods[i].firstIndex, 0, firstInstances[i]
+            );
+        }
+    }
+}
+
+void HelloTriangleApplication::recordModelUpload(VkCommandBuffer commandBuffer, const StagedModel& model)
+{
+    VkBufferCopy copyRegion {};
+    copyRegion.srcOffset = 0;
+    copyRegion.dstOffset = 0;
+
+    copyRegion.size = model.vertices.size;
+    vkCmdCopyBuffer(commandBuffer, model.vertices.buffer, m_vertexBuffer, 1, &copyRegion);
+    copyRegion.size = model.indices.size;
+    vkCmdCopyBuffer(commandBuffer, model.indices.buffer, m_indexBuffer, 1, &copyRegion);
+
+    // Nothing waits for the queue to go idle before the buffers are read, so make the copies visible to
+    // vertex input explicitly.
+    std::vector<VkBufferMemoryBarrier> barriers(2);
+    for (auto& barrier : barriers)
+    {
+        barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.offset = 0;
+        barrier.size = VK_WHOLE_SIZE;
+    }
+    barriers[0].dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT;
+    barriers[0].buffer = m_vertexBuffer;
+    barriers[1].dstAccessMask = VK_ACCESS_INDEX_READ_BIT;
+    barriers[1].buffer = m_indexBuffer;
+
+    // The levels of detail are only staged for the culling, which selects from them.
+    VkPipelineStageFlags dstStage = VK_PIPELINE_STAGE_VERTEX_INPUT_BIT;
+    if (model.lods.buffer != VK_NULL_HANDLE)
+    {
+        copyRegion.size = model.lods.size;
+        vkCmdCopyBuffer(commandBuffer, model.lods.buffer, m_lodBuffer, 1, &copyRegion);
+
+        VkBufferMemoryBarrier barrier = barriers[0];
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        barrier.buffer = m_lodBuffer;
+        barriers.push_back(barrier);
+        dstStage |= VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+    }
+
+    recordUploadBarriers(commandBuffer, dstStage, std::move(barriers), {});
+}
+
+void HelloTriangleApplication::recordTextureUpload(VkCommandBuffer commandBuffer, const StagedTexture& texture)
+{
+    // A staged chain is copied level by level in one command and is then ready for sampling. Only the
+    // staged levels change their layout; the others are not touched and may even be in use.
+    if (!texture.levelOffsets.empty())
+    {
+        uint32_t levelCount = static_cast<uint32_t>(texture.levelOffsets.size());
+        transitionImageLayout(
+            commandBuffer, texture.image, texture.baseLevel, levelCount, texture.format, VK_IMAGE_LAYOUT_UNDEFINED,
+            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL
+        );
+
+        std::vector<VkBufferImageCopy> regions(levelCount);
+        for (uint32_t i = 0; i < levelCount; ++ i)
+        {
+            uint32_t level = texture.baseLevel + i;
+            VkBufferImageCopy& region = regions[i];
+            region.bufferOffset = texture.staging.offset + texture.levelOffsets[i];
+            region.bufferRowLength = 0;
+            region.bufferImageHeight = 0;
+            region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            region.imageSubresource.mipLevel = level;
+            region.imageSubresource.baseArrayLayer = 0;
+            region.imageSubresource.layerCount = 1;
+            region.imageOffset = { 0, 0, 0 };
+            region.imageExtent = { std::max(texture.width >> level, 1u), std::max(texture.height >> level, 1u), 1 };
+        }
+
+        vkCmdCopyBufferToImage(
+            commandBuffer, texture.staging.buffer, texture.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            static_cast<uint32_t>(regions.size()), regions.data()
+        );
+
+        // The transition for sampling may have to move the levels to the graphics queue as well.
+        VkImageMemoryBarrier barrier {};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = texture.image;
+        barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        barrier.subresourceRange.baseMipLevel = texture.baseLevel;
+        barrier.subresourceRange.levelCount = levelCount;
+        barrier.subresourceRange.baseArrayLayer = 0;
+        barrier.subresourceRange.layerCount = 1;
+
+        recordUploadBarriers(commandBuffer, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, {}, { barrier });
+        return;
+    }
+
+    // Otherwise level 0 is copied to the texture image, which involves two steps:
+    // 1. transition the texture image to VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    // 2. execute the buffer to image copy operation.
+    transitionImageLayout(
+        commandBuffer, texture.image, 0, texture.mipLevels, texture.format, VK_IMAGE_LAYOUT_UNDEFINED,
+        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL
+    );
+    copyBufferToImage(
+        commandBuffer, texture.staging.buffer, texture.staging.offset, texture.image, texture.width, texture.height
+    );
+
+    // Blits need the graphics queue, so the image moves there in its transfer layout first.
+    VkImageMemoryBarrier barrier {};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = texture.image;
+    barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    barrier.subresourceRange.baseMipLevel = 0;
+    barrier.subresourceRange.levelCount = texture.mipLevels;
+    barrier.subresourceRange.baseArrayLayer = 0;
+    barrier.subresourceRange.layerCount = 1;
+
+    recordUploadBarriers(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, {}, { barrier });
+
+    // Generate mipmaps (and also transition the image layout to VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL.
+    generateMipmaps(
+        m_openUpload.graphicsCommandBuffer, texture.image, VK_FORMAT_R8G8B8A8_SRGB,
+        static_cast<int32_t>(texture.width), static_cast<int32_t>(texture.height), texture.mipLevels
+    );
+}
+
+void HelloTriangleApplication::recordUploadBarriers(VkCommandBuffer commandBuffer, VkPipelineStageFlags dstStage,
+    std::vector<VkBufferMemoryBarrier> bufferBarriers, std::vector<VkImageMemoryBarrier> imageBarriers)
+{
+    /***
+     * Makes the transfer writes of an upload visible to dstStage on the graphics queue. On the graphics
+     * queue itself, the barriers are recorded as they are. With a transfer queue, they move the
+     * resources between the queue families instead: commandBuffer releases them, and the open batch's
+     * graphics command buffer acquires them with the same layout transitions. The release only makes
+     * the writes available and the acquire only makes them visible, the semaphore between the two
+     * submissions orders them.
+     ***/
+    auto uint32Size = [](const auto& vector) { return static_cast<uint32_t>(vector.size()); };
+    if (commandBuffer == m_openUpload.graphicsCommandBuffer)
+    {
+        vkCmdPipelineBarrier(
+            commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, dstStage, 0, 0, nullptr, uint32Size(bufferBarriers),
+            bufferBarriers.data(), uint32Size(imageBarriers), imageBarriers.data()
+        );
+        return;
+    }
+
+    uint32_t transferFamily = m_queueFamilyIndices.transferFamily.value();
+    uint32_t graphicsFamily = m_queueFamilyIndices.graphicsFamily.value();
+    std::vector<VkBufferMemoryBarrier> acquireBufferBarriers = bufferBarriers;
+    std::vector<VkImageMemoryBarrier> acquireImageBarriers = imageBarriers;
+    for (size_t i = 0; i < bufferBarriers.size(); ++ i)
+    {
+        bufferBarriers[i].srcQueueFamilyIndex = acquireBufferBarriers[i].srcQueueFamilyIndex = transferFamily;
+        bufferBarriers[i].dstQueueFamilyIndex = acquireBufferBarriers[i].dstQueueFamilyIndex = graphicsFamily;
+        bufferBarriers[i].dstAccessMask = 0;
+        acquireBufferBarriers[i].srcAccessMask = 0;
+    }
+    for (size_t i = 0; i < imageBarriers.size(); ++ i)
+    {
+        imageBarriers[i].srcQueueFamilyIndex = acquireImageBarriers[i].srcQueueFamilyIndex = transferFamily;
+        imageBarriers[i].dstQueueFamilyIndex = acquireImageBarriers[i].dstQueueFamilyIndex = graphicsFamily;
+        imageBarriers[i].dstAccessMask = 0;
+        acquireImageBarriers[i].srcAccessMask = 0;
+    }
+
+    vkCmdPipelineBarrier(
+        commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr,
+        uint32Size(bufferBarriers), bufferBarriers.data(), uint32Size(imageBarriers), imageBarriers.data()
+    );
+    vkCmdPipelineBarrier(
+        m_openUpload.graphicsCommandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, dstStage, 0, 0, nullptr,
+        uint32Size(acquireBufferBarriers), acquireBufferBarriers.data(), uint32Size(acquireImageBarriers),
+        acquireImageBarriers.data()
+    );
+}
+
+void HelloTriangleApplication::releaseStagingBuffer(const StagingBuffer& staging)
+{
+    // Ranges of the staging region go back to the ring; buffers of their own are destroyed.
+    if (staging.allocation.memory == VK_NULL_HANDLE)
+    {
+        if (staging.buffer != VK_NULL_HANDLE)
+        {
+            m_stagingRing.release(staging.offset);
+        }
+        return;
+    }
+
+    vkDestroyBuffer(m_device, staging.buffer, nullptr);
+    m_allocator.free(staging.allocation);
+}
+
+void HelloTriangleApplication::replaceTextureView(Texture& texture)
+{
+    // Points the texture's view at its resident levels. The old view stays alive until no descriptor
+    // set refers to it any more, see drawFrame().
+    Texture retired {};
+    retired.view = texture.view;
+    m_retiredTextures.push_back(retired);
+
+    texture.view = createImageView(
+        texture.image, texture.residentLevel - texture.firstLevel, texture.mipLevels - texture.residentLevel,
+        texture.format, VK_IMAGE_ASPECT_COLOR_BIT
+    );
+    m_descriptorSetsDirty.assign(m_descriptorSetsDirty.size(), true);
+}
+
+uint32_t HelloTriangleApplication::selectLod(const UniformBufferObject& ubo, const glm::vec3& position) const
+{
+    // Level of detail of the object at position, from the same matrices it is rendered with. Only reads
+    // the model and the scene, so the recording threads may call it.
+    return MeshSimplifier::selectLod(
+        m_lods, m_boundingSphere, ubo.view * glm::translate(glm::mat4(1.f), position) * ubo.model, ubo.proj,
+        static_cast<float>(m_swapchainExtent.height), LOD_PIXEL_ERROR
+    );
+}
+
 void HelloTriangleApplication::selectPhysicalDevice()
 {
     // List all physical devices.
@@ -2117,3 +4535,267 @@ void HelloTriangleApplication::selectPhysicalDevice()
         throw std::runtime_error("failed to find a suitable GPU");
     }
 }
+
+void HelloTriangleApplication::setBoundingSphere(const glm::vec3& boundsMin, const glm::vec3& boundsMax)
+{
+    // The sphere around the bounding box is looser than a fitted one but needs no vertex data,
+    // which keeps it available on a mesh cache hit.
+    m_boundingSphere = glm::vec4((boundsMin + boundsMax) * .5f, glm::length(boundsMax - boundsMin) * .5f);
+}
+
+HelloTriangleApplication::StagingBuffer HelloTriangleApplication::stageIndexBuffer()
+{
+    // Fills a staging buffer and creates m_indexBuffer; the copy between them is left to the caller.
+    // Without primitive restart every 16-bit value is a valid index, so 16 bits suffice for up to
+    // 65536 vertices and halve the index buffer and its fetch bandwidth.
+    size_t vertexCount = m_meshCache.isOpen() ? m_meshCache.vertexCount() : m_vertices.size();
+    m_indexType = vertexCount <= 0x10000 ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
+    size_t indexSize = m_indexType == VK_INDEX_TYPE_UINT16 ? sizeof(uint16_t) : sizeof(uint32_t);
+
+    // Create staging buffer (visible on CPU).
+    VkDeviceSize bufferSize = indexSize * static_cast<VkDeviceSize>(m_indexCount);
+    VkBuffer stagingBuffer;
+    DeviceAllocation stagingBufferMemory;
+    createBuffer(
+        bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, MemoryUsage::Upload, stagingBuffer, stagingBufferMemory
+    );
+
+    // The staging buffer memory stays mapped into CPU accessible memory.
+    void* data = stagingBufferMemory.data;
+
+    // Copy the indices to the (mapped) buffer memory. They either come from the freshly parsed model
+    // or are decoded from the mesh cache straight into the mapped memory.
+    bool indicesValid = true;
+    if (m_meshCache.isOpen())
+    {
+        indicesValid = m_indexType == VK_INDEX_TYPE_UINT16 ?
+            m_meshCache.readIndices(static_cast<uint16_t*>(data)) : m_meshCache.readIndices(static_cast<uint32_t*>(data));
+    }
+    else if (m_indexType == VK_INDEX_TYPE_UINT16)
+    {
+        auto indices = static_cast<uint16_t*>(data);
+        for (uint32_t i = 0; i < m_indexCount; ++ i)
+        {
+            indices[i] = static_cast<uint16_t>(m_indices[i]);
+        }
+    }
+    else
+    {
+        memcpy(data, m_indices.data(), static_cast<size_t>(bufferSize));
+    }
+
+    if (!indicesValid)
+    {
+        vkDestroyBuffer(m_device, stagingBuffer, nullptr);
+        m_allocator.free(stagingBufferMemory);
+        throw std::runtime_error("failed to decode indices from mesh cache " + MODEL_CACHE_DIR);
+    }
+
+    // Create destination buffer (not visible on CPU).
+    createBuffer(
+        bufferSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+        MemoryUsage::GpuOnly, m_indexBuffer, m_indexBufferMemory
+    );
+
+    StagingBuffer staging {};
+    staging.buffer = stagingBuffer;
+    staging.allocation = stagingBufferMemory;
+    staging.size = bufferSize;
+    return staging;
+}
+
+HelloTriangleApplication::StagedTexture HelloTriangleApplication::stageKtx2Texture(
+    std::shared_ptr<const Ktx2File> file, uint32_t firstLevel, uint32_t baseLevel, bool wait)
+{
+    // Creates an image for the levels of the precompressed chain from firstLevel down and stages those
+    // from baseLevel down; no level is generated on the GPU. Without wait, an empty texture is returned
+    // if the staging region has no room.
+    StagedTexture texture {};
+    texture.format = static_cast<VkFormat>(file->vkFormat());
+    texture.width = std::max(file->width() >> firstLevel, 1u);
+    texture.height = std::max(file->height() >> firstLevel, 1u);
+    texture.mipLevels = file->levelCount() - firstLevel;
+    texture.baseLevel = baseLevel - firstLevel;
+
+    // Buffer to image copies need offsets that are multiples of the block size; the staging range
+    // itself starts at a multiple of 16, which every supported block size divides.
+    VkDeviceSize blockSize = Ktx2File::getBlockSize(file->vkFormat());
+    VkDeviceSize stagingSize = 0;
+    for (uint32_t level = baseLevel; level < file->levelCount(); ++ level)
+    {
+        stagingSize = (stagingSize + blockSize - 1) / blockSize * blockSize;
+        texture.levelOffsets.push_back(stagingSize);
+        stagingSize += file->levelSize(level);
+    }
+
+    if (wait)
+    {
+        texture.staging = allocateStagingBuffer(stagingSize, 16);
+    }
+    else if (!tryAllocateStagingBuffer(stagingSize, 16, texture.staging))
+    {
+        return StagedTexture {};
+    }
+
+    for (uint32_t level = baseLevel; level < file->levelCount(); ++ level)
+    {
+        memcpy(texture.staging.data + texture.levelOffsets[level - baseLevel], file->levelData(level),
+            static_cast<size_t>(file->levelSize(level)));
+    }
+
+    createImage(
+        texture.width, texture.height, texture.mipLevels, VK_SAMPLE_COUNT_1_BIT, texture.format,
+        VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+        MemoryUsage::GpuOnly, texture.image, texture.imageMemory
+    );
+
+    // The chain is kept to stream the remaining levels from, or to go back to after an eviction.
+    texture.source = std::move(file);
+    return texture;
+}
+
+HelloTriangleApplication::StagingBuffer HelloTriangleApplication::stageLodBuffer()
+{
+    // Fills a staging buffer and creates m_lodBuffer, from which the culling selects the level of detail
+    // of every object; the copy between them is left to the caller. Without culling, the levels are
+    // selected on the CPU and nothing is staged.
+    if (!enableGpuCulling) { return StagingBuffer {}; }
+
+    // Create staging buffer (visible on CPU).
+    VkDeviceSize bufferSize = sizeof(MeshLod) * m_lods.size();
+    VkBuffer stagingBuffer;
+    DeviceAllocation stagingBufferMemory;
+    createBuffer(
+        bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, MemoryUsage::Upload, stagingBuffer, stagingBufferMemory
+    );
+    memcpy(stagingBufferMemory.data, m_lods.data(), static_cast<size_t>(bufferSize));
+
+    // Create destination buffer (not visible on CPU).
+    createBuffer(
+        bufferSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, MemoryUsage::GpuOnly,
+        m_lodBuffer, m_lodBufferMemory
+    );
+
+    StagingBuffer staging {};
+    staging.buffer = stagingBuffer;
+    staging.allocation = stagingBufferMemory;
+    staging.size = bufferSize;
+    return staging;
+}
+
+HelloTriangleApplication::StagedTexture HelloTriangleApplication::stageTextureImage(uint32_t width, uint32_t height)
+{
+    // Reserves mapped staging memory for the RGBA8 pixels, which the caller writes into, and creates
+    // the texture image; recordTextureUpload() copies between them. May run on a worker thread.
+    StagedTexture texture {};
+    texture.width = width;
+    texture.height = height;
+    texture.mipLevels = static_cast<uint32_t>(std::floor(std::log2(std::max(width, height)))) + 1;
+    texture.staging = allocateStagingBuffer(static_cast<VkDeviceSize>(width) * static_cast<VkDeviceSize>(height) * 4, 16);
+
+    // Create texture image object on GPU and bind with its allocated memory.
+    createImage(
+        width, height, texture.mipLevels, VK_SAMPLE_COUNT_1_BIT, VK_FORMAT_R8G8B8A8_SRGB,
+        VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT |
+        VK_IMAGE_USAGE_SAMPLED_BIT, MemoryUsage::GpuOnly, texture.image, texture.imageMemory
+    );
+
+    return texture;
+}
+
+HelloTriangleApplication::StagingBuffer HelloTriangleApplication::stageVertexBuffer()
+{
+    // Fills a staging buffer and creates m_vertexBuffer; the copy between them is left to the caller.
+    // The vertices either come straight from the mapped mesh cache or from the freshly parsed model.
+    auto vertices = m_meshCache.isOpen() ? static_cast<const Vertex*>(m_meshCache.vertexData()) : m_vertices.data();
+    size_t vertexCount = m_meshCache.isOpen() ? m_meshCache.vertexCount() : m_vertices.size();
+
+    // Create staging buffer (visible on CPU).
+    VkDeviceSize bufferSize = static_cast<VkDeviceSize>(VertexPacker::getStride(VERTEX_LAYOUT)) * vertexCount;
+    VkBuffer stagingBuffer;
+    DeviceAllocation stagingBufferMemory;
+    createBuffer(
+        bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, MemoryUsage::Upload, stagingBuffer, stagingBufferMemory
+    );
+
+    // The staging buffer memory stays mapped into CPU accessible memory.
+    void* data = stagingBufferMemory.data;
+
+    // Copy the vertices to the (mapped) buffer memory, packing them into the selected layout.
+    QuantizationError error {};
+    m_vertexDecode = VertexPacker::pack(VERTEX_LAYOUT, vertices, vertexCount, data, &error);
+    if (VERTEX_LAYOUT != VertexLayout::Float)
+    {
+        std::cout << "vertex packing: " << sizeof(Vertex) << " -> " << VertexPacker::getStride(VERTEX_LAYOUT)
+                  << " bytes per vertex, position error max " << error.maxPositionError
+                  << " mean " << error.meanPositionError << ", texture coordinate error max "
+                  << error.maxTextureCoordError << " mean " << error.meanTextureCoordError << std::endl;
+    }
+
+    // Create destination buffer (not visible on CPU).
+    createBuffer(
+        bufferSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+        MemoryUsage::GpuOnly, m_vertexBuffer, m_vertexBufferMemory
+    );
+
+    StagingBuffer staging {};
+    staging.buffer = stagingBuffer;
+    staging.allocation = stagingBufferMemory;
+    staging.size = bufferSize;
+    return staging;
+}
+
+bool HelloTriangleApplication::streamTextureLevel(size_t index, TextureStreamingBatch& batch)
+{
+    // Uploads the next finer level into the texture's image. Frames go on sampling the coarser levels
+    // meanwhile, as the view only takes the new level in once its upload has completed. False if the
+    // staging region has no room this frame.
+    Texture& texture = m_textures[index];
+    const Ktx2File& file = *texture.source;
+    uint32_t level = texture.residentLevel - 1;
+
+    StagedTexture staged {};
+    if (!tryAllocateStagingBuffer(file.levelSize(level), 16, staged.staging)) { return false; }
+    memcpy(staged.staging.data, file.levelData(level), static_cast<size_t>(file.levelSize(level)));
+
+    staged.image = texture.image;
+    staged.format = texture.format;
+    staged.width = std::max(file.width() >> texture.firstLevel, 1u);
+    staged.height = std::max(file.height() >> texture.firstLevel, 1u);
+    staged.mipLevels = texture.mipLevels - texture.firstLevel;
+    staged.baseLevel = level - texture.firstLevel;
+    staged.levelOffsets.push_back(0);
+    texture.streaming = true;
+
+    batch.records.push_back([this, staged](VkCommandBuffer commandBuffer) {
+        recordTextureUpload(commandBuffer, staged);
+    });
+    batch.stagingBuffers.push_back(staged.staging);
+    batch.swapIns.push_back([this, index, level]() {
+        Texture& texture = m_textures[index];
+        texture.residentLevel = level;
+        texture.streaming = false;
+        replaceTextureView(texture);
+    });
+    return true;
+}
+
+bool HelloTriangleApplication::tryAllocateStagingBuffer(VkDeviceSize size, VkDeviceSize alignment,
+    StagingBuffer& staging)
+{
+    // Like allocateStagingBuffer(), but for the main thread: it releases the ranges itself and so must
+    // not wait for them. False if the staging region has no room at the moment.
+    if (size > m_stagingRing.capacity())
+    {
+        staging = allocateStagingBuffer(size, alignment);
+        return true;
+    }
+
+    staging = StagingBuffer {};
+    staging.size = size;
+    if (!m_stagingRing.tryAllocate(size, alignment, staging.offset)) { return false; }
+
+    staging.buffer = m_stagingRegion.buffer;
+    staging.data = m_stagingRegion.data + staging.offset;
+    return true;
+}
@@ -5,13 +5,32 @@
 
 #include <glm/glm.hpp>
 
-#define GLM_ENABLE_EXPERIMENTAL
-#include <glm/gtx/hash.hpp>
+#include "DeviceAllocator.h"
+#include "Ktx2File.h"
+#include "MeshCache.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+#include "Meshlet.h"
+#include "MipGenerator.h"
+#include "ObjLoader.h"
+#include "ObjectCuller.h"
+#include "PackedVertex.h"
+#include "StagingRing.h"
+#include "TextureCompressor.h"
+#include "TextureDecoder.h"
+#include "ThreadPool.h"
+#include "UniformRing.h"
+#include "Vertex.h"
 
 #include <array>
+#include <chrono>
 #include <cstdlib>
 #include <cstring>
+#include <functional>
+#include <future>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <stdexcept>
 #include <vector>
@@ -25,68 +44,31 @@ const bool enableValidationLayers = true;
 /* ************************************************************************************************
  * Global Structs
  * ************************************************************************************************/
-struct Vertex
+// Per-frame values, one block per frame in the uniform ring. The model transform is the one every
+// object shares; each is then placed by a transform of its own.
+struct UniformBufferObject
 {
-    glm::vec3 pos;
-    glm::vec3 color;
-    glm::vec2 textureCoord;
-
-    bool operator==(const Vertex& other) const
-    {
-        return pos == other.pos && color == other.color && textureCoord == other.textureCoord;
-    }
-
-    static VkVertexInputBindingDescription getBindingDescription()
-    {
-        VkVertexInputBindingDescription bindingDescription {};
-        bindingDescription.binding = 0;
-        bindingDescription.stride = sizeof(Vertex);
-        bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
-
-        return bindingDescription;
-    }
-
-    static std::array<VkVertexInputAttributeDescription, 3> getAttributeDescriptions()
-    {
-        // Return two attribute description structs, one for position and one for color.
-        std::array<VkVertexInputAttributeDescription, 3> attributeDescriptions {};
-        // Read position attributes.
-        attributeDescriptions[0].binding = 0;
-        attributeDescriptions[0].location = 0;
-        attributeDescriptions[0].format = VK_FORMAT_R32G32B32_SFLOAT;
-        attributeDescriptions[0].offset = offsetof(Vertex, pos);
-        // Read color attributes.
-        attributeDescriptions[1].binding = 0;
-        attributeDescriptions[1].location = 1;
-        attributeDescriptions[1].format = VK_FORMAT_R32G32B32_SFLOAT;
-        attributeDescriptions[1].offset = offsetof(Vertex, color);
-        // Read texture coordinate attributes.
-        attributeDescriptions[2].binding = 0;
-        attributeDescriptions[2].location = 2;
-        attributeDescriptions[2].format = VK_FORMAT_R32G32_SFLOAT;
-        attributeDescriptions[2].offset = offsetof(Vertex, textureCoord);
-
-        return attributeDescriptions;
-    }
+    alignas(16) glm::mat4 model;
+    alignas(16) glm::mat4 view;
+    alignas(16) glm::mat4 proj;
+    // Vertex decode, only read by shader_packed.vert.
+    alignas(16) glm::vec4 positionScale;
+    alignas(16) glm::vec4 positionOffset;
+    alignas(16) glm::vec4 textureCoordTransform;
 };
 
-namespace std
+// Per-object values of shader_indirect.vert, read from a storage buffer by instance index.
+struct ObjectData
 {
-template<> struct hash<Vertex>
-{
-    size_t operator()(Vertex const& vertex) const
-    {
-        return ((hash<glm::vec3>()(vertex.pos) ^ (hash<glm::vec3>()(vertex.color) << 1)) >> 1) ^
-            (hash<glm::vec2>()(vertex.textureCoord) << 1);
-    }
+    alignas(16) glm::mat4 transform;
 };
-}
 
-struct UniformBufferObject
+// Per-draw values: the object's transform for shader.vert and shader_packed.vert, and the texture
+// index for shader_bindless.frag, which sees only the latter.
+struct PushConstants
 {
-    alignas(16) glm::mat4 model;
-    alignas(16) glm::mat4 view;
-    alignas(16) glm::mat4 proj;
+    alignas(16) glm::mat4 transform;
+    uint32_t textureIndex;
 };
 
 /* ************************************************************************************************
@@ -96,8 +78,90 @@ const uint32_t WIDTH = 800;
 const uint32_t HEIGHT = 600;
 
 const std::string MODEL_DIR = "models/viking_room.obj";
+const std::string MODEL_CACHE_DIR = "models/viking_room.meshcache";
 const std::string TEXTURE_DIR = "textures/viking_room.png";
 
+// Block compression of textures that have no KTX2 file next to them yet. They are encoded once,
+// written out as KTX2 and uploaded from that on later runs; None keeps uncompressed RGBA8.
+const TextureCompression TEXTURE_COMPRESSION = TextureCompression::Bc7;
+// Build uncompressed mip chains on the CPU and cache them as KTX2 as well, instead of blitting them
+// on the GPU on every run. Formats the GPU cannot filter linearly take this path regardless.
+const bool enableCpuMipmaps = true;
+// Size of the persistently mapped staging region that texture jobs write into. A texture larger than
+// this gets a staging buffer of its own; otherwise jobs wait for space while the region is full.
+const VkDeviceSize TEXTURE_STAGING_SIZE = 64 * 1024 * 1024;
+// Size of the blocks of device memory that buffers and images are sub-allocated from. Resources
+// larger than half a block get an allocation of their own.
+const VkDeviceSize DEVICE_MEMORY_BLOCK_SIZE = 64 * 1024 * 1024;
+// Uniform data one frame may write into the uniform ring. A frame takes a single block, which the
+// largest offset alignment rounds up to 256 bytes. The ring holds this much for every frame in flight.
+const VkDeviceSize UNIFORM_FRAME_SIZE = 64 * 1024;
+// Bind all textures at once as one partially bound array, which draws pick from by a push constant
+// index, instead of a descriptor set per texture. Needs descriptor indexing, which is core in Vulkan
+// 1.2, and shaders/frag_bindless.spv, built by compile.bat. The array is capped by the device limits.
+const bool enableBindlessTextures = false;
+const uint32_t MAX_BINDLESS_TEXTURES = 4096;
+
+// Reorder the loaded model for the post-transform vertex cache, overdraw and vertex fetch locality.
+const bool enableMeshOptimization = true;
+// Vertex buffer layout. The packed layouts need shaders/vert_packed.spv, built by compile.bat.
+const VertexLayout VERTEX_LAYOUT = VertexLayout::Float;
+
+// Split the loaded model into meshlets with culling bounds.
+const bool enableMeshlets = true;
+
+// Copies of the model drawn on a grid, each placed by a push constant of its own unless they are drawn
+// indirectly or instanced. A single object sits at the origin.
+const uint32_t SCENE_OBJECT_COUNT = 1;
+const float SCENE_OBJECT_SPACING = 2.5f;
+// Record the draws on worker threads into secondary command buffers, which the frame's primary one
+// executes inside the render pass. Each thread takes at least this many draws, fewer are recorded
+// inline.
+const bool enableParallelRecording = true;
+const uint32_t MIN_DRAWS_PER_RECORDING_THREAD = 256;
+// Draw the scene from commands in a buffer, one per object for the level of detail it needs, with a
+// single indirect draw per frame instead of a draw and a push constant per object. The transforms are
+// read from a storage buffer by instance index. Without GPU culling, every frame writes its commands
+// into a host visible region of its own; with it, the culling writes them, and the draw count is read
+// from a buffer as well where the device supports drawIndirectCount. Needs shaders/vert_indirect.spv,
+// built by compile.bat.
+const bool enableIndirectDraw = false;
+// Cull the objects on the GPU ahead of the indirect draws. A compute pass tests them against the view
+// frustum and against a depth pyramid built from the previous frame's depth buffer, selects the level
+// of detail of the survivors and compacts them into the draw commands. What it culled is read back, checked against the same frustum
+// test on the CPU and reported on exit. Needs shaders/cull.spv and shaders/depth_reduce*.spv, built by
+// compile.bat.
+const bool enableGpuCulling = false;
+static_assert(!enableGpuCulling || enableIndirectDraw, "GPU culling writes the indirect draw commands");
+// Draw the scene with an instanced draw per level of detail instead of a draw per object. A second vertex
+// binding, advanced per instance, reads the objects' placements from a persistently mapped buffer that
+// every frame rewrites its own region of. Needs shaders/vert_instanced.spv, built by compile.bat.
+// --bench-instancing draws the scene both ways whatever this is set to.
+const bool enableInstancing = false;
+static_assert(!enableInstancing || !enableIndirectDraw, "instanced and indirect draws are separate paths");
+
+// Generate levels of detail and pick one per object and frame by its projected error.
+const bool enableLods = true;
+const uint32_t MAX_LOD_COUNT = 5;
+// Largest error a level may have, relative to the model's bounding box diagonal.
+const float LOD_ERROR_LIMIT = .02f;
+// A level is used while its error projects to fewer pixels than this.
+const float LOD_PIXEL_ERROR = 1.f;
+
+// Stream the texture and the model in on worker threads. Until their uploads have finished, frames
+// are drawn with a placeholder texture and without the model, so the first frame is not held back.
+const bool enableAssetStreaming = true;
+// While streaming, textures with a KTX2 mip chain are uploaded from their mip tail, the levels up to
+// this many texels across, and the finer levels follow coarsest first, one per texture and frame.
+const uint32_t MIP_TAIL_SIZE = 128;
+// Device memory the textures may take. Beyond it, the least recently drawn textures are shrunk to
+// their mip tail, and they only grow back while there is room for their whole chain.
+const VkDeviceSize TEXTURE_MEMORY_BUDGET = 256 * 1024 * 1024;
+// Copy uploads on a transfer-only queue where the device has one, so that they run alongside the
+// frames instead of in between them on the graphics queue. Ownership of the uploaded resources is
+// then handed over to the graphics queue before frames use them.
+const bool enableTransferQueue = true;
+
 /* ************************************************************************************************
  * Global Variables
  * ************************************************************************************************/
@@ -118,6 +182,11 @@ VkResult CreateDebugUtilsMessengerEXT(VkInstance instance, const VkDebugUtilsMes
 void DestroyDebugUtilsMessengerEXT(VkInstance instance, VkDebugUtilsMessengerEXT debugMessenger,
     const VkAllocationCallbacks* pAllocator);
 
+// Scene transformations, shared by the renderer and the CPU-side mesh analysis.
+glm::mat4 getModelTransform(float seconds);
+glm::mat4 getProjTransform(float aspectRatio);
+glm::mat4 getViewTransform();
+
 /*! ***********************************************************************************************
  * \class   HelloTriangleApplication
  * \author  Leon Vincii
@@ -135,6 +204,13 @@ public:
      * Public Functions
      * ********************************************************************************************/
     void run();
+    // Draws the scene with each of objectCounts objects in turn instead of SCENE_OBJECT_COUNT, frameCount
+    // frames each, and reports what recording a frame takes on the CPU. With sweepThreads, every count
+    // is drawn with one recording thread up to as many as the pool has, doubling in between.
+    // With compareInstancing, every count is drawn with a draw per object and then instanced, unless
+    // the draws are indirect. The GPU time of the frames is reported as well where it can be measured.
+    void runSceneBenchmark(const std::vector<uint32_t>& objectCounts, bool sweepThreads, bool compareInstancing,
+        uint32_t frameCount);
 
 private:
     /* ********************************************************************************************
@@ -144,6 +220,8 @@ private:
     {
         std::optional<uint32_t> graphicsFamily;
         std::optional<uint32_t> presentFamily;
+        // A family with transfer but neither graphics nor compute support, usually DMA engines. Optional.
+        std::optional<uint32_t> transferFamily;
 
         bool isComplete()
         {
@@ -151,6 +229,44 @@ private:
         }
     };
 
+    // The command buffers of one frame in flight. Every recording thread has a pool of its own, so that
+    // no two threads ever record from the same one. Once the frame's fence has signalled, the pools
+    // are reset as a whole instead of buffer by buffer.
+    struct FrameCommands
+    {
+        VkCommandPool                   commandPool = VK_NULL_HANDLE;
+        VkCommandBuffer                 commandBuffer = VK_NULL_HANDLE;
+        std::vector<VkCommandPool>      secondaryCommandPools;
+        std::vector<VkCommandBuffer>    secondaryCommandBuffers;
+        // Set once timestamps around the commands have been recorded, see m_timestampQueryPool.
+        bool                            timestamped = false;
+    };
+
+    // The culling resources of one frame in flight. Once the frame's fence has signalled, the counters
+    // of its last culling are read back and checked against the constants it was culled with.
+    struct FrameCulling
+    {
+        VkBuffer                        counterBuffer = VK_NULL_HANDLE;
+        DeviceAllocation                counterBufferMemory;
+        VkDescriptorSet                 descriptorSet = VK_NULL_HANDLE;
+        bool                            descriptorSetDirty = true;
+        bool                            pending = false;
+        CullingConstants                constants {};
+    };
+
+    // Totals over the culled frames, reported on exit. A frame mismatches if the GPU has culled a
+    // different number of objects by the frustum than the CPU does.
+    struct CullingStats
+    {
+        uint64_t                        frameCount = 0;
+        uint64_t                        objectCount = 0;
+        uint64_t                        frustumCulled = 0;
+        uint64_t                        occlusionCulled = 0;
+        uint64_t                        drawn = 0;
+        uint64_t                        mismatchCount = 0;
+        uint32_t                        largestMismatch = 0;
+    };
+
     struct SwapchainSupportDetails
     {
         VkSurfaceCapabilitiesKHR        capabilities {};
@@ -158,6 +274,121 @@ private:
         std::vector<VkPresentModeKHR>   presentModes;
     };
 
+    // Either a buffer of its own or, with allocation left null, a range of m_stagingRegion. data is set
+    // if the buffer is mapped.
+    struct StagingBuffer
+    {
+        VkBuffer                        buffer = VK_NULL_HANDLE;
+        DeviceAllocation                allocation;
+        VkDeviceSize                    offset = 0;
+        VkDeviceSize                    size = 0;
+        uint8_t*                        data = nullptr;
+    };
+
+    // A texture whose pixels sit in a staging buffer and whose image exists but is not filled yet.
+    struct StagedTexture
+    {
+        StagingBuffer                   staging;
+        VkImage                         image = VK_NULL_HANDLE;
+        DeviceAllocation                imageMemory;
+        VkFormat                        format = VK_FORMAT_R8G8B8A8_SRGB;
+        uint32_t                        width = 0;
+        uint32_t                        height = 0;
+        uint32_t                        mipLevels = 0;
+        // Offset within staging of every level from baseLevel down if the chain is staged; empty if only
+        // level 0 is and the rest is blitted on the GPU. Levels above baseLevel are left unfilled.
+        uint32_t                        baseLevel = 0;
+        std::vector<VkDeviceSize>       levelOffsets;
+        // The whole chain, kept for streaming in the levels that are not staged or evicted later. Null
+        // for textures that are only ever uploaded whole.
+        std::shared_ptr<const Ktx2File> source;
+    };
+
+    // A texture that frames sample. Its image holds the levels of the whole chain from firstLevel down,
+    // of which those from residentLevel down have been uploaded. The view only covers the uploaded
+    // ones, which clamps sampling to the finest level loaded so far.
+    struct Texture
+    {
+        std::shared_ptr<const Ktx2File> source;
+        VkImage                         image = VK_NULL_HANDLE;
+        DeviceAllocation                imageMemory;
+        VkImageView                     view = VK_NULL_HANDLE;
+        VkFormat                        format = VK_FORMAT_R8G8B8A8_SRGB;
+        // Level counts and indices refer to the whole chain, not to the image.
+        uint32_t                        mipLevels = 0;
+        uint32_t                        firstLevel = 0;
+        uint32_t                        residentLevel = 0;
+        uint32_t                        tailLevel = 0;
+        VkDeviceSize                    memorySize = 0;
+        VkDeviceSize                    fullMemorySize = 0;
+        uint64_t                        lastUsedFrame = 0;
+        // Set while an upload into the texture is in flight; it is left alone until that completes.
+        bool                            streaming = false;
+    };
+
+    // The texture streaming work of one frame, which goes into a single submission.
+    struct TextureStreamingBatch
+    {
+        std::vector<std::function<void(VkCommandBuffer)>> records;
+        std::vector<StagingBuffer>      stagingBuffers;
+        std::vector<std::function<void()>> swapIns;
+    };
+
+    // The staged model; its device local buffers are m_vertexBuffer and m_indexBuffer.
+    struct StagedModel
+    {
+        StagingBuffer                   vertices;
+        StagingBuffer                   indices;
+        // Only staged for GPU culling: the levels of detail, which the culling selects from per object.
+        StagingBuffer                   lods;
+    };
+
+    // A texture file being loaded on m_textureThreadPool; onUploaded() runs once its upload has
+    // completed, on the main thread.
+    struct TextureLoad
+    {
+        std::string                     filename;
+        std::future<StagedTexture>      future;
+        std::function<void(const StagedTexture&)> onUploaded;
+    };
+
+    // Totals over the textures loaded since the loader was last idle, reported once it is idle again.
+    struct TextureLoadStats
+    {
+        size_t                          textureCount = 0;
+        uint64_t                        texelCount = 0;
+        VkDeviceSize                    stagedBytes = 0;
+        size_t                          batchCount = 0;
+        double                          uploadSeconds = 0.0;
+        std::chrono::high_resolution_clock::time_point startTime;
+        std::chrono::high_resolution_clock::time_point lastDecodeTime;
+    };
+
+    // Uploads recorded into one command buffer, which is submitted once with a fence. Once the fence
+    // has signalled, the staging buffers are released and the swap-ins make the uploaded resources
+    // visible to the following frames. With a transfer queue, commandBuffer runs on it and releases the
+    // resources, and graphicsCommandBuffer acquires them on the graphics queue after semaphore; it is
+    // only submitted once the transfer has completed, so that the graphics queue never waits for it.
+    // Without, both are the same command buffer on the graphics queue.
+    struct UploadBatch
+    {
+        VkCommandBuffer                 commandBuffer = VK_NULL_HANDLE;
+        VkCommandBuffer                 graphicsCommandBuffer = VK_NULL_HANDLE;
+        VkSemaphore                     semaphore = VK_NULL_HANDLE;
+        VkFence                         fence = VK_NULL_HANDLE;
+        bool                            acquired = false;
+        std::vector<StagingBuffer>      stagingBuffers;
+        std::vector<std::function<void()>> swapIns;
+    };
+
+    // Totals over the uploads, of which those before the first frame are reported.
+    struct UploadStats
+    {
+        size_t                          uploadCount = 0;
+        size_t                          submitCount = 0;
+        size_t                          waitCount = 0;
+    };
+
     /* ********************************************************************************************
      * Private Functions
      * ********************************************************************************************/
@@ -165,6 +396,8 @@ private:
     void createColorResources();
     void createCommandBuffers();
     void createCommandPools();
+    void createCullingResources();
+    void createDepthPyramid();
     void createDepthResources();
     void createDescriptorSetlayout();
     void createDescriptorSets();
@@ -172,31 +405,49 @@ private:
     void createFramebuffers();
     void createGraphicsPipeline();
     void createImageViews();
-    void createIndexBuffer();
     void createInstance();
     void createLogicalDevice();
+    void createModelBuffers();
+    void createPlaceholderTexture();
     void createRenderPass();
+    void createScene(uint32_t objectCount);
+    void createStagingRegion();
     void createSyncObjects();
     void createSurface();
     void createSwapchain();
     void createTextureImage();
-    void createTextureImageView();
     void createTextureSampler();
-    void createUniformBuffers();
-    void createVertexBuffer();
+    void createUniformRing();
+    void destroyScene();
     void destroySwapchain();
+    void destroyTexture(const Texture& texture);
     void drawFrame();
-    void generateMipmaps(VkImage image, VkFormat imageFormat, int32_t textureWidth, int32_t textureHeight,
-        uint32_t mipLevels);
+    void evictTextures(VkDeviceSize budget, uint64_t usedBefore, TextureStreamingBatch& batch);
+    void finishAssetStreaming();
+    void flushUploads();
+    void generateMipmaps(VkCommandBuffer commandBuffer, VkImage image, VkFormat imageFormat, int32_t textureWidth,
+        int32_t textureHeight, uint32_t mipLevels);
     void initWindow();
     void initVulkan();
     void loadModel();
     void mainLoop();
+    void queueTextureLoad(const std::string& filename, std::function<void(const StagedTexture&)> onUploaded);
+    void queueUpload(const std::function<void(VkCommandBuffer)>& record, std::vector<StagingBuffer> stagingBuffers,
+        std::function<void()> swapIn);
+    void recordCommandBuffer(uint32_t imageIndex, const UniformBufferObject& ubo);
     void recreateSwapchain();
+    void reportTextureLoads();
+    void retireUploads(bool wait);
     void setupDebugMessenger();
-    void transitionImageLayout(VkImage image, uint32_t mipLevels, VkFormat format, VkImageLayout oldLayout,
-        VkImageLayout newLayout);
-    void updateUniformBuffer(uint32_t imageIndex);
+    void startAssetStreaming();
+    void submitTextureUploads();
+    void transitionImageLayout(VkCommandBuffer commandBuffer, VkImage image, uint32_t baseMipLevel, uint32_t mipLevels,
+        VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout);
+    void updateAssetStreaming();
+    void updateDescriptorSet(size_t frameIndex);
+    void updateTextureStreaming();
+    UniformBufferObject updateUniformBuffer();
+    void waitForTextureLoads();
 
     // Static Functions ---------------------------------------------------------------------------/
     static void framebufferResizeCallback(GLFWwindow* window, int width, int height);
@@ -204,9 +455,12 @@ private:
     /* ********************************************************************************************
      * Private Helper Functions
      * ********************************************************************************************/
+    static uint32_t getMipTailLevel(uint32_t width, uint32_t height, uint32_t mipLevels);
     static std::vector<char> readFile(const std::string& filename);
 
-    VkCommandBuffer beginSingleTimeCommands();
+    void addTexture(const StagedTexture& staged);
+    StagingBuffer allocateStagingBuffer(VkDeviceSize size, VkDeviceSize alignment);
+    void bindDescriptorSets(VkCommandBuffer commandBuffer, uint32_t uniformOffset);
     bool checkDeviceExtensionSupport(VkPhysicalDevice device);
     bool checkValidationLayerSupport();
     VkSurfaceFormatKHR chooseSwapSurfaceFormat(const std::vector<VkSurfaceFormatKHR>& availableFormats);
@@ -216,18 +470,17 @@ private:
         VkDebugUtilsMessageSeverityFlagBitsEXT messageSeverity,
         VkDebugUtilsMessageTypeFlagsEXT messageType,
         const VkDebugUtilsMessengerCallbackDataEXT* pCallbackData, void* pUserData);
-    void copyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size);
-    void copyBufferToImage(VkBuffer buffer, VkImage image, uint32_t width, uint32_t height);
-    void createBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties,
-        VkBuffer& buffer, VkDeviceMemory& bufferMemory);
+    void copyBufferToImage(VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSize bufferOffset, VkImage image,
+        uint32_t width, uint32_t height);
+    void createBuffer(VkDeviceSize size, VkBufferUsageFlags usage, MemoryUsage memoryUsage,
+        VkBuffer& buffer, DeviceAllocation& bufferMemory);
     void createImage(uint32_t width, uint32_t height, uint32_t mipLevels, VkSampleCountFlagBits numSamples,
-        VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, VkMemoryPropertyFlags properties,
-        VkImage& image, VkDeviceMemory& imageMemory);
-    VkImageView createImageView(VkImage image, uint32_t mipLevels, VkFormat format, VkImageAspectFlags aspectFlags);
+        VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, MemoryUsage memoryUsage,
+        VkImage& image, DeviceAllocation& imageMemory);
+    VkImageView createImageView(VkImage image, uint32_t baseMipLevel, uint32_t mipLevels, VkFormat format,
+        VkImageAspectFlags aspectFlags);
     VkShaderModule createShaderModule(const std::vector<char>& code);
-    void endSingleTimeCommands(VkCommandBuffer commandBuffer);
     VkFormat findDepthFormat();
-    uint32_t findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties);
     QueueFamilyIndices findQueueFamilies(VkPhysicalDevice device);
     VkFormat findSupportedFormat(const std::vector<VkFormat>& candidates, VkImageTiling tiling,
         VkFormatFeatureFlags features);
@@ -235,39 +488,103 @@ private:
     std::vector<const char*> getRequiredExtensions();
     bool hasStencilComponent(VkFormat format);
     bool isDeviceSuitable(VkPhysicalDevice device);
+    bool isTextureFormatSupported(VkFormat format);
+    StagedTexture loadTexture(const std::string& filename);
     void populateDebugMessengerCreateInfo(VkDebugUtilsMessengerCreateInfoEXT& createInfo);
     SwapchainSupportDetails querySwapchainSupport(VkPhysicalDevice device);
+    bool reallocateTexture(size_t index, uint32_t firstLevel, TextureStreamingBatch& batch);
+    void recordCulling(VkCommandBuffer commandBuffer, const UniformBufferObject& ubo);
+    void recordDepthPyramid(VkCommandBuffer commandBuffer);
+    void recordDraws(VkCommandBuffer commandBuffer, const UniformBufferObject& ubo, uint32_t uniformOffset,
+        size_t firstObject, size_t objectCount);
+    void recordIndirectDraws(VkCommandBuffer commandBuffer, const UniformBufferObject& ubo, uint32_t uniformOffset);
+    void recordInstancedDraws(VkCommandBuffer commandBuffer, const UniformBufferObject& ubo, uint32_t uniformOffset);
+    void recordModelUpload(VkCommandBuffer commandBuffer, const StagedModel& model);
+    void recordTextureUpload(VkCommandBuffer commandBuffer, const StagedTexture& texture);
+    void recordUploadBarriers(VkCommandBuffer commandBuffer, VkPipelineStageFlags dstStage,
+        std::vector<VkBufferMemoryBarrier> bufferBarriers, std::vector<VkImageMemoryBarrier> imageBarriers);
+    void releaseStagingBuffer(const StagingBuffer& staging);
+    void replaceTextureView(Texture& texture);
+    uint32_t selectLod(const UniformBufferObject& ubo, const glm::vec3& position) const;
     void selectPhysicalDevice();
+    void setBoundingSphere(const glm::vec3& boundsMin, const glm::vec3& boundsMax);
+    StagingBuffer stageIndexBuffer();
+    StagedTexture stageKtx2Texture(std::shared_ptr<const Ktx2File> file, uint32_t firstLevel, uint32_t baseLevel,
+        bool wait);
+    StagingBuffer stageLodBuffer();
+    StagedTexture stageTextureImage(uint32_t width, uint32_t height);
+    StagingBuffer stageVertexBuffer();
+    bool streamTextureLevel(size_t index, TextureStreamingBatch& batch);
+    bool tryAllocateStagingBuffer(VkDeviceSize size, VkDeviceSize alignment, StagingBuffer& staging);
 
     /* ********************************************************************************************
      * Private Attributes
      * ********************************************************************************************/
+    DeviceAllocator                 m_allocator;
+    // Vulkan version the instance was created with, which caps what the device may be used as.
+    uint32_t                        m_apiVersion;
+    VkDescriptorPool                m_bindlessDescriptorPool;
+    VkDescriptorSetLayout           m_bindlessDescriptorSetLayout;
+    std::vector<VkDescriptorSet>    m_bindlessDescriptorSets;
+    uint32_t                        m_bindlessTextureCount;
+    glm::vec4                       m_boundingSphere;
     VkImage                         m_colorImage;
-    VkDeviceMemory                  m_colorImageMemory;
+    DeviceAllocation                m_colorImageMemory;
     VkImageView                     m_colorImageView;
-    std::vector<VkCommandBuffer>    m_commandBuffers;
-    VkCommandPool                   m_commandPool;
+    VkCommandPool                   m_commandPoolTransfer;
     VkCommandPool                   m_commandPoolTransient;
     size_t                          m_currentFrame;
     VkDebugUtilsMessengerEXT        m_debugMessenger;
     VkImage                         m_depthImage;
-    VkDeviceMemory                  m_depthImageMemory;
+    DeviceAllocation                m_depthImageMemory;
     VkImageView                     m_depthImageView;
     VkDescriptorPool                m_descriptorPool;
     VkDescriptorSetLayout           m_descriptorSetLayout;
     std::vector<VkDescriptorSet>    m_descriptorSets;
     VkDevice                        m_device;
+    VkPhysicalDeviceFeatures        m_deviceFeatures;
+    VkBuffer                        m_drawCommandBuffer;
+    DeviceAllocation                m_drawCommandBufferMemory;
+    VkBuffer                        m_drawCountBuffer;
+    DeviceAllocation                m_drawCountBufferMemory;
+    // vkCmdDrawIndexedIndirectCount, loaded from the device if m_drawIndirectCount.
+    PFN_vkCmdDrawIndexedIndirectCount m_drawIndexedIndirectCount;
+    bool                            m_drawIndirectCount;
+    std::vector<FrameCommands>      m_frameCommands;
     VkPipeline                      m_graphicsPipeline;
     VkQueue                         m_graphicsQueue;
     VkBuffer                        m_indexBuffer;
-    VkDeviceMemory                  m_indexBufferMemory;
+    DeviceAllocation                m_indexBufferMemory;
+    uint32_t                        m_indexCount;
+    VkIndexType                     m_indexType;
     std::vector<uint32_t>           m_indices;
     VkInstance                      m_instance;
-    uint32_t                        m_mipLevels;
+    VkBuffer                        m_instanceBuffer;
+    DeviceAllocation                m_instanceBufferMemory;
+    // Draw the scene instanced; enableInstancing, which only a benchmark changes.
+    bool                            m_instancedDraws;
+    VkBuffer                        m_lodBuffer;
+    DeviceAllocation                m_lodBufferMemory;
+    std::vector<MeshLod>            m_lods;
+    uint32_t                        m_maxDrawIndirectCount;
+    MeshCache                       m_meshCache;
+    std::vector<Meshlet>            m_meshlets;
+    std::vector<uint8_t>            m_meshletTriangles;
+    std::vector<uint32_t>           m_meshletVertices;
     VkSampleCountFlagBits           m_msaaSamples;
+    VkBuffer                        m_objectBuffer;
+    DeviceAllocation                m_objectBufferMemory;
+    std::vector<glm::vec3>          m_objectPositions;
     VkPhysicalDevice                m_physicalDevice;
+    VkImage                         m_placeholderImage;
+    DeviceAllocation                m_placeholderImageMemory;
+    VkImageView                     m_placeholderImageView;
     VkPipelineLayout                m_pipelineLayout;
     VkQueue                         m_presentQueue;
+    QueueFamilyIndices              m_queueFamilyIndices;
+    // Most recording threads a frame is split across; the pool's thread count unless benchmarking.
+    size_t                          m_recordingThreadLimit;
+    ThreadPool                      m_recordingThreadPool;
     VkRenderPass                    m_renderPass;
     VkSurfaceKHR                    m_surface;
     VkSwapchainKHR                  m_swapchain;
@@ -276,19 +593,31 @@ private:
     std::vector<VkImage>            m_swapchainImages;
     VkFormat                        m_swapchainImageFormat;
     std::vector<VkImageView>        m_swapchainImageViews;
-    VkImage                         m_textureImage;
-    VkDeviceMemory                  m_textureImageMemory;
-    VkImageView                     m_textureImageView;
     VkSampler                       m_textureSampler;
-    std::vector<VkBuffer>           m_uniformBuffers;
-    std::vector<VkDeviceMemory>     m_uniformBuffersMemory;
+    ThreadPool                      m_threadPool;
+    // Two timestamps per frame in flight, around its commands, if the graphics queue supports them.
+    // Their difference is masked to the valid bits and scaled by the period in nanoseconds.
+    uint64_t                        m_timestampMask;
+    float                           m_timestampPeriod;
+    VkQueryPool                     m_timestampQueryPool;
+    VkQueue                         m_transferQueue;
+    VkBuffer                        m_uniformBuffer;
+    DeviceAllocation                m_uniformBufferMemory;
+    UniformRing                     m_uniformRing;
     std::vector<Vertex>             m_vertices;
     VkBuffer                        m_vertexBuffer;
-    VkDeviceMemory                  m_vertexBufferMemory;
+    DeviceAllocation                m_vertexBufferMemory;
+    VertexDecode                    m_vertexDecode;
     GLFWwindow*                     m_window;
 
     // Auxiliaries --------------------------------------------------------------------------------/
+    bool                            m_firstFramePresented;
+    uint64_t                        m_frameCount;
     bool                            m_framebufferResized;
+    uint64_t                        m_gpuFrameCount;
+    double                          m_gpuSeconds;
+    double                          m_recordingSeconds;
+    std::chrono::high_resolution_clock::time_point m_startTime;
 
     // Constants ----------------------------------------------------------------------------------/
     const int                       m_MAX_FRAMES_IN_FLIGHT;
@@ -298,5 +627,67 @@ private:
     std::vector<VkFence>            m_imageUsageFences;
     std::vector<VkFence>            m_cmdBufferExecFences;
     std::vector<VkSemaphore>        m_renderFinishedSemaphores;
+
+    // Uploads ------------------------------------------------------------------------------------/
+    // Copies and layout transitions are recorded into m_openUpload as they come and submitted
+    // together by flushUploads(), once per frame and once at the end of the initialisation, instead
+    // of each waiting for the queue to go idle. Submitted batches wait in m_uploads for their fences.
+    UploadBatch                     m_openUpload;
+    std::vector<UploadBatch>        m_uploads;
+    UploadStats                     m_uploadStats;
+
+    // GPU Culling --------------------------------------------------------------------------------/
+    // m_depthPyramid holds the farthest depth of the last frame over ever coarser regions, one mip
+    // level each. m_depthReducePipeline builds it after the render pass and m_cullPipeline tests
+    // against it in the next frame. The pyramid and its sets are recreated with the swapchain, which
+    // marks the frames' culling sets dirty.
+    VkDescriptorPool                m_cullDescriptorPool;
+    VkDescriptorSetLayout           m_cullDescriptorSetLayout;
+    VkPipeline                      m_cullPipeline;
+    VkPipelineLayout                m_cullPipelineLayout;
+    CullingStats                    m_cullingStats;
+    VkImage                         m_depthPyramid;
+    std::vector<VkImageView>        m_depthPyramidLevelViews;
+    DeviceAllocation                m_depthPyramidMemory;
+    bool                            m_depthPyramidReady;
+    VkSampler                       m_depthPyramidSampler;
+    VkImageView                     m_depthPyramidView;
+    VkDescriptorPool                m_depthReduceDescriptorPool;
+    VkDescriptorSetLayout           m_depthReduceDescriptorSetLayout;
+    std::vector<VkDescriptorSet>    m_depthReduceDescriptorSets;
+    VkPipeline                      m_depthReducePipeline;
+    VkPipelineLayout                m_depthReducePipelineLayout;
+    std::vector<FrameCulling>       m_frameCulling;
+
+    // Texture Loading ----------------------------------------------------------------------------/
+    // Texture jobs write straight into m_stagingRegion, a persistently mapped buffer whose space
+    // m_stagingRing hands out and gets back once the upload reading it has completed. Finished jobs
+    // are uploaded in batches, one submission per frame.
+    StagingBuffer                   m_stagingRegion;
+    StagingRing                     m_stagingRing;
+    size_t                          m_textureBatchesInFlight;
+    std::vector<TextureLoad>        m_textureLoads;
+    TextureLoadStats                m_textureLoadStats;
+    std::mutex                      m_textureLoadStatsMutex;
+
+    // Texture Streaming --------------------------------------------------------------------------/
+    // m_textures[0] is the model's texture; with bindless textures, the index of a texture is its
+    // element of the array. m_textureMemory includes the reallocations in flight, as if they had
+    // completed. Views and images that streaming has replaced stay in m_retiredTextures until no
+    // descriptor set refers to them any more.
+    std::vector<Texture>            m_textures;
+    VkDeviceSize                    m_textureMemory;
+    std::vector<Texture>            m_retiredTextures;
+
+    // Asset Streaming ----------------------------------------------------------------------------/
+    // While m_modelFuture is pending, its job owns every model member (m_vertices, m_indices, m_lods,
+    // m_vertexBuffer, m_indexBuffer, m_vertexDecode, ...); the main thread only reads them once
+    // m_modelReady is set. The pools are declared last so that they are joined before anything their
+    // jobs use is destroyed.
+    std::vector<bool>               m_descriptorSetsDirty;
+    std::future<StagedModel>        m_modelFuture;
+    bool                            m_modelReady;
+    ThreadPool                      m_streamingThreadPool;
+    ThreadPool                      m_textureThreadPool;
 };
 
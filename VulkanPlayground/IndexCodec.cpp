@@ -0,0 +1,81 @@
+#include "IndexCodec.h"
+
+#include <limits>
+
+/*! ***********************************************************************************************
+ * \class   IndexCodec
+ * \author  Leon Vincii
+ * \date    2026.10.16
+ * ************************************************************************************************/
+/* ************************************************************************************************
+ * Public Functions
+ * ************************************************************************************************/
+bool IndexCodec::decode(const uint8_t* data, size_t size, uint32_t* indices, size_t count)
+{
+    return decodeImpl(data, size, indices, count);
+}
+
+bool IndexCodec::decode(const uint8_t* data, size_t size, uint16_t* indices, size_t count)
+{
+    return decodeImpl(data, size, indices, count);
+}
+
+void IndexCodec::encode(const uint32_t* indices, size_t count, std::vector<uint8_t>& encoded)
+{
+    encoded.clear();
+    encoded.reserve(count + count / 4);
+
+    uint32_t previous = 0;
+    for (size_t i = 0; i < count; ++ i)
+    {
+        // Wrapping difference, zigzagged so that small negative steps also stay small.
+        int32_t delta = static_cast<int32_t>(indices[i] - previous);
+        uint32_t value = (static_cast<uint32_t>(delta) << 1) ^ static_cast<uint32_t>(delta >> 31);
+        previous = indices[i];
+
+        while (value >= 0x80)
+        {
+            encoded.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        encoded.push_back(static_cast<uint8_t>(value));
+    }
+}
+
+/* ************************************************************************************************
+ * Private Functions
+ * ************************************************************************************************/
+template<typename Index>
+bool IndexCodec::decodeImpl(const uint8_t* data, size_t size, Index* indices, size_t count)
+{
+    const uint8_t* cursor = data;
+    const uint8_t* end = data + size;
+    uint32_t previous = 0;
+
+    for (size_t i = 0; i < count; ++ i)
+    {
+        // Single-byte values are by far the most common case, so take them without the loop.
+        if (cursor == end) { return false; }
+        uint32_t value = *cursor ++;
+        if (value & 0x80)
+        {
+            value &= 0x7f;
+            uint32_t shift = 7;
+            uint8_t byte;
+            do
+            {
+                if (cursor == end || shift > 28) { return false; }
+                byte = *cursor ++;
+                value |= static_cast<uint32_t>(byte & 0x7f) << shift;
+                shift += 7;
+            } while (byte & 0x80);
+        }
+
+        uint32_t delta = (value >> 1) ^ (0u - (value & 1));
+        previous += delta;
+        if (previous > std::numeric_limits<Index>::max()) { return false; }
+        indices[i] = static_cast<Index>(previous);
+    }
+
+    return cursor == end;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*! ***********************************************************************************************
+ * \class   IndexCodec
+ * \brief   Lossless byte-oriented index stream compression. Every index is stored as the zigzag
+ *          encoded difference to the previous index in LEB128 varint form. After vertex fetch
+ *          optimization consecutive indices are close to each other, so most indices take a single
+ *          byte, and decoding is one branch-light loop with no tables.
+ * \author  Leon Vincii
+ * \date    2026.10.16
+ * ************************************************************************************************/
+class IndexCodec
+{
+public:
+    /* ********************************************************************************************
+     * Public Functions
+     * ********************************************************************************************/
+    // Decoders return false if the stream is truncated, overlong or does not hold exactly count
+    // indices, or, for the 16-bit variant, if any index does not fit.
+    static bool decode(const uint8_t* data, size_t size, uint32_t* indices, size_t count);
+    static bool decode(const uint8_t* data, size_t size, uint16_t* indices, size_t count);
+    static void encode(const uint32_t* indices, size_t count, std::vector<uint8_t>& encoded);
+
+private:
+    /* ********************************************************************************************
+     * Private Functions
+     * ********************************************************************************************/
+    template<typename Index>
+    static bool decodeImpl(const uint8_t* data, size_t size, Index* indices, size_t count);
+};
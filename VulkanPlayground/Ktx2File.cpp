@@ -0,0 +1,337 @@
+#include "Ktx2File.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+/* ************************************************************************************************
+ * Local Functions
+ * ************************************************************************************************/
+namespace
+{
+const uint8_t IDENTIFIER[12] = { 0xab, 'K', 'T', 'X', ' ', '2', '0', 0xbb, '\r', '\n', 0x1a, '\n' };
+// Identifier, nine header words, the DFD and KVD ranges and the SGD range.
+const size_t HEADER_SIZE = 12 + 9 * 4 + 4 * 4 + 2 * 8;
+
+// The BC formats in VkFormat order: BC1 RGB, BC1 RGBA, BC2, BC3, BC4, BC5, BC6H, BC7, each as a
+// pair of (UNORM, SRGB), (UNORM, SNORM) or (UFLOAT, SFLOAT).
+const uint32_t FIRST_BC_FORMAT = 131;   // VK_FORMAT_BC1_RGB_UNORM_BLOCK
+const uint32_t LAST_BC_FORMAT = 146;    // VK_FORMAT_BC7_SRGB_BLOCK
+// Uncompressed mip chains, e.g. those built on the CPU when the GPU cannot blit.
+const uint32_t RGBA8_UNORM_FORMAT = 37; // VK_FORMAT_R8G8B8A8_UNORM
+const uint32_t RGBA8_SRGB_FORMAT = 43;  // VK_FORMAT_R8G8B8A8_SRGB
+
+template<typename T>
+void append(std::vector<uint8_t>& data, T value)
+{
+    size_t offset = data.size();
+    data.resize(offset + sizeof(T));
+    std::memcpy(data.data() + offset, &value, sizeof(T));
+}
+
+template<typename T>
+T read(const std::vector<uint8_t>& data, size_t offset)
+{
+    T value;
+    std::memcpy(&value, data.data() + offset, sizeof(T));
+    return value;
+}
+
+size_t alignUp(size_t value, size_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+uint64_t getLevelSize(uint32_t vkFormat, uint32_t width, uint32_t height, uint32_t level)
+{
+    uint64_t blockDimension = Ktx2File::getBlockDimension(vkFormat);
+    uint64_t levelWidth = std::max(width >> level, 1u);
+    uint64_t levelHeight = std::max(height >> level, 1u);
+    return ((levelWidth + blockDimension - 1) / blockDimension) * ((levelHeight + blockDimension - 1) / blockDimension) *
+        Ktx2File::getBlockSize(vkFormat);
+}
+
+// Basic data format descriptor of a BC format: one sample covering the whole block. RGBA8 gets one
+// 8-bit sample per channel instead.
+std::vector<uint32_t> createDataFormatDescriptor(uint32_t vkFormat, uint32_t blockSize)
+{
+    if (vkFormat == RGBA8_UNORM_FORMAT || vkFormat == RGBA8_SRGB_FORMAT)
+    {
+        const uint32_t descriptorBlockSize = 24 + 4 * 16;
+        bool isSrgb = vkFormat == RGBA8_SRGB_FORMAT;
+
+        std::vector<uint32_t> words;
+        words.push_back(4 + descriptorBlockSize);               // dfdTotalSize
+        words.push_back(0);                                     // vendorId | descriptorType
+        words.push_back(2 | descriptorBlockSize << 16);         // versionNumber | descriptorBlockSize
+        words.push_back(1 | 1 << 8 | (isSrgb ? 2 : 1) << 16);   // RGBSDA, BT.709 primaries, sRGB or linear
+        words.push_back(0);                                     // 1x1x1x1 texel block
+        words.push_back(blockSize);                             // bytesPlane0
+        words.push_back(0);
+
+        // Channels R, G, B and A (15); alpha stays linear in sRGB formats.
+        const uint32_t channels[4] = { 0, 1, 2, 15 };
+        for (uint32_t i = 0; i < 4; ++ i)
+        {
+            uint32_t linearFlag = isSrgb && channels[i] == 15 ? 0x10 : 0;
+            words.push_back(i * 8 | 7 << 16 | (channels[i] | linearFlag) << 24);
+            words.push_back(0);                                 // samplePosition
+            words.push_back(0);                                 // sampleLower
+            words.push_back(255);                               // sampleUpper
+        }
+        return words;
+    }
+
+    // Color models KHR_DF_MODEL_BC1A (128) to KHR_DF_MODEL_BC7 (134), one per format pair, with
+    // BC1 RGB and RGBA sharing the first one.
+    uint32_t pair = (vkFormat - FIRST_BC_FORMAT) / 2;
+    uint32_t colorModel = 128 + (pair == 0 ? 0 : pair - 1);
+    bool isSrgb = (vkFormat % 2 == 0) && (pair <= 3 || pair == 7);
+
+    const uint32_t descriptorBlockSize = 24 + 16;
+    std::vector<uint32_t> words;
+    words.push_back(4 + descriptorBlockSize);                   // dfdTotalSize
+    words.push_back(0);                                         // vendorId | descriptorType
+    words.push_back(2 | descriptorBlockSize << 16);             // versionNumber | descriptorBlockSize
+    words.push_back(colorModel | 1 << 8 | (isSrgb ? 2 : 1) << 16);  // BT.709 primaries, sRGB or linear
+    words.push_back(3 | 3 << 8);                                // 4x4x1x1 texel block
+    words.push_back(blockSize);                                 // bytesPlane0
+    words.push_back(0);
+    words.push_back(0 | (blockSize * 8 - 1) << 16);            // sample: bitOffset | bitLength
+    words.push_back(0);                                         // samplePosition
+    words.push_back(0);                                         // sampleLower
+    words.push_back(0xffffffff);                                // sampleUpper
+    return words;
+}
+}
+
+/*! ***********************************************************************************************
+ * \class   Ktx2File
+ * \author  Leon Vincii
+ * \date    2026.10.16
+ * ************************************************************************************************/
+/* ************************************************************************************************
+ * Public Ctor & Dtor
+ * ************************************************************************************************/
+Ktx2File::Ktx2File() :
+    m_data                      ()
+  , m_height                    (0)
+  , m_keyValues                 ()
+  , m_levels                    ()
+  , m_vkFormat                  (0)
+  , m_width                     (0)
+{}
+
+/* ************************************************************************************************
+ * Public Functions
+ * ************************************************************************************************/
+void Ktx2File::create(uint32_t vkFormat, uint32_t width, uint32_t height,
+    const std::vector<std::vector<uint8_t>>& levels, const std::vector<std::pair<std::string, std::string>>& keyValues)
+{
+    uint32_t blockSize = getBlockSize(vkFormat);
+    if (blockSize == 0 || levels.empty())
+    {
+        throw std::invalid_argument("unsupported KTX2 contents");
+    }
+
+    uint32_t levelCount = static_cast<uint32_t>(levels.size());
+    std::vector<uint32_t> dfd = createDataFormatDescriptor(vkFormat, blockSize);
+
+    // Key/value entries must be sorted by key, each one padded to four bytes.
+    std::vector<std::pair<std::string, std::string>> sortedKeyValues = keyValues;
+    std::sort(sortedKeyValues.begin(), sortedKeyValues.end());
+    std::vector<uint8_t> kvd;
+    for (const auto& keyValue : sortedKeyValues)
+    {
+        append<uint32_t>(kvd, static_cast<uint32_t>(keyValue.first.size() + keyValue.second.size() + 2));
+        kvd.insert(kvd.end(), keyValue.first.begin(), keyValue.first.end());
+        kvd.push_back(0);
+        kvd.insert(kvd.end(), keyValue.second.begin(), keyValue.second.end());
+        kvd.push_back(0);
+        kvd.resize(alignUp(kvd.size(), 4), 0);
+    }
+
+    size_t levelIndexOffset = HEADER_SIZE;
+    size_t dfdOffset = levelIndexOffset + levelCount * sizeof(Ktx2Level);
+    size_t kvdOffset = dfdOffset + dfd.size() * sizeof(uint32_t);
+    size_t levelDataOffset = kvdOffset + kvd.size();
+
+    // The level index lists the full size image first, but the data is stored smallest level first
+    // so that a partial read yields a usable low-resolution chain. Levels are aligned to the block,
+    // and to at least four bytes.
+    std::vector<Ktx2Level> levelIndex(levelCount);
+    for (uint32_t level = levelCount; level -- > 0;)
+    {
+        levelDataOffset = alignUp(levelDataOffset, std::max(blockSize, 4u));
+        levelIndex[level].byteOffset = levelDataOffset;
+        levelIndex[level].byteLength = levels[level].size();
+        levelIndex[level].uncompressedByteLength = levels[level].size();
+        levelDataOffset += levels[level].size();
+    }
+
+    m_data.clear();
+    m_data.reserve(levelDataOffset);
+    m_data.insert(m_data.end(), IDENTIFIER, IDENTIFIER + sizeof(IDENTIFIER));
+    append<uint32_t>(m_data, vkFormat);
+    append<uint32_t>(m_data, 1);                // typeSize
+    append<uint32_t>(m_data, width);
+    append<uint32_t>(m_data, height);
+    append<uint32_t>(m_data, 0);                // pixelDepth
+    append<uint32_t>(m_data, 0);                // layerCount
+    append<uint32_t>(m_data, 1);                // faceCount
+    append<uint32_t>(m_data, levelCount);
+    append<uint32_t>(m_data, 0);                // supercompressionScheme
+    append<uint32_t>(m_data, static_cast<uint32_t>(dfdOffset));
+    append<uint32_t>(m_data, static_cast<uint32_t>(dfd.size() * sizeof(uint32_t)));
+    append<uint32_t>(m_data, static_cast<uint32_t>(kvd.empty() ? 0 : kvdOffset));
+    append<uint32_t>(m_data, static_cast<uint32_t>(kvd.size()));
+    append<uint64_t>(m_data, 0);                // sgdByteOffset
+    append<uint64_t>(m_data, 0);                // sgdByteLength
+    for (const Ktx2Level& level : levelIndex) { append(m_data, level); }
+    for (uint32_t word : dfd) { append(m_data, word); }
+    m_data.insert(m_data.end(), kvd.begin(), kvd.end());
+
+    m_data.resize(levelDataOffset, 0);
+    for (uint32_t level = 0; level < levelCount; ++ level)
+    {
+        std::copy(levels[level].begin(), levels[level].end(), m_data.begin() + levelIndex[level].byteOffset);
+    }
+
+    if (!parse())
+    {
+        throw std::invalid_argument("inconsistent KTX2 level sizes");
+    }
+}
+
+bool Ktx2File::load(const std::string& filename)
+{
+    std::ifstream file(filename, std::ios::ate | std::ios::binary);
+    if (!file.is_open()) { return false; }
+
+    m_data.resize(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(m_data.data()), static_cast<std::streamsize>(m_data.size()));
+    if (!file) { return false; }
+
+    return parse();
+}
+
+bool Ktx2File::save(const std::string& filename) const
+{
+    // Write to a temporary file first so that an interrupted write never leaves a truncated file
+    // behind under the real name.
+    std::string tempFilename = filename + ".tmp";
+    {
+        std::ofstream file(tempFilename, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) { return false; }
+
+        file.write(reinterpret_cast<const char*>(m_data.data()), static_cast<std::streamsize>(m_data.size()));
+        if (!file.good()) { return false; }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tempFilename, filename, error);
+    if (error)
+    {
+        std::filesystem::remove(tempFilename, error);
+        return false;
+    }
+
+    return true;
+}
+
+std::string Ktx2File::findValue(const std::string& key) const
+{
+    for (const auto& keyValue : m_keyValues)
+    {
+        if (keyValue.first == key) { return keyValue.second; }
+    }
+    return std::string();
+}
+
+uint32_t Ktx2File::getBlockDimension(uint32_t vkFormat)
+{
+    return vkFormat >= FIRST_BC_FORMAT && vkFormat <= LAST_BC_FORMAT ? 4 : 1;
+}
+
+uint32_t Ktx2File::getBlockSize(uint32_t vkFormat)
+{
+    if (vkFormat == RGBA8_UNORM_FORMAT || vkFormat == RGBA8_SRGB_FORMAT) { return 4; }
+    if (vkFormat < FIRST_BC_FORMAT || vkFormat > LAST_BC_FORMAT) { return 0; }
+
+    // BC1 and BC4 store 8 bytes per block, every other BC format 16.
+    uint32_t pair = (vkFormat - FIRST_BC_FORMAT) / 2;
+    return pair <= 1 || pair == 4 ? 8 : 16;
+}
+
+/* ************************************************************************************************
+ * Private Functions
+ * ************************************************************************************************/
+bool Ktx2File::parse()
+{
+    m_keyValues.clear();
+    m_levels.clear();
+
+    if (m_data.size() < HEADER_SIZE || std::memcmp(m_data.data(), IDENTIFIER, sizeof(IDENTIFIER)) != 0)
+    {
+        return false;
+    }
+
+    m_vkFormat = read<uint32_t>(m_data, 12);
+    m_width = read<uint32_t>(m_data, 20);
+    m_height = read<uint32_t>(m_data, 24);
+    uint32_t pixelDepth = read<uint32_t>(m_data, 28);
+    uint32_t layerCount = read<uint32_t>(m_data, 32);
+    uint32_t faceCount = read<uint32_t>(m_data, 36);
+    uint32_t levelCount = std::max(read<uint32_t>(m_data, 40), 1u);
+    uint32_t supercompressionScheme = read<uint32_t>(m_data, 44);
+    uint32_t kvdOffset = read<uint32_t>(m_data, 56);
+    uint32_t kvdLength = read<uint32_t>(m_data, 60);
+
+    uint32_t blockSize = getBlockSize(m_vkFormat);
+    if (blockSize == 0 || m_width == 0 || m_height == 0 || pixelDepth != 0 || layerCount > 1 || faceCount != 1 ||
+        supercompressionScheme != 0 || levelCount > 32)
+    {
+        return false;
+    }
+
+    if (HEADER_SIZE + static_cast<size_t>(levelCount) * sizeof(Ktx2Level) > m_data.size()) { return false; }
+    m_levels.resize(levelCount);
+    for (uint32_t level = 0; level < levelCount; ++ level)
+    {
+        m_levels[level] = read<Ktx2Level>(m_data, HEADER_SIZE + level * sizeof(Ktx2Level));
+        const Ktx2Level& entry = m_levels[level];
+        if (entry.byteOffset > m_data.size() || entry.byteLength > m_data.size() - entry.byteOffset ||
+            entry.byteLength != getLevelSize(m_vkFormat, m_width, m_height, level))
+        {
+            m_levels.clear();
+            return false;
+        }
+    }
+
+    // Key/value data is optional; malformed entries end the list rather than the whole file.
+    if (kvdLength > 0 && static_cast<uint64_t>(kvdOffset) + kvdLength <= m_data.size())
+    {
+        size_t cursor = kvdOffset;
+        size_t end = static_cast<size_t>(kvdOffset) + kvdLength;
+        while (cursor + 4 <= end)
+        {
+            uint32_t length = read<uint32_t>(m_data, cursor);
+            cursor += 4;
+            if (length > end - cursor) { break; }
+
+            auto entry = reinterpret_cast<const char*>(m_data.data() + cursor);
+            size_t keyLength = strnlen(entry, length);
+            if (keyLength < length)
+            {
+                size_t valueLength = strnlen(entry + keyLength + 1, length - keyLength - 1);
+                m_keyValues.emplace_back(std::string(entry, keyLength), std::string(entry + keyLength + 1, valueLength));
+            }
+            cursor = alignUp(cursor + length, 4);
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+/* ************************************************************************************************
+ * Global Structs
+ * ************************************************************************************************/
+struct Ktx2Level
+{
+    uint64_t    byteOffset;
+    uint64_t    byteLength;
+    uint64_t    uncompressedByteLength;
+};
+
+/*! ***********************************************************************************************
+ * \class   Ktx2File
+ * \brief   Reader and writer for the subset of KTX 2.0 this application uploads directly: a single 2D
+ *          image (no array layers, faces or depth) in a 4x4 BC format or 8-bit RGBA with its whole
+ *          mip chain and no supercompression. Formats are plain VkFormat values, so the file does not depend on
+ *          the Vulkan headers. Key/value pairs are kept as strings.
+ * \author  Leon Vincii
+ * \date    2026.10.16
+ * ************************************************************************************************/
+class Ktx2File
+{
+public:
+    /* ********************************************************************************************
+     * Public Ctor & Dtor
+     * ********************************************************************************************/
+    Ktx2File();
+
+    /* ********************************************************************************************
+     * Public Functions
+     * ********************************************************************************************/
+    // Builds the file in memory; levels go from the full size image down, each one already encoded.
+    void create(uint32_t vkFormat, uint32_t width, uint32_t height, const std::vector<std::vector<uint8_t>>& levels,
+        const std::vector<std::pair<std::string, std::string>>& keyValues);
+    // Reads and validates a file; false if it is missing, corrupt or outside the supported subset.
+    bool load(const std::string& filename);
+    bool save(const std::string& filename) const;
+
+    // Accessors ----------------------------------------------------------------------------------/
+    std::string findValue(const std::string& key) const;
+    uint32_t height() const { return m_height; }
+    uint32_t levelCount() const { return static_cast<uint32_t>(m_levels.size()); }
+    const uint8_t* levelData(uint32_t level) const { return m_data.data() + m_levels[level].byteOffset; }
+    uint64_t levelSize(uint32_t level) const { return m_levels[level].byteLength; }
+    uint32_t vkFormat() const { return m_vkFormat; }
+    uint32_t width() const { return m_width; }
+
+    // Static Functions ---------------------------------------------------------------------------/
+    // Texel block width and height of a supported format: 4 for BC formats, 1 for RGBA8.
+    static uint32_t getBlockDimension(uint32_t vkFormat);
+    // Bytes per texel block of a supported format, 0 for anything else.
+    static uint32_t getBlockSize(uint32_t vkFormat);
+
+private:
+    /* ********************************************************************************************
+     * Private Functions
+     * ********************************************************************************************/
+    bool parse();
+
+    /* ********************************************************************************************
+     * Private Attributes
+     * ********************************************************************************************/
+    std::vector<uint8_t>            m_data;
+    uint32_t                        m_height;
+    std::vector<std::pair<std::string, std::string>> m_keyValues;
+    std::vector<Ktx2Level>          m_levels;
+    uint32_t                        m_vkFormat;
+    uint32_t                        m_width;
+};
@@ -0,0 +1,356 @@
+#include "MeshCache.h"
+
+#include "IndexCodec.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+/* ************************************************************************************************
+ * Local Functions
+ * ************************************************************************************************/
+namespace
+{
+// Blobs are aligned so that they can be copied with wide loads straight out of the mapped view.
+const uint64_t BLOB_ALIGNMENT = 16;
+
+uint64_t alignUp(uint64_t value, uint64_t alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+uint64_t fnv1a(uint64_t hash, const void* data, size_t size)
+{
+    auto bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < size; ++ i)
+    {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+}
+
+/*! ***********************************************************************************************
+ * \class   MeshCache
+ * \author  Leon Vincii
+ * \date    2026.10.16
+ * ************************************************************************************************/
+const uint32_t MeshCache::MAGIC = 0x484d5056; // "VPMH"
+const uint32_t MeshCache::VERSION = 4;
+const uint32_t MeshCache::INDEX_ENCODING_RAW = 0;
+const uint32_t MeshCache::INDEX_ENCODING_DELTA_VARINT = 1;
+
+/* ************************************************************************************************
+ * Public Ctor & Dtor
+ * ************************************************************************************************/
+MeshCache::MeshCache() :
+    m_data                      (nullptr)
+  , m_header                    (nullptr)
+  , m_size                      (0)
+    // Platform Handles ---------------------------------------------------------------------------/
+  , m_fileHandle                (nullptr)
+  , m_mappingHandle             (nullptr)
+{}
+
+MeshCache::~MeshCache()
+{
+    close();
+}
+
+/* ************************************************************************************************
+ * Public Functions
+ * ************************************************************************************************/
+void MeshCache::close()
+{
+#ifdef _WIN32
+    if (m_data) { UnmapViewOfFile(m_data); }
+    if (m_mappingHandle) { CloseHandle(m_mappingHandle); }
+    if (m_fileHandle) { CloseHandle(m_fileHandle); }
+#else
+    if (m_data) { munmap(const_cast<uint8_t*>(m_data), static_cast<size_t>(m_size)); }
+    if (m_fileHandle) { ::close(static_cast<int>(reinterpret_cast<intptr_t>(m_fileHandle)) - 1); }
+#endif
+
+    m_data = nullptr;
+    m_header = nullptr;
+    m_size = 0;
+    m_fileHandle = nullptr;
+    m_mappingHandle = nullptr;
+}
+
+bool MeshCache::open(const std::string& filename, uint64_t sourceHash)
+{
+    close();
+
+    // Map the whole file read-only. Pages are only faulted in when the blobs are copied into the
+    // staging buffers, so opening the cache itself costs next to nothing.
+#ifdef _WIN32
+    HANDLE file = CreateFileA(
+        filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr
+    );
+    if (file == INVALID_HANDLE_VALUE) { return false; }
+    m_fileHandle = file;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart < static_cast<LONGLONG>(sizeof(MeshCacheHeader)))
+    {
+        close();
+        return false;
+    }
+    m_size = static_cast<uint64_t>(fileSize.QuadPart);
+
+    m_mappingHandle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!m_mappingHandle)
+    {
+        close();
+        return false;
+    }
+
+    m_data = static_cast<const uint8_t*>(MapViewOfFile(m_mappingHandle, FILE_MAP_READ, 0, 0, 0));
+#else
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) { return false; }
+    // Store the descriptor off by one so that a null handle still means "no file".
+    m_fileHandle = reinterpret_cast<void*>(static_cast<intptr_t>(fd) + 1);
+
+    struct stat fileStat {};
+    if (fstat(fd, &fileStat) != 0 || fileStat.st_size < static_cast<off_t>(sizeof(MeshCacheHeader)))
+    {
+        close();
+        return false;
+    }
+    m_size = static_cast<uint64_t>(fileStat.st_size);
+
+    void* view = mmap(nullptr, static_cast<size_t>(m_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    m_data = view == MAP_FAILED ? nullptr : static_cast<const uint8_t*>(view);
+#endif
+
+    if (!m_data)
+    {
+        close();
+        return false;
+    }
+
+    // Validate the header and make sure both blobs lie within the file before handing them out.
+    auto header = reinterpret_cast<const MeshCacheHeader*>(m_data);
+    bool valid = header->magic == MAGIC && header->version == VERSION && header->sourceHash == sourceHash &&
+        header->vertexOffset + header->vertexSize <= m_size &&
+        header->indexOffset + header->indexSize <= m_size &&
+        header->vertexSize == static_cast<uint64_t>(header->vertexStride) * header->vertexCount &&
+        (header->indexEncoding == INDEX_ENCODING_DELTA_VARINT ||
+         (header->indexEncoding == INDEX_ENCODING_RAW && header->indexSize == sizeof(uint32_t) * static_cast<uint64_t>(header->indexCount))) &&
+        header->meshletOffset + header->meshletSize <= m_size &&
+        header->meshletVertexOffset + header->meshletVertexSize <= m_size &&
+        header->meshletTriangleOffset + header->meshletTriangleSize <= m_size &&
+        header->meshletSize == static_cast<uint64_t>(header->meshletStride) * header->meshletCount &&
+        header->meshletVertexSize == sizeof(uint32_t) * static_cast<uint64_t>(header->meshletVertexCount) &&
+        header->meshletTriangleSize == header->meshletTriangleCount &&
+        header->lodOffset + header->lodSize <= m_size &&
+        header->lodSize == static_cast<uint64_t>(header->lodStride) * header->lodCount;
+
+    if (!valid)
+    {
+        close();
+        return false;
+    }
+
+    m_header = header;
+    return true;
+}
+
+// Accessors --------------------------------------------------------------------------------------/
+glm::vec3 MeshCache::boundsMax() const
+{
+    return glm::vec3(m_header->boundsMax[0], m_header->boundsMax[1], m_header->boundsMax[2]);
+}
+
+glm::vec3 MeshCache::boundsMin() const
+{
+    return glm::vec3(m_header->boundsMin[0], m_header->boundsMin[1], m_header->boundsMin[2]);
+}
+
+
+const void* MeshCache::lodData() const
+{
+    return m_data + m_header->lodOffset;
+}
+
+const void* MeshCache::meshletData() const
+{
+    return m_data + m_header->meshletOffset;
+}
+
+const uint8_t* MeshCache::meshletTriangleData() const
+{
+    return m_data + m_header->meshletTriangleOffset;
+}
+
+const uint32_t* MeshCache::meshletVertexData() const
+{
+    return reinterpret_cast<const uint32_t*>(m_data + m_header->meshletVertexOffset);
+}
+
+const void* MeshCache::vertexData() const
+{
+    return m_data + m_header->vertexOffset;
+}
+
+bool MeshCache::readIndices(uint16_t* indices) const
+{
+    const uint8_t* data = m_data + m_header->indexOffset;
+    if (m_header->indexEncoding == INDEX_ENCODING_DELTA_VARINT)
+    {
+        return IndexCodec::decode(data, static_cast<size_t>(m_header->indexSize), indices, m_header->indexCount);
+    }
+
+    for (uint32_t i = 0; i < m_header->indexCount; ++ i)
+    {
+        uint32_t index;
+        memcpy(&index, data + sizeof(uint32_t) * i, sizeof(index));
+        if (index > 0xffff) { return false; }
+        indices[i] = static_cast<uint16_t>(index);
+    }
+    return true;
+}
+
+bool MeshCache::readIndices(uint32_t* indices) const
+{
+    const uint8_t* data = m_data + m_header->indexOffset;
+    if (m_header->indexEncoding == INDEX_ENCODING_DELTA_VARINT)
+    {
+        return IndexCodec::decode(data, static_cast<size_t>(m_header->indexSize), indices, m_header->indexCount);
+    }
+
+    memcpy(indices, data, static_cast<size_t>(m_header->indexSize));
+    return true;
+}
+
+// Static Functions -------------------------------------------------------------------------------/
+uint64_t MeshCache::hashCombine(uint64_t hash, uint64_t value)
+{
+    return fnv1a(hash, &value, sizeof(value));
+}
+
+uint64_t MeshCache::hashSourceFile(const std::string& filename)
+{
+    /***
+     * Hashing the whole source file would cost a full read of a file we are trying not to touch,
+     * so the cache is keyed on the path, size and modification time of the source instead, plus
+     * the format version so that a format change invalidates every existing cache.
+     ***/
+    std::error_code error;
+    uint64_t fileSize = static_cast<uint64_t>(std::filesystem::file_size(filename, error));
+    if (error) { fileSize = 0; }
+    int64_t writeTime = static_cast<int64_t>(std::filesystem::last_write_time(filename, error).time_since_epoch().count());
+    if (error) { writeTime = 0; }
+
+    uint64_t hash = 0xcbf29ce484222325ull;
+    hash = fnv1a(hash, filename.data(), filename.size());
+    hash = fnv1a(hash, &fileSize, sizeof(fileSize));
+    hash = fnv1a(hash, &writeTime, sizeof(writeTime));
+    hash = fnv1a(hash, &VERSION, sizeof(VERSION));
+    return hash;
+}
+
+bool MeshCache::write(const std::string& filename, uint64_t sourceHash, const MeshCacheContents& contents)
+{
+    MeshCacheHeader header {};
+    header.magic = MAGIC;
+    header.version = VERSION;
+    header.sourceHash = sourceHash;
+    header.vertexStride = contents.vertexStride;
+    header.vertexCount = contents.vertexCount;
+    header.indexCount = contents.indexCount;
+    header.indexEncoding = INDEX_ENCODING_DELTA_VARINT;
+    header.boundsMin[0] = contents.boundsMin.x;
+    header.boundsMin[1] = contents.boundsMin.y;
+    header.boundsMin[2] = contents.boundsMin.z;
+    header.boundsMax[0] = contents.boundsMax.x;
+    header.boundsMax[1] = contents.boundsMax.y;
+    header.boundsMax[2] = contents.boundsMax.z;
+    header.meshletStride = contents.meshletStride;
+    header.meshletCount = contents.meshletCount;
+    header.meshletVertexCount = contents.meshletVertexCount;
+    header.meshletTriangleCount = contents.meshletTriangleCount;
+    header.lodStride = contents.lodStride;
+    header.lodCount = contents.lodCount;
+
+    // Indices after the fetch optimization mostly differ by a little from their predecessor, so they
+    // are stored delta coded, which typically takes a third of the raw size or less.
+    std::vector<uint8_t> encodedIndices;
+    IndexCodec::encode(contents.indexData, contents.indexCount, encodedIndices);
+
+    // Lay the blobs out back to back, each aligned, in the order they are listed here.
+    struct Blob
+    {
+        uint64_t*   offset;
+        uint64_t*   size;
+        const void* data;
+        uint64_t    dataSize;
+    };
+    const Blob blobs[] = {
+        { &header.vertexOffset, &header.vertexSize, contents.vertexData,
+            static_cast<uint64_t>(contents.vertexStride) * contents.vertexCount },
+        { &header.indexOffset, &header.indexSize, encodedIndices.data(), encodedIndices.size() },
+        { &header.meshletOffset, &header.meshletSize, contents.meshletData,
+            static_cast<uint64_t>(contents.meshletStride) * contents.meshletCount },
+        { &header.meshletVertexOffset, &header.meshletVertexSize, contents.meshletVertexData,
+            sizeof(uint32_t) * static_cast<uint64_t>(contents.meshletVertexCount) },
+        { &header.meshletTriangleOffset, &header.meshletTriangleSize, contents.meshletTriangleData,
+            contents.meshletTriangleCount },
+        { &header.lodOffset, &header.lodSize, contents.lodData,
+            static_cast<uint64_t>(contents.lodStride) * contents.lodCount }
+    };
+
+    uint64_t fileSize = sizeof(MeshCacheHeader);
+    for (const Blob& blob : blobs)
+    {
+        *blob.offset = alignUp(fileSize, BLOB_ALIGNMENT);
+        *blob.size = blob.dataSize;
+        fileSize = *blob.offset + blob.dataSize;
+    }
+
+    // Write to a temporary file first so that an interrupted write never leaves a truncated cache
+    // behind that would pass the header check.
+    std::string tempFilename = filename + ".tmp";
+    {
+        std::ofstream file(tempFilename, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) { return false; }
+
+        const char padding[BLOB_ALIGNMENT] = {};
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        uint64_t position = sizeof(header);
+        for (const Blob& blob : blobs)
+        {
+            file.write(padding, static_cast<std::streamsize>(*blob.offset - position));
+            if (blob.dataSize) { file.write(static_cast<const char*>(blob.data), static_cast<std::streamsize>(blob.dataSize)); }
+            position = *blob.offset + blob.dataSize;
+        }
+
+        if (!file.good()) { return false; }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tempFilename, filename, error);
+    if (error)
+    {
+        std::filesystem::remove(tempFilename, error);
+        return false;
+    }
+
+    return true;
+}
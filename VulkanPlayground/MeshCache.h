@@ -0,0 +1,148 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <string>
+
+/* ************************************************************************************************
+ * Global Structs
+ * ************************************************************************************************/
+struct MeshCacheHeader
+{
+    uint32_t    magic;
+    uint32_t    version;
+    uint64_t    sourceHash;
+    uint32_t    vertexStride;
+    uint32_t    vertexCount;
+    uint32_t    indexCount;
+    uint32_t    indexEncoding;
+    float       boundsMin[3];
+    float       boundsMax[3];
+    uint64_t    vertexOffset;
+    uint64_t    vertexSize;
+    uint64_t    indexOffset;
+    uint64_t    indexSize;
+    // Meshlets -----------------------------------------------------------------------------------/
+    uint32_t    meshletStride;
+    uint32_t    meshletCount;
+    uint32_t    meshletVertexCount;
+    uint32_t    meshletTriangleCount;
+    uint64_t    meshletOffset;
+    uint64_t    meshletSize;
+    uint64_t    meshletVertexOffset;
+    uint64_t    meshletVertexSize;
+    uint64_t    meshletTriangleOffset;
+    uint64_t    meshletTriangleSize;
+    // Levels of Detail ---------------------------------------------------------------------------/
+    uint32_t    lodStride;
+    uint32_t    lodCount;
+    uint64_t    lodOffset;
+    uint64_t    lodSize;
+};
+
+// Everything written to a cache file. Blobs are passed as raw memory with their element stride so
+// that the cache does not depend on the vertex or meshlet layout; readers check the strides.
+struct MeshCacheContents
+{
+    const void*         vertexData;
+    uint32_t            vertexStride;
+    uint32_t            vertexCount;
+    const uint32_t*     indexData;
+    uint32_t            indexCount;
+    glm::vec3           boundsMin;
+    glm::vec3           boundsMax;
+    // Meshlets, optional -------------------------------------------------------------------------/
+    const void*         meshletData;
+    uint32_t            meshletStride;
+    uint32_t            meshletCount;
+    const uint32_t*     meshletVertexData;
+    uint32_t            meshletVertexCount;
+    const uint8_t*      meshletTriangleData;
+    uint32_t            meshletTriangleCount;
+    // Levels of detail, optional -----------------------------------------------------------------/
+    const void*         lodData;
+    uint32_t            lodStride;
+    uint32_t            lodCount;
+};
+
+/*! ***********************************************************************************************
+ * \class   MeshCache
+ * \brief   Versioned binary mesh file that is written once after the source model has been parsed
+ *          and memory-mapped on later runs, so that the vertex and index blobs can be copied
+ *          straight into the staging buffers without any parsing or deduplication.
+ * \author  Leon Vincii
+ * \date    2026.10.16
+ * ************************************************************************************************/
+class MeshCache
+{
+public:
+    /* ********************************************************************************************
+     * Public Ctor & Dtor
+     * ********************************************************************************************/
+    MeshCache();
+    ~MeshCache();
+
+    MeshCache(const MeshCache&) = delete;
+    MeshCache& operator=(const MeshCache&) = delete;
+
+    /* ********************************************************************************************
+     * Public Functions
+     * ********************************************************************************************/
+    void close();
+    bool isOpen() const { return m_header != nullptr; }
+    bool open(const std::string& filename, uint64_t sourceHash);
+
+    // Accessors ----------------------------------------------------------------------------------/
+    glm::vec3 boundsMax() const;
+    glm::vec3 boundsMin() const;
+    uint32_t indexCount() const { return m_header->indexCount; }
+    uint64_t indexDataSize() const { return m_header->indexSize; }
+    uint32_t indexEncoding() const { return m_header->indexEncoding; }
+    uint32_t lodCount() const { return m_header->lodCount; }
+    const void* lodData() const;
+    uint32_t lodStride() const { return m_header->lodStride; }
+    uint32_t meshletCount() const { return m_header->meshletCount; }
+    const void* meshletData() const;
+    uint32_t meshletStride() const { return m_header->meshletStride; }
+    // Byte count of the triangle list, three local vertex numbers per triangle.
+    uint32_t meshletTriangleCount() const { return m_header->meshletTriangleCount; }
+    const uint8_t* meshletTriangleData() const;
+    uint32_t meshletVertexCount() const { return m_header->meshletVertexCount; }
+    const uint32_t* meshletVertexData() const;
+    uint32_t vertexCount() const { return m_header->vertexCount; }
+    const void* vertexData() const;
+    uint64_t vertexDataSize() const { return m_header->vertexSize; }
+    uint32_t vertexStride() const { return m_header->vertexStride; }
+
+    // Decode the index stream into indexCount() indices; false if the stream is corrupt or, for
+    // 16-bit output, if an index does not fit.
+    bool readIndices(uint16_t* indices) const;
+    bool readIndices(uint32_t* indices) const;
+
+    // Static Functions ---------------------------------------------------------------------------/
+    // Folds a build option into a source hash, so that caches written with other options miss.
+    static uint64_t hashCombine(uint64_t hash, uint64_t value);
+    static uint64_t hashSourceFile(const std::string& filename);
+    static bool write(const std::string& filename, uint64_t sourceHash, const MeshCacheContents& contents);
+
+    /* ********************************************************************************************
+     * Public Constants
+     * ********************************************************************************************/
+    static const uint32_t           INDEX_ENCODING_DELTA_VARINT;
+    static const uint32_t           INDEX_ENCODING_RAW;
+    static const uint32_t           MAGIC;
+    static const uint32_t           VERSION;
+
+private:
+    /* ********************************************************************************************
+     * Private Attributes
+     * ********************************************************************************************/
+    const uint8_t*                  m_data;
+    const MeshCacheHeader*          m_header;
+    uint64_t                        m_size;
+
+    // Platform Handles ---------------------------------------------------------------------------/
+    void*                           m_fileHandle;
+    void*                           m_mappingHandle;
+};
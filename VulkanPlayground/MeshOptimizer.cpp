@@ -0,0 +1,422 @@
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+/* ************************************************************************************************
+ * Global Structs
+ * ************************************************************************************************/
+void OverdrawStats::merge(const OverdrawStats& other)
+{
+    coveredPixels += other.coveredPixels;
+    shadedPixels += other.shadedPixels;
+    overdraw = coveredPixels ? static_cast<double>(shadedPixels) / coveredPixels : 0.0;
+}
+
+/*! ***********************************************************************************************
+ * \class   MeshOptimizer
+ * \author  Leon Vincii
+ * \date    2026.10.16
+ * ************************************************************************************************/
+// Tipsify is tuned for a cache of this size; most desktop GPUs hold at least this many vertices.
+const uint32_t MeshOptimizer::DEFAULT_CACHE_SIZE = 16;
+// Clusters may be up to 5% worse in ACMR than the whole mesh before they are cut.
+const float MeshOptimizer::DEFAULT_OVERDRAW_THRESHOLD = 1.05f;
+
+/* ************************************************************************************************
+ * Public Functions
+ * ************************************************************************************************/
+OverdrawStats MeshOptimizer::analyzeOverdraw(const uint32_t* indices, size_t indexCount,
+    const std::vector<Vertex>& vertices, const glm::mat4& modelViewProj, uint32_t width, uint32_t height)
+{
+    std::vector<float> depthBuffer(static_cast<size_t>(width) * height, std::numeric_limits<float>::max());
+    OverdrawStats stats {};
+
+    for (size_t t = 0; t + 2 < indexCount; t += 3)
+    {
+        // Project the corners to framebuffer coordinates; Vulkan's framebuffer y points down, same
+        // as the flipped NDC y of our projection.
+        glm::vec3 screen[3];
+        bool behindCamera = false;
+        for (size_t k = 0; k < 3; ++ k)
+        {
+            uint32_t index = indices[t + k];
+            if (index >= vertices.size())
+            {
+                throw std::runtime_error("index buffer references a vertex that does not exist");
+            }
+
+            glm::vec4 clip = modelViewProj * glm::vec4(vertices[index].pos, 1.f);
+            if (clip.w <= 1e-5f)
+            {
+                behindCamera = true;
+                break;
+            }
+            screen[k] = glm::vec3(
+                (clip.x / clip.w * .5f + .5f) * width,
+                (clip.y / clip.w * .5f + .5f) * height,
+                clip.z / clip.w
+            );
+        }
+        // Near plane clipping is not needed for a camera that stays outside the mesh.
+        if (behindCamera) { continue; }
+
+        // Matches VK_FRONT_FACE_COUNTER_CLOCKWISE with back-face culling: front faces have a
+        // negative edge cross product in framebuffer coordinates.
+        float area = (screen[1].x - screen[0].x) * (screen[2].y - screen[0].y) -
+                     (screen[2].x - screen[0].x) * (screen[1].y - screen[0].y);
+        if (area >= 0.f) { continue; }
+        std::swap(screen[1], screen[2]);
+        area = -area;
+
+        int32_t minX = std::max(0, static_cast<int32_t>(std::floor(std::min({ screen[0].x, screen[1].x, screen[2].x }))));
+        int32_t minY = std::max(0, static_cast<int32_t>(std::floor(std::min({ screen[0].y, screen[1].y, screen[2].y }))));
+        int32_t maxX = std::min(static_cast<int32_t>(width) - 1, static_cast<int32_t>(std::ceil(std::max({ screen[0].x, screen[1].x, screen[2].x }))));
+        int32_t maxY = std::min(static_cast<int32_t>(height) - 1, static_cast<int32_t>(std::ceil(std::max({ screen[0].y, screen[1].y, screen[2].y }))));
+
+        for (int32_t y = minY; y <= maxY; ++ y)
+        {
+            for (int32_t x = minX; x <= maxX; ++ x)
+            {
+                // Sample at the pixel centre with edge functions; the weights sum to area.
+                float px = x + .5f, py = y + .5f;
+                float w0 = (screen[2].x - screen[1].x) * (py - screen[1].y) - (screen[2].y - screen[1].y) * (px - screen[1].x);
+                float w1 = (screen[0].x - screen[2].x) * (py - screen[2].y) - (screen[0].y - screen[2].y) * (px - screen[2].x);
+                float w2 = (screen[1].x - screen[0].x) * (py - screen[0].y) - (screen[1].y - screen[0].y) * (px - screen[0].x);
+                if (w0 < 0.f || w1 < 0.f || w2 < 0.f) { continue; }
+
+                float depth = (w0 * screen[0].z + w1 * screen[1].z + w2 * screen[2].z) / area;
+                if (depth < 0.f || depth > 1.f) { continue; }
+
+                float& stored = depthBuffer[static_cast<size_t>(y) * width + x];
+                if (depth < stored)
+                {
+                    if (stored == std::numeric_limits<float>::max()) { ++ stats.coveredPixels; }
+                    stored = depth;
+                    ++ stats.shadedPixels;
+                }
+            }
+        }
+    }
+
+    stats.overdraw = stats.coveredPixels ? static_cast<double>(stats.shadedPixels) / stats.coveredPixels : 0.0;
+    return stats;
+}
+
+VertexCacheStats MeshOptimizer::analyzeVertexCache(const uint32_t* indices, size_t indexCount,
+    size_t vertexCount, uint32_t cacheSize)
+{
+    // A vertex is in the FIFO if it was inserted less than cacheSize insertions ago, so storing the
+    // insertion timestamp per vertex is enough to simulate the cache without a queue.
+    std::vector<uint64_t> insertTime(vertexCount, 0);
+    std::vector<bool> referenced(vertexCount, false);
+    uint64_t time = static_cast<uint64_t>(cacheSize) + 1;
+    uint64_t misses = 0;
+    size_t referencedCount = 0;
+
+    for (size_t i = 0; i < indexCount; ++ i)
+    {
+        uint32_t index = indices[i];
+        if (index >= vertexCount)
+        {
+            throw std::runtime_error("index buffer references a vertex that does not exist");
+        }
+
+        if (time - insertTime[index] > cacheSize)
+        {
+            insertTime[index] = time ++;
+            ++ misses;
+        }
+        if (!referenced[index])
+        {
+            referenced[index] = true;
+            ++ referencedCount;
+        }
+    }
+
+    VertexCacheStats stats {};
+    stats.transformedVertexCount = misses;
+    stats.acmr = indexCount ? static_cast<double>(misses) / (indexCount / 3) : 0.0;
+    stats.atvr = referencedCount ? static_cast<double>(misses) / referencedCount : 0.0;
+    return stats;
+}
+
+void MeshOptimizer::optimizeOverdraw(uint32_t* indices, size_t indexCount, const std::vector<Vertex>& vertices,
+    uint32_t cacheSize, float threshold)
+{
+    /***
+     * View-independent overdraw reduction after Sander et al. 2007. The model spins in front of the
+     * camera, so rather than sorting for one view we cut the cache-optimized order into clusters
+     * and draw the clusters that face away from the mesh centre first: from any viewpoint those are
+     * the ones most likely to occlude the rest. Cutting only where the cluster's own ACMR is close to
+     * that of the whole mesh keeps most of the vertex cache benefit.
+     ***/
+    size_t triangleCount = indexCount / 3;
+    if (triangleCount == 0) { return; }
+
+    for (size_t i = 0; i < triangleCount * 3; ++ i)
+    {
+        if (indices[i] >= vertices.size())
+        {
+            throw std::runtime_error("index buffer references a vertex that does not exist");
+        }
+    }
+
+    std::vector<uint64_t> cacheTime(vertices.size(), 0);
+    uint64_t time = static_cast<uint64_t>(cacheSize) + 1;
+    auto countMisses = [&](size_t triangle) {
+        uint32_t misses = 0;
+        for (size_t k = 0; k < 3; ++ k)
+        {
+            uint32_t v = indices[3 * triangle + k];
+            if (time - cacheTime[v] > cacheSize)
+            {
+                cacheTime[v] = time ++;
+                ++ misses;
+            }
+        }
+        return misses;
+    };
+
+    // 1. Hard boundaries: triangles that miss on all three vertices start a new region anyway.
+    std::vector<size_t> hardBoundaries;
+    uint64_t totalMisses = 0;
+    for (size_t t = 0; t < triangleCount; ++ t)
+    {
+        uint32_t misses = countMisses(t);
+        if (t == 0 || misses == 3) { hardBoundaries.push_back(t); }
+        totalMisses += misses;
+    }
+    hardBoundaries.push_back(triangleCount);
+    double meshAcmr = static_cast<double>(totalMisses) / triangleCount;
+
+    // 2. Soft boundaries: inside each region, simulate from a cold cache and cut as soon as the
+    // cluster's ACMR has come down to within the threshold.
+    std::vector<size_t> clusters;
+    for (size_t h = 0; h + 1 < hardBoundaries.size(); ++ h)
+    {
+        size_t clusterStart = hardBoundaries[h];
+        uint64_t clusterMisses = 0;
+        time += cacheSize + 1;
+
+        for (size_t t = hardBoundaries[h]; t < hardBoundaries[h + 1]; ++ t)
+        {
+            clusterMisses += countMisses(t);
+            if (static_cast<double>(clusterMisses) / (t + 1 - clusterStart) <= threshold * meshAcmr &&
+                t + 1 < hardBoundaries[h + 1])
+            {
+                clusters.push_back(clusterStart);
+                clusterStart = t + 1;
+                clusterMisses = 0;
+                time += cacheSize + 1;
+            }
+        }
+        clusters.push_back(clusterStart);
+    }
+    clusters.push_back(triangleCount);
+
+    // 3. Area-weighted centroid and normal of every cluster and of the whole mesh.
+    size_t clusterCount = clusters.size() - 1;
+    std::vector<glm::vec3> clusterCentroids(clusterCount, glm::vec3(0.f));
+    std::vector<glm::vec3> clusterNormals(clusterCount, glm::vec3(0.f));
+    glm::vec3 meshCentroid(0.f);
+    float meshArea = 0.f;
+
+    for (size_t c = 0; c < clusterCount; ++ c)
+    {
+        float clusterArea = 0.f;
+        for (size_t t = clusters[c]; t < clusters[c + 1]; ++ t)
+        {
+            const glm::vec3& p0 = vertices[indices[3 * t + 0]].pos;
+            const glm::vec3& p1 = vertices[indices[3 * t + 1]].pos;
+            const glm::vec3& p2 = vertices[indices[3 * t + 2]].pos;
+
+            glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+            float area = glm::length(normal);
+            glm::vec3 centroid = (p0 + p1 + p2) / 3.f;
+
+            clusterCentroids[c] += centroid * area;
+            clusterNormals[c] += normal;
+            clusterArea += area;
+        }
+
+        meshCentroid += clusterCentroids[c];
+        meshArea += clusterArea;
+        clusterCentroids[c] = clusterArea > 0.f ? clusterCentroids[c] / clusterArea :
+            vertices[indices[3 * clusters[c]]].pos;
+    }
+    meshCentroid = meshArea > 0.f ? meshCentroid / meshArea : glm::vec3(0.f);
+
+    // 4. Sort the clusters by how far out along their own normal they sit, outermost first.
+    std::vector<float> sortKeys(clusterCount, 0.f);
+    for (size_t c = 0; c < clusterCount; ++ c)
+    {
+        float normalLength = glm::length(clusterNormals[c]);
+        if (normalLength > 0.f)
+        {
+            sortKeys[c] = glm::dot(clusterCentroids[c] - meshCentroid, clusterNormals[c] / normalLength);
+        }
+    }
+
+    std::vector<size_t> order(clusterCount);
+    for (size_t c = 0; c < clusterCount; ++ c) { order[c] = c; }
+    std::stable_sort(order.begin(), order.end(), [&sortKeys](size_t a, size_t b) { return sortKeys[a] > sortKeys[b]; });
+
+    std::vector<uint32_t> output;
+    output.reserve(triangleCount * 3);
+    for (size_t c : order)
+    {
+        output.insert(output.end(), indices + 3 * clusters[c], indices + 3 * clusters[c + 1]);
+    }
+    std::copy(output.begin(), output.end(), indices);
+}
+
+void MeshOptimizer::optimizeVertexCache(uint32_t* indices, size_t indexCount, size_t vertexCount,
+    uint32_t cacheSize)
+{
+    size_t triangleCount = indexCount / 3;
+    if (triangleCount == 0) { return; }
+
+    // Build the vertex to triangle adjacency as offsets into one flat array.
+    std::vector<uint32_t> liveTriangles(vertexCount, 0);
+    for (size_t i = 0; i < triangleCount * 3; ++ i)
+    {
+        if (indices[i] >= vertexCount)
+        {
+            throw std::runtime_error("index buffer references a vertex that does not exist");
+        }
+        ++ liveTriangles[indices[i]];
+    }
+
+    std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+    for (size_t v = 0; v < vertexCount; ++ v)
+    {
+        adjacencyOffsets[v + 1] = adjacencyOffsets[v] + liveTriangles[v];
+    }
+
+    std::vector<uint32_t> adjacency(triangleCount * 3);
+    {
+        std::vector<uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+        for (size_t i = 0; i < triangleCount * 3; ++ i)
+        {
+            adjacency[fill[indices[i]] ++] = static_cast<uint32_t>(i / 3);
+        }
+    }
+
+    /***
+     * Tipsify: fan around the current vertex, emitting all of its remaining triangles, then pick
+     * the next fanning vertex among the vertices just emitted, preferring those that will still be
+     * in the cache once their own remaining triangles are emitted. When no such vertex exists we
+     * fall back to the dead-end stack of recently used vertices and finally to a linear scan.
+     ***/
+    std::vector<uint32_t> output;
+    output.reserve(triangleCount * 3);
+
+    std::vector<uint64_t> cacheTime(vertexCount, 0);
+    std::vector<bool> emitted(triangleCount, false);
+    std::vector<uint32_t> deadEnd;
+    std::vector<uint32_t> candidates;
+    uint64_t time = static_cast<uint64_t>(cacheSize) + 1;
+    size_t scanCursor = 0;
+
+    int64_t fanVertex = 0;
+    while (fanVertex >= 0)
+    {
+        candidates.clear();
+
+        for (uint32_t a = adjacencyOffsets[fanVertex]; a < adjacencyOffsets[fanVertex + 1]; ++ a)
+        {
+            uint32_t triangle = adjacency[a];
+            if (emitted[triangle]) { continue; }
+
+            for (size_t k = 0; k < 3; ++ k)
+            {
+                uint32_t v = indices[3 * triangle + k];
+                output.push_back(v);
+                deadEnd.push_back(v);
+                candidates.push_back(v);
+                -- liveTriangles[v];
+                if (time - cacheTime[v] > cacheSize)
+                {
+                    cacheTime[v] = time ++;
+                }
+            }
+            emitted[triangle] = true;
+        }
+
+        // Choose the candidate that stays cached through its own fan and was cached longest ago.
+        fanVertex = -1;
+        int64_t bestPriority = -1;
+        for (uint32_t v : candidates)
+        {
+            if (liveTriangles[v] == 0) { continue; }
+
+            int64_t priority = 0;
+            if (time - cacheTime[v] + 2 * liveTriangles[v] <= cacheSize)
+            {
+                priority = static_cast<int64_t>(time - cacheTime[v]);
+            }
+            if (priority > bestPriority)
+            {
+                bestPriority = priority;
+                fanVertex = v;
+            }
+        }
+
+        if (fanVertex >= 0) { continue; }
+
+        // Dead end: try recently used vertices first, then any vertex with triangles left.
+        while (!deadEnd.empty())
+        {
+            uint32_t v = deadEnd.back();
+            deadEnd.pop_back();
+            if (liveTriangles[v] > 0)
+            {
+                fanVertex = v;
+                break;
+            }
+        }
+
+        while (fanVertex < 0 && scanCursor < vertexCount)
+        {
+            if (liveTriangles[scanCursor] > 0) { fanVertex = static_cast<int64_t>(scanCursor); }
+            else { ++ scanCursor; }
+        }
+    }
+
+    std::copy(output.begin(), output.end(), indices);
+}
+
+void MeshOptimizer::optimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices)
+{
+    // Number the vertices in the order the index buffer first touches them.
+    const uint32_t unused = ~0u;
+    std::vector<uint32_t> remap(vertices.size(), unused);
+    uint32_t nextIndex = 0;
+
+    for (uint32_t& index : indices)
+    {
+        if (index >= vertices.size())
+        {
+            throw std::runtime_error("index buffer references a vertex that does not exist");
+        }
+
+        if (remap[index] == unused)
+        {
+            remap[index] = nextIndex ++;
+        }
+        index = remap[index];
+    }
+
+    std::vector<Vertex> reordered(nextIndex);
+    for (size_t v = 0; v < vertices.size(); ++ v)
+    {
+        if (remap[v] != unused)
+        {
+            reordered[remap[v]] = vertices[v];
+        }
+    }
+    vertices.swap(reordered);
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "Vertex.h"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+/* ************************************************************************************************
+ * Global Structs
+ * ************************************************************************************************/
+struct VertexCacheStats
+{
+    uint64_t    transformedVertexCount;     // Cache misses, i.e. vertex shader invocations.
+    double      acmr;                       // Average cache miss ratio: misses per triangle.
+    double      atvr;                       // Average transform to vertex ratio: misses per vertex.
+};
+
+struct OverdrawStats
+{
+    uint64_t    coveredPixels;              // Pixels with at least one visible triangle.
+    uint64_t    shadedPixels;               // Fragments that passed the depth test when drawn.
+    double      overdraw;                   // Shaded fragments per covered pixel.
+
+    void merge(const OverdrawStats& other);
+};
+
+/*! ***********************************************************************************************
+ * \class   MeshOptimizer
+ * \brief   CPU-side index and vertex buffer reordering. Triangles are reordered for the GPU's
+ *          post-transform vertex cache with Tipsify (Sander et al. 2007), after which the vertices
+ *          are reordered into first-use order for fetch locality. Both passes are pure functions on
+ *          the buffers and need no device. Clusters of the cache-optimized order can additionally
+ *          be sorted outside-in to cut overdraw, which a small depth-testing software rasterizer
+ *          measures without a GPU.
+ * \author  Leon Vincii
+ * \date    2026.10.16
+ * ************************************************************************************************/
+class MeshOptimizer
+{
+public:
+    /* ********************************************************************************************
+     * Public Functions
+     * ********************************************************************************************/
+    // Rasterizes the back-face culled triangle list with a LESS depth test, counting the fragments
+    // that would be shaded with early depth testing. One sample per pixel is taken.
+    static OverdrawStats analyzeOverdraw(const uint32_t* indices, size_t indexCount,
+        const std::vector<Vertex>& vertices, const glm::mat4& modelViewProj, uint32_t width, uint32_t height);
+    // Simulates a FIFO post-transform cache of the given size over the triangle list.
+    static VertexCacheStats analyzeVertexCache(const uint32_t* indices, size_t indexCount,
+        size_t vertexCount, uint32_t cacheSize = DEFAULT_CACHE_SIZE);
+    // Sorts clusters of an already cache-optimized triangle list so that outward-facing clusters,
+    // which tend to occlude the rest of the mesh from any direction, are drawn first. Clusters are
+    // split wherever their own ACMR stays within threshold times that of the whole list.
+    static void optimizeOverdraw(uint32_t* indices, size_t indexCount, const std::vector<Vertex>& vertices,
+        uint32_t cacheSize = DEFAULT_CACHE_SIZE, float threshold = DEFAULT_OVERDRAW_THRESHOLD);
+    // Reorders the triangles in place; the set of triangles and their winding are preserved.
+    static void optimizeVertexCache(uint32_t* indices, size_t indexCount, size_t vertexCount,
+        uint32_t cacheSize = DEFAULT_CACHE_SIZE);
+    // Reorders the vertices by first use and remaps the indices; unreferenced vertices are dropped.
+    static void optimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices);
+
+    /* ********************************************************************************************
+     * Public Constants
+     * ********************************************************************************************/
+    static const uint32_t           DEFAULT_CACHE_SIZE;
+    static const float              DEFAULT_OVERDRAW_THRESHOLD;
+};
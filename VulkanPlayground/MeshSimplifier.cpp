@@ -0,0 +1,323 @@
+#include "MeshSimplifier.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <unordered_map>
+
+/* ************************************************************************************************
+ * Local Structs
+ * ************************************************************************************************/
+namespace
+{
+// Symmetric 3x3 matrix A, vector b and scalar c of the quadric Q(p) = p'Ap + 2b'p + c, plus the total
+// weight that went in, so that Q(p) / weight is a mean squared distance.
+struct Quadric
+{
+    float a00, a01, a02, a11, a12, a22;
+    float b0, b1, b2;
+    float c;
+    float weight;
+
+    void add(const Quadric& other)
+    {
+        a00 += other.a00; a01 += other.a01; a02 += other.a02;
+        a11 += other.a11; a12 += other.a12; a22 += other.a22;
+        b0 += other.b0; b1 += other.b1; b2 += other.b2;
+        c += other.c;
+        weight += other.weight;
+    }
+
+    float evaluate(const glm::vec3& p) const
+    {
+        float result =
+            a00 * p.x * p.x + a11 * p.y * p.y + a22 * p.z * p.z +
+            2.f * (a01 * p.x * p.y + a02 * p.x * p.z + a12 * p.y * p.z) +
+            2.f * (b0 * p.x + b1 * p.y + b2 * p.z) + c;
+        return std::max(result, 0.f);
+    }
+
+    static Quadric fromPlane(const glm::vec3& normal, float distance, float weight)
+    {
+        Quadric q;
+        q.a00 = weight * normal.x * normal.x;
+        q.a01 = weight * normal.x * normal.y;
+        q.a02 = weight * normal.x * normal.z;
+        q.a11 = weight * normal.y * normal.y;
+        q.a12 = weight * normal.y * normal.z;
+        q.a22 = weight * normal.z * normal.z;
+        q.b0 = weight * normal.x * distance;
+        q.b1 = weight * normal.y * distance;
+        q.b2 = weight * normal.z * distance;
+        q.c = weight * distance * distance;
+        q.weight = weight;
+        return q;
+    }
+};
+
+struct Collapse
+{
+    uint32_t    source;
+    uint32_t    target;
+    float       error;              // Squared, as a mean over the combined quadric.
+};
+
+glm::vec3 triangleNormal(const glm::vec3& p0, const glm::vec3& p1, const glm::vec3& p2)
+{
+    return glm::cross(p1 - p0, p2 - p0);
+}
+}
+
+/*! ***********************************************************************************************
+ * \class   MeshSimplifier
+ * \author  Leon Vincii
+ * \date    2026.10.16
+ * ************************************************************************************************/
+/* ************************************************************************************************
+ * Public Functions
+ * ************************************************************************************************/
+void MeshSimplifier::buildLodChain(const std::vector<Vertex>& vertices, std::vector<uint32_t>& indices,
+    std::vector<MeshLod>& lods, uint32_t maxLodCount, float errorLimit)
+{
+    lods.clear();
+    lods.push_back(MeshLod { 0, static_cast<uint32_t>(indices.size()), 0.f, 0.f });
+
+    // Each level is simplified from the previous one, which is much cheaper than starting from
+    // LOD 0 every time; the errors of the steps add up to a conservative total.
+    std::vector<uint32_t> source(indices);
+    std::vector<uint32_t> simplified;
+    float totalError = 0.f;
+
+    while (lods.size() < maxLodCount)
+    {
+        size_t targetIndexCount = source.size() / 6 * 3;
+        float error = simplify(vertices, source.data(), source.size(), targetIndexCount, errorLimit - totalError, simplified);
+
+        // Stop once simplification stalls; a level that saves less than a tenth is not worth it.
+        if (simplified.empty() || simplified.size() * 10 > source.size() * 9) { break; }
+
+        totalError += error;
+        lods.push_back(MeshLod {
+            static_cast<uint32_t>(indices.size()), static_cast<uint32_t>(simplified.size()), totalError, 0.f
+        });
+        indices.insert(indices.end(), simplified.begin(), simplified.end());
+        source.swap(simplified);
+    }
+}
+
+uint32_t MeshSimplifier::selectLod(const std::vector<MeshLod>& lods, const glm::vec4& boundingSphere,
+    const glm::mat4& modelView, const glm::mat4& proj, float viewportHeight, float pixelError)
+{
+    /***
+     * An error of e model units at view depth z covers e * proj[1][1] / z in NDC, and NDC spans two
+     * units over the viewport height. The sphere's nearest point is used as the depth so that the
+     * estimate never undershoots, and the model-view scale converts the error to view units.
+     ***/
+    glm::vec4 center = modelView * glm::vec4(glm::vec3(boundingSphere), 1.f);
+    float scale = std::max({
+        glm::length(glm::vec3(modelView[0])), glm::length(glm::vec3(modelView[1])), glm::length(glm::vec3(modelView[2]))
+    });
+    float distance = glm::length(glm::vec3(center)) - boundingSphere.w * scale;
+    if (distance <= 0.f) { return 0; }
+
+    float pixelsPerUnit = std::abs(proj[1][1]) * viewportHeight * .5f * scale / distance;
+
+    uint32_t selected = 0;
+    for (uint32_t i = 1; i < lods.size(); ++ i)
+    {
+        if (lods[i].error * pixelsPerUnit > pixelError) { break; }
+        selected = i;
+    }
+    return selected;
+}
+
+float MeshSimplifier::simplify(const std::vector<Vertex>& vertices, const uint32_t* indices, size_t indexCount,
+    size_t targetIndexCount, float targetError, std::vector<uint32_t>& result)
+{
+    size_t vertexCount = vertices.size();
+    result.assign(indices, indices + indexCount / 3 * 3);
+
+    for (uint32_t index : result)
+    {
+        if (index >= vertexCount)
+        {
+            throw std::runtime_error("index buffer references a vertex that does not exist");
+        }
+    }
+
+    // 1. Weld vertices by position: several vertices with one position mark an attribute seam.
+    std::vector<uint32_t> order(vertexCount);
+    for (uint32_t v = 0; v < vertexCount; ++ v) { order[v] = v; }
+    std::sort(order.begin(), order.end(), [&vertices](uint32_t a, uint32_t b) {
+        const glm::vec3& pa = vertices[a].pos;
+        const glm::vec3& pb = vertices[b].pos;
+        return pa.x != pb.x ? pa.x < pb.x : (pa.y != pb.y ? pa.y < pb.y : pa.z < pb.z);
+    });
+
+    std::vector<uint32_t> positionGroup(vertexCount, 0);
+    std::vector<bool> locked(vertexCount, false);
+    for (size_t begin = 0, end = 0; begin < vertexCount; begin = end)
+    {
+        end = begin + 1;
+        while (end < vertexCount && vertices[order[end]].pos == vertices[order[begin]].pos) { ++ end; }
+        for (size_t i = begin; i < end; ++ i)
+        {
+            positionGroup[order[i]] = order[begin];
+            locked[order[i]] = end - begin > 1;
+        }
+    }
+
+    // 2. Lock vertices on open borders: edges of the welded mesh with only one triangle.
+    {
+        std::unordered_map<uint64_t, uint32_t> edgeCounts;
+        edgeCounts.reserve(result.size());
+        auto edgeKey = [&](uint32_t a, uint32_t b) {
+            uint64_t ga = positionGroup[a], gb = positionGroup[b];
+            return ga < gb ? (ga << 32) | gb : (gb << 32) | ga;
+        };
+        for (size_t t = 0; t < result.size(); t += 3)
+        {
+            for (size_t k = 0; k < 3; ++ k)
+            {
+                ++ edgeCounts[edgeKey(result[t + k], result[t + (k + 1) % 3])];
+            }
+        }
+        for (size_t t = 0; t < result.size(); t += 3)
+        {
+            for (size_t k = 0; k < 3; ++ k)
+            {
+                uint32_t a = result[t + k], b = result[t + (k + 1) % 3];
+                if (edgeCounts[edgeKey(a, b)] == 1)
+                {
+                    locked[a] = true;
+                    locked[b] = true;
+                }
+            }
+        }
+    }
+
+    // 3. Area-weighted plane quadrics of the triangles around every vertex.
+    std::vector<Quadric> quadrics(vertexCount, Quadric {});
+    for (size_t t = 0; t < result.size(); t += 3)
+    {
+        const glm::vec3& p0 = vertices[result[t + 0]].pos;
+        const glm::vec3& p1 = vertices[result[t + 1]].pos;
+        const glm::vec3& p2 = vertices[result[t + 2]].pos;
+
+        glm::vec3 normal = triangleNormal(p0, p1, p2);
+        float area = glm::length(normal);
+        if (area <= 0.f) { continue; }
+        normal /= area;
+
+        Quadric q = Quadric::fromPlane(normal, -glm::dot(normal, p0), area);
+        for (size_t k = 0; k < 3; ++ k) { quadrics[result[t + k]].add(q); }
+    }
+
+    // 4. Collapse in passes. Each pass sorts all edge collapses by error and applies the cheapest
+    // ones whose neighbourhoods do not overlap, so that the flip test of one collapse is not
+    // invalidated by another collapse in the same pass.
+    float targetErrorSquared = targetError * targetError;
+    float maxErrorSquared = 0.f;
+    std::vector<uint32_t> remap(vertexCount);
+    std::vector<bool> touched(vertexCount);
+    std::vector<uint32_t> adjacencyOffsets(vertexCount + 1);
+    std::vector<uint32_t> adjacency;
+    std::vector<Collapse> collapses;
+
+    while (result.size() > targetIndexCount)
+    {
+        // Vertex to triangle adjacency of the current triangle list.
+        std::fill(adjacencyOffsets.begin(), adjacencyOffsets.end(), 0);
+        for (uint32_t index : result) { ++ adjacencyOffsets[index + 1]; }
+        for (size_t v = 0; v < vertexCount; ++ v) { adjacencyOffsets[v + 1] += adjacencyOffsets[v]; }
+        adjacency.resize(result.size());
+        {
+            std::vector<uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+            for (size_t i = 0; i < result.size(); ++ i) { adjacency[fill[result[i]] ++] = static_cast<uint32_t>(i / 3); }
+        }
+
+        collapses.clear();
+        for (size_t t = 0; t < result.size(); t += 3)
+        {
+            for (size_t k = 0; k < 3; ++ k)
+            {
+                uint32_t a = result[t + k], b = result[t + (k + 1) % 3];
+                for (int direction = 0; direction < 2; ++ direction)
+                {
+                    uint32_t source = direction ? b : a;
+                    uint32_t target = direction ? a : b;
+                    if (locked[source]) { continue; }
+
+                    Quadric q = quadrics[source];
+                    q.add(quadrics[target]);
+                    float error = q.weight > 0.f ? q.evaluate(vertices[target].pos) / q.weight : 0.f;
+                    if (error <= targetErrorSquared) { collapses.push_back(Collapse { source, target, error }); }
+                }
+            }
+        }
+        if (collapses.empty()) { break; }
+
+        std::sort(collapses.begin(), collapses.end(), [](const Collapse& a, const Collapse& b) { return a.error < b.error; });
+
+        for (uint32_t v = 0; v < vertexCount; ++ v) { remap[v] = v; }
+        std::fill(touched.begin(), touched.end(), false);
+
+        // An interior collapse removes two triangles; stop once the target would be reached.
+        size_t trianglesToRemove = (result.size() - targetIndexCount) / 3;
+        size_t trianglesRemoved = 0;
+
+        for (const Collapse& collapse : collapses)
+        {
+            if (trianglesRemoved >= trianglesToRemove) { break; }
+            if (touched[collapse.source] || touched[collapse.target]) { continue; }
+
+            // Reject collapses that would flip or degenerate any remaining triangle around source.
+            const glm::vec3& targetPosition = vertices[collapse.target].pos;
+            bool flips = false;
+            for (uint32_t a = adjacencyOffsets[collapse.source]; a < adjacencyOffsets[collapse.source + 1] && !flips; ++ a)
+            {
+                const uint32_t* triangle = &result[3 * adjacency[a]];
+                if (triangle[0] == collapse.target || triangle[1] == collapse.target || triangle[2] == collapse.target) { continue; }
+
+                glm::vec3 before[3], after[3];
+                for (size_t k = 0; k < 3; ++ k)
+                {
+                    before[k] = vertices[triangle[k]].pos;
+                    after[k] = triangle[k] == collapse.source ? targetPosition : before[k];
+                }
+                glm::vec3 normalBefore = triangleNormal(before[0], before[1], before[2]);
+                glm::vec3 normalAfter = triangleNormal(after[0], after[1], after[2]);
+                float lengths = glm::length(normalBefore) * glm::length(normalAfter);
+                flips = lengths <= 0.f || glm::dot(normalBefore, normalAfter) < .25f * lengths;
+            }
+            if (flips) { continue; }
+
+            remap[collapse.source] = collapse.target;
+            quadrics[collapse.target].add(quadrics[collapse.source]);
+            maxErrorSquared = std::max(maxErrorSquared, collapse.error);
+            trianglesRemoved += 2;
+
+            // Freeze the whole one-ring of source for the rest of this pass.
+            for (uint32_t a = adjacencyOffsets[collapse.source]; a < adjacencyOffsets[collapse.source + 1]; ++ a)
+            {
+                const uint32_t* triangle = &result[3 * adjacency[a]];
+                touched[triangle[0]] = touched[triangle[1]] = touched[triangle[2]] = true;
+            }
+        }
+        if (trianglesRemoved == 0) { break; }
+
+        // Apply the collapses and drop the triangles that became degenerate.
+        size_t writeIndex = 0;
+        for (size_t t = 0; t < result.size(); t += 3)
+        {
+            uint32_t a = remap[result[t + 0]], b = remap[result[t + 1]], c = remap[result[t + 2]];
+            if (a == b || b == c || c == a) { continue; }
+            result[writeIndex ++] = a;
+            result[writeIndex ++] = b;
+            result[writeIndex ++] = c;
+        }
+        result.resize(writeIndex);
+    }
+
+    return std::sqrt(maxErrorSquared);
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "Vertex.h"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+/* ************************************************************************************************
+ * Global Structs
+ * ************************************************************************************************/
+// One level of detail: a range of the shared index buffer, drawn with the shared vertex buffer.
+struct MeshLod
+{
+    uint32_t    firstIndex;
+    uint32_t    indexCount;
+    float       error;              // Approximate geometric deviation from LOD 0, in model units.
+    float       reserved;
+};
+
+/*! ***********************************************************************************************
+ * \class   MeshSimplifier
+ * \brief   Quadric error metric (Garland & Heckbert) edge collapse simplifier. Vertices are only
+ *          ever collapsed onto other existing vertices, so every level of detail indexes into the
+ *          same vertex buffer. Vertices on open borders and on attribute seams (several vertices
+ *          sharing one position) are locked in place to keep the silhouette and the texture
+ *          mapping free of cracks.
+ * \author  Leon Vincii
+ * \date    2026.10.16
+ * ************************************************************************************************/
+class MeshSimplifier
+{
+public:
+    /* ********************************************************************************************
+     * Public Functions
+     * ********************************************************************************************/
+    // Appends coarser levels to indices, which holds LOD 0 on entry, halving the triangle count
+    // per level until maxLodCount levels exist, errorLimit is reached or a level stops shrinking.
+    static void buildLodChain(const std::vector<Vertex>& vertices, std::vector<uint32_t>& indices,
+        std::vector<MeshLod>& lods, uint32_t maxLodCount, float errorLimit);
+    // Picks the coarsest level whose error, projected for an object with the given bounding sphere
+    // (xyz: center, w: radius, in model space), stays below pixelError pixels on screen.
+    static uint32_t selectLod(const std::vector<MeshLod>& lods, const glm::vec4& boundingSphere,
+        const glm::mat4& modelView, const glm::mat4& proj, float viewportHeight, float pixelError);
+    // Simplifies towards targetIndexCount without exceeding targetError; returns the error reached.
+    static float simplify(const std::vector<Vertex>& vertices, const uint32_t* indices, size_t indexCount,
+        size_t targetIndexCount, float targetError, std::vector<uint32_t>& result);
+};
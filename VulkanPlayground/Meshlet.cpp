@@ -0,0 +1,181 @@
+#include "Meshlet.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+/*! ***********************************************************************************************
+ * \class   MeshletBuilder
+ * \author  Leon Vincii
+ * \date    2026.10.16
+ * ************************************************************************************************/
+// 64 vertices and 124 triangles fit the usual mesh shader output limits and keep the local
+// triangle list of a full meshlet a multiple of four bytes (124 * 3 = 372).
+const uint32_t MeshletBuilder::MAX_TRIANGLES = 124;
+const uint32_t MeshletBuilder::MAX_VERTICES = 64;
+
+/* ************************************************************************************************
+ * Public Functions
+ * ************************************************************************************************/
+void MeshletBuilder::build(const std::vector<Vertex>& vertices, const uint32_t* indices, size_t indexCount,
+    std::vector<Meshlet>& meshlets, std::vector<uint32_t>& meshletVertices,
+    std::vector<uint8_t>& meshletTriangles)
+{
+    meshlets.clear();
+    meshletVertices.clear();
+    meshletTriangles.clear();
+
+    size_t triangleCount = indexCount / 3;
+    meshlets.reserve(triangleCount / MAX_TRIANGLES + 1);
+    meshletVertices.reserve(triangleCount);
+    meshletTriangles.reserve(triangleCount * 3);
+
+    // Local number of every mesh vertex inside the meshlet being built, or 0xff if it is not in it.
+    const uint8_t unused = 0xff;
+    std::vector<uint8_t> localIndex(vertices.size(), unused);
+
+    Meshlet meshlet {};
+    auto flush = [&]() {
+        if (meshlet.triangleCount == 0) { return; }
+
+        computeBounds(meshlet, vertices, meshletVertices, meshletTriangles);
+        for (uint32_t v = 0; v < meshlet.vertexCount; ++ v)
+        {
+            localIndex[meshletVertices[meshlet.vertexOffset + v]] = unused;
+        }
+        meshlets.push_back(meshlet);
+
+        meshlet = Meshlet {};
+        meshlet.vertexOffset = static_cast<uint32_t>(meshletVertices.size());
+        meshlet.triangleOffset = static_cast<uint32_t>(meshletTriangles.size());
+    };
+
+    for (size_t t = 0; t < triangleCount; ++ t)
+    {
+        const uint32_t* triangle = indices + 3 * t;
+        uint32_t newVertices = 0;
+        for (size_t k = 0; k < 3; ++ k)
+        {
+            if (triangle[k] >= vertices.size())
+            {
+                throw std::runtime_error("index buffer references a vertex that does not exist");
+            }
+            newVertices += localIndex[triangle[k]] == unused ? 1 : 0;
+        }
+        // Repeated corners of a degenerate triangle would be counted twice, which is harmless.
+
+        if (meshlet.vertexCount + newVertices > MAX_VERTICES || meshlet.triangleCount + 1 > MAX_TRIANGLES)
+        {
+            flush();
+        }
+
+        for (size_t k = 0; k < 3; ++ k)
+        {
+            uint8_t& local = localIndex[triangle[k]];
+            if (local == unused)
+            {
+                local = static_cast<uint8_t>(meshlet.vertexCount ++);
+                meshletVertices.push_back(triangle[k]);
+            }
+            meshletTriangles.push_back(local);
+        }
+        ++ meshlet.triangleCount;
+    }
+    flush();
+}
+
+/* ************************************************************************************************
+ * Private Functions
+ * ************************************************************************************************/
+void MeshletBuilder::computeBounds(Meshlet& meshlet, const std::vector<Vertex>& vertices,
+    const std::vector<uint32_t>& meshletVertices, const std::vector<uint8_t>& meshletTriangles)
+{
+    auto position = [&](uint32_t local) -> const glm::vec3& {
+        return vertices[meshletVertices[meshlet.vertexOffset + local]].pos;
+    };
+
+    // Bounding sphere with Ritter's method: start from two far apart vertices, then grow the sphere
+    // to take in every vertex left outside.
+    glm::vec3 first = position(0);
+    glm::vec3 second = first;
+    glm::vec3 third = first;
+    for (uint32_t v = 0; v < meshlet.vertexCount; ++ v)
+    {
+        if (glm::dot(position(v) - first, position(v) - first) > glm::dot(second - first, second - first)) { second = position(v); }
+    }
+    for (uint32_t v = 0; v < meshlet.vertexCount; ++ v)
+    {
+        if (glm::dot(position(v) - second, position(v) - second) > glm::dot(third - second, third - second)) { third = position(v); }
+    }
+
+    glm::vec3 center = (second + third) * .5f;
+    float radius = glm::length(third - second) * .5f;
+    for (uint32_t v = 0; v < meshlet.vertexCount; ++ v)
+    {
+        float distance = glm::length(position(v) - center);
+        if (distance > radius)
+        {
+            float grownRadius = (radius + distance) * .5f;
+            center += (position(v) - center) * ((grownRadius - radius) / distance);
+            radius = grownRadius;
+        }
+    }
+
+    // Normal cone: the axis is the average triangle normal, the spread is the largest angle between
+    // the axis and any triangle normal.
+    std::vector<glm::vec3> normals(meshlet.triangleCount);
+    std::vector<glm::vec3> centroids(meshlet.triangleCount);
+    glm::vec3 axis(0.f);
+    for (uint32_t t = 0; t < meshlet.triangleCount; ++ t)
+    {
+        const uint8_t* triangle = &meshletTriangles[meshlet.triangleOffset + 3 * t];
+        const glm::vec3& p0 = position(triangle[0]);
+        const glm::vec3& p1 = position(triangle[1]);
+        const glm::vec3& p2 = position(triangle[2]);
+
+        glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+        float length = glm::length(normal);
+        normals[t] = length > 0.f ? normal / length : glm::vec3(0.f);
+        centroids[t] = (p0 + p1 + p2) / 3.f;
+        axis += normals[t];
+    }
+
+    float axisLength = glm::length(axis);
+    axis = axisLength > 0.f ? axis / axisLength : glm::vec3(1.f, 0.f, 0.f);
+
+    float minDot = 1.f;
+    for (uint32_t t = 0; t < meshlet.triangleCount; ++ t)
+    {
+        if (normals[t] != glm::vec3(0.f)) { minDot = std::min(minDot, glm::dot(normals[t], axis)); }
+    }
+
+    float cutoff = 2.f;
+    glm::vec3 apex = center;
+    // A cone wider than about 84 degrees half-angle cannot reject anything useful; a cutoff above
+    // one never passes the test, so such meshlets are simply never backface culled.
+    if (axisLength > 0.f && minDot > .1f)
+    {
+        cutoff = std::sqrt(1.f - minDot * minDot);
+
+        // Move the apex back along the axis until every triangle plane lies in front of it, so that
+        // the test stays conservative for cameras close to the meshlet.
+        float maxDistance = 0.f;
+        for (uint32_t t = 0; t < meshlet.triangleCount; ++ t)
+        {
+            float normalDot = glm::dot(normals[t], axis);
+            if (normalDot <= 0.f) { continue; }
+            float distance = glm::dot(center - centroids[t], normals[t]) / normalDot;
+            maxDistance = std::max(maxDistance, distance);
+        }
+        apex = center - axis * maxDistance;
+    }
+
+    for (int k = 0; k < 3; ++ k)
+    {
+        meshlet.center[k] = center[k];
+        meshlet.coneAxis[k] = axis[k];
+        meshlet.coneApex[k] = apex[k];
+    }
+    meshlet.radius = radius;
+    meshlet.coneCutoff = cutoff;
+}
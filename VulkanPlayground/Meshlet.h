@@ -0,0 +1,60 @@
+#pragma once
+
+#include "Vertex.h"
+
+#include <cstdint>
+#include <vector>
+
+/* ************************************************************************************************
+ * Global Structs
+ * ************************************************************************************************/
+// Plain-old-data so that it can be stored in the mesh cache and uploaded with std430 layout as is.
+struct Meshlet
+{
+    uint32_t    vertexOffset;       // First entry of this meshlet in the meshlet vertex list.
+    uint32_t    triangleOffset;     // First byte of this meshlet in the meshlet triangle list.
+    uint32_t    vertexCount;
+    uint32_t    triangleCount;
+    // Culling ----------------------------------------------------------------------------------/
+    float       center[3];          // Bounding sphere.
+    float       radius;
+    float       coneAxis[3];        // Normal cone: the meshlet is back-facing for a camera at c when
+    float       coneCutoff;         // dot(normalize(coneApex - c), coneAxis) >= coneCutoff.
+    float       coneApex[3];
+    float       reserved;
+};
+
+/*! ***********************************************************************************************
+ * \class   MeshletBuilder
+ * \brief   Splits a triangle list into meshlets of at most MAX_VERTICES vertices and MAX_TRIANGLES
+ *          triangles. Every meshlet owns a range of the meshlet vertex list, which maps local
+ *          vertex numbers to the mesh's vertex buffer, and a range of the meshlet triangle list,
+ *          which holds three local vertex numbers per triangle. Each meshlet also gets a bounding
+ *          sphere and a normal cone for frustum and backface culling of whole clusters.
+ * \author  Leon Vincii
+ * \date    2026.10.16
+ * ************************************************************************************************/
+class MeshletBuilder
+{
+public:
+    /* ********************************************************************************************
+     * Public Functions
+     * ********************************************************************************************/
+    // Triangles are taken in index buffer order, so the input should already be cache-optimized.
+    static void build(const std::vector<Vertex>& vertices, const uint32_t* indices, size_t indexCount,
+        std::vector<Meshlet>& meshlets, std::vector<uint32_t>& meshletVertices,
+        std::vector<uint8_t>& meshletTriangles);
+
+    /* ********************************************************************************************
+     * Public Constants
+     * ********************************************************************************************/
+    static const uint32_t           MAX_TRIANGLES;
+    static const uint32_t           MAX_VERTICES;
+
+private:
+    /* ********************************************************************************************
+     * Private Functions
+     * ********************************************************************************************/
+    static void computeBounds(Meshlet& meshlet, const std::vector<Vertex>& vertices,
+        const std::vector<uint32_t>& meshletVertices, const std::vector<uint8_t>& meshletTriangles);
+};
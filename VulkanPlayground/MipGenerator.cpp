@@ -0,0 +1,294 @@
+#include "MipGenerator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#include <arm_neon.h>
+#endif
+
+/* ************************************************************************************************
+ * Local Functions
+ * ************************************************************************************************/
+namespace
+{
+// Linear values are converted back to sRGB by looking up the top bits of their float representation
+// in the range [2^-13, 1): 13 exponents with 10 mantissa bits each. Anything darker rounds to zero.
+const uint32_t LINEAR_MIN_BITS = 0x39000000;    // 2^-13
+const uint32_t LINEAR_MAX_BITS = 0x3f7fffff;    // largest float below 1
+const int LINEAR_INDEX_SHIFT = 13;
+const size_t TO_SRGB_SIZE = ((LINEAR_MAX_BITS - LINEAR_MIN_BITS) >> LINEAR_INDEX_SHIFT) + 1;
+
+// Texels per task; smaller levels are not worth splitting.
+const size_t TEXELS_PER_TASK = 64 * 1024;
+
+struct ConversionTables
+{
+    // [0, 256) sRGB to linear for color, [256, 512) the plain value for alpha.
+    float                           toLinear[512];
+    uint8_t                         toSrgb[TO_SRGB_SIZE];
+};
+
+float toFloat(uint32_t bits)
+{
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+const ConversionTables& getConversionTables()
+{
+    static const ConversionTables tables = []() {
+        ConversionTables values {};
+        for (size_t i = 0; i < 256; ++ i)
+        {
+            float c = static_cast<float>(i) / 255.f;
+            values.toLinear[i] = c <= .04045f ? c / 12.92f : std::pow((c + .055f) / 1.055f, 2.4f);
+            values.toLinear[256 + i] = static_cast<float>(i);
+        }
+
+        // Each entry holds the rounded sRGB value at the center of its bucket.
+        for (size_t i = 0; i < TO_SRGB_SIZE; ++ i)
+        {
+            uint32_t bits = LINEAR_MIN_BITS + (static_cast<uint32_t>(i) << LINEAR_INDEX_SHIFT) +
+                (1u << (LINEAR_INDEX_SHIFT - 1));
+            double linear = toFloat(bits);
+            double c = linear <= .0031308 ? linear * 12.92 : 1.055 * std::pow(linear, 1.0 / 2.4) - .055;
+            values.toSrgb[i] = static_cast<uint8_t>(std::min(c * 255.0 + .5, 255.0));
+        }
+        return values;
+    }();
+    return tables;
+}
+
+// Converts a row of texels to floats: linear color, alpha as is.
+void decodeRow(const uint8_t* row, uint32_t width, float* out, const ConversionTables& tables)
+{
+    for (size_t i = 0; i < static_cast<size_t>(width) * 4; i += 4)
+    {
+        out[i] = tables.toLinear[row[i]];
+        out[i + 1] = tables.toLinear[row[i + 1]];
+        out[i + 2] = tables.toLinear[row[i + 2]];
+        out[i + 3] = tables.toLinear[256 + row[i + 3]];
+    }
+}
+
+// Averages the 2x2 decoded texels t00, t01, t10 and t11 into out. The SIMD paths below repeat
+// exactly these operations, lane by lane, and fall back to this for the texels they do not cover.
+void averageTexel(const float* t00, const float* t01, const float* t10, const float* t11, uint8_t* out,
+    const ConversionTables& tables)
+{
+    const float linearMin = toFloat(LINEAR_MIN_BITS);
+    const float linearMax = toFloat(LINEAR_MAX_BITS);
+
+    for (size_t c = 0; c < 3; ++ c)
+    {
+        float mean = ((t00[c] + t01[c]) + (t10[c] + t11[c])) * .25f;
+        float clamped = std::min(std::max(mean, linearMin), linearMax);
+        uint32_t bits;
+        std::memcpy(&bits, &clamped, sizeof(bits));
+        out[c] = tables.toSrgb[(bits - LINEAR_MIN_BITS) >> LINEAR_INDEX_SHIFT];
+    }
+
+    float alpha = ((t00[3] + t01[3]) + (t10[3] + t11[3])) * .25f;
+    out[3] = static_cast<uint8_t>(alpha + .5f);
+}
+
+// Averages one destination row from two decoded source rows whose taps are all in range, i.e. a
+// source width of at least 2.
+void averageRow(const float* row0, const float* row1, uint8_t* out, uint32_t width, const ConversionTables& tables)
+{
+    uint32_t x = 0;
+    alignas(32) uint32_t results[8];
+
+#if defined(__AVX2__)
+    // Two texels per iteration; each load covers one texel's pair of horizontal taps.
+    const __m256 quarter = _mm256_set1_ps(.25f);
+    const __m256 half = _mm256_set1_ps(.5f);
+    const __m256 linearMin = _mm256_set1_ps(toFloat(LINEAR_MIN_BITS));
+    const __m256 linearMax = _mm256_set1_ps(toFloat(LINEAR_MAX_BITS));
+    const __m256i minBits = _mm256_set1_epi32(static_cast<int>(LINEAR_MIN_BITS));
+
+    for (; x + 2 <= width; x += 2)
+    {
+        __m256 row0Left = _mm256_loadu_ps(row0 + x * 8);
+        __m256 row0Right = _mm256_loadu_ps(row0 + x * 8 + 8);
+        __m256 row1Left = _mm256_loadu_ps(row1 + x * 8);
+        __m256 row1Right = _mm256_loadu_ps(row1 + x * 8 + 8);
+        __m256 t00 = _mm256_permute2f128_ps(row0Left, row0Right, 0x20);
+        __m256 t01 = _mm256_permute2f128_ps(row0Left, row0Right, 0x31);
+        __m256 t10 = _mm256_permute2f128_ps(row1Left, row1Right, 0x20);
+        __m256 t11 = _mm256_permute2f128_ps(row1Left, row1Right, 0x31);
+        __m256 mean = _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(t00, t01), _mm256_add_ps(t10, t11)), quarter);
+
+        // Color lanes become table indices, alpha lanes (3 and 7) the rounded value.
+        __m256 clamped = _mm256_min_ps(_mm256_max_ps(mean, linearMin), linearMax);
+        __m256i indices = _mm256_srli_epi32(_mm256_sub_epi32(_mm256_castps_si256(clamped), minBits), LINEAR_INDEX_SHIFT);
+        __m256i alpha = _mm256_cvttps_epi32(_mm256_add_ps(mean, half));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(results), _mm256_blend_epi32(indices, alpha, 0x88));
+
+        uint8_t* texels = out + x * 4;
+        texels[0] = tables.toSrgb[results[0]];
+        texels[1] = tables.toSrgb[results[1]];
+        texels[2] = tables.toSrgb[results[2]];
+        texels[3] = static_cast<uint8_t>(results[3]);
+        texels[4] = tables.toSrgb[results[4]];
+        texels[5] = tables.toSrgb[results[5]];
+        texels[6] = tables.toSrgb[results[6]];
+        texels[7] = static_cast<uint8_t>(results[7]);
+    }
+#elif defined(__SSE2__) || defined(_M_X64)
+    // One texel per iteration, all four channels at once.
+    const __m128 quarter = _mm_set1_ps(.25f);
+    const __m128 half = _mm_set1_ps(.5f);
+    const __m128 linearMin = _mm_set1_ps(toFloat(LINEAR_MIN_BITS));
+    const __m128 linearMax = _mm_set1_ps(toFloat(LINEAR_MAX_BITS));
+    const __m128i minBits = _mm_set1_epi32(static_cast<int>(LINEAR_MIN_BITS));
+
+    for (; x < width; ++ x)
+    {
+        __m128 t00 = _mm_loadu_ps(row0 + x * 8);
+        __m128 t01 = _mm_loadu_ps(row0 + x * 8 + 4);
+        __m128 t10 = _mm_loadu_ps(row1 + x * 8);
+        __m128 t11 = _mm_loadu_ps(row1 + x * 8 + 4);
+        __m128 mean = _mm_mul_ps(_mm_add_ps(_mm_add_ps(t00, t01), _mm_add_ps(t10, t11)), quarter);
+
+        __m128 clamped = _mm_min_ps(_mm_max_ps(mean, linearMin), linearMax);
+        __m128i indices = _mm_srli_epi32(_mm_sub_epi32(_mm_castps_si128(clamped), minBits), LINEAR_INDEX_SHIFT);
+        _mm_store_si128(reinterpret_cast<__m128i*>(results), indices);
+        _mm_store_si128(reinterpret_cast<__m128i*>(results + 4), _mm_cvttps_epi32(_mm_add_ps(mean, half)));
+
+        uint8_t* texel = out + x * 4;
+        texel[0] = tables.toSrgb[results[0]];
+        texel[1] = tables.toSrgb[results[1]];
+        texel[2] = tables.toSrgb[results[2]];
+        texel[3] = static_cast<uint8_t>(results[7]);
+    }
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+    // One texel per iteration, all four channels at once.
+    const float32x4_t linearMin = vdupq_n_f32(toFloat(LINEAR_MIN_BITS));
+    const float32x4_t linearMax = vdupq_n_f32(toFloat(LINEAR_MAX_BITS));
+    const uint32x4_t minBits = vdupq_n_u32(LINEAR_MIN_BITS);
+
+    for (; x < width; ++ x)
+    {
+        float32x4_t t00 = vld1q_f32(row0 + x * 8);
+        float32x4_t t01 = vld1q_f32(row0 + x * 8 + 4);
+        float32x4_t t10 = vld1q_f32(row1 + x * 8);
+        float32x4_t t11 = vld1q_f32(row1 + x * 8 + 4);
+        float32x4_t mean = vmulq_n_f32(vaddq_f32(vaddq_f32(t00, t01), vaddq_f32(t10, t11)), .25f);
+
+        float32x4_t clamped = vminq_f32(vmaxq_f32(mean, linearMin), linearMax);
+        vst1q_u32(results, vshrq_n_u32(vsubq_u32(vreinterpretq_u32_f32(clamped), minBits), LINEAR_INDEX_SHIFT));
+        vst1q_u32(results + 4, vcvtq_u32_f32(vaddq_f32(mean, vdupq_n_f32(.5f))));
+
+        uint8_t* texel = out + x * 4;
+        texel[0] = tables.toSrgb[results[0]];
+        texel[1] = tables.toSrgb[results[1]];
+        texel[2] = tables.toSrgb[results[2]];
+        texel[3] = static_cast<uint8_t>(results[7]);
+    }
+#endif
+
+    for (; x < width; ++ x)
+    {
+        averageTexel(row0 + x * 8, row0 + x * 8 + 4, row1 + x * 8, row1 + x * 8 + 4, out + x * 4, tables);
+    }
+}
+
+void downsampleRows(const uint8_t* src, uint32_t srcWidth, uint32_t srcHeight, uint8_t* dst, uint32_t dstWidth,
+    uint32_t rowBegin, uint32_t rowEnd)
+{
+    const ConversionTables& tables = getConversionTables();
+
+    // Only the texels under the destination row are decoded; an odd last column is dropped.
+    uint32_t decodeWidth = srcWidth > 1 ? dstWidth * 2 : 1;
+    std::vector<float> decoded(static_cast<size_t>(decodeWidth) * 8);
+    float* row0 = decoded.data();
+    float* row1 = row0 + static_cast<size_t>(decodeWidth) * 4;
+
+    for (uint32_t y = rowBegin; y < rowEnd; ++ y)
+    {
+        // A dimension that is already 1 is not halved, so both taps fall on the same texel.
+        uint32_t y0 = std::min(y * 2, srcHeight - 1);
+        uint32_t y1 = std::min(y * 2 + 1, srcHeight - 1);
+        decodeRow(src + static_cast<size_t>(y0) * srcWidth * 4, decodeWidth, row0, tables);
+        decodeRow(src + static_cast<size_t>(y1) * srcWidth * 4, decodeWidth, row1, tables);
+        uint8_t* out = dst + static_cast<size_t>(y) * dstWidth * 4;
+
+        if (srcWidth > 1)
+        {
+            averageRow(row0, row1, out, dstWidth, tables);
+            continue;
+        }
+
+        averageTexel(row0, row0, row1, row1, out, tables);
+    }
+}
+}
+
+/*! ***********************************************************************************************
+ * \class   MipGenerator
+ * \author  Leon Vincii
+ * \date    2026.10.16
+ * ************************************************************************************************/
+/* ************************************************************************************************
+ * Public Functions
+ * ************************************************************************************************/
+void MipGenerator::generate(const uint8_t* rgba, uint32_t width, uint32_t height,
+    std::vector<std::vector<uint8_t>>& levels, ThreadPool& threadPool)
+{
+    uint32_t levelCount = getLevelCount(width, height);
+    levels.resize(levelCount);
+    levels[0].assign(rgba, rgba + static_cast<size_t>(width) * height * 4);
+
+    // Odd dimensions round down like the GPU blit path does, dropping the last row or column.
+    for (uint32_t level = 1; level < levelCount; ++ level)
+    {
+        uint32_t dstWidth = std::max(width / 2, 1u);
+        uint32_t dstHeight = std::max(height / 2, 1u);
+        levels[level].resize(static_cast<size_t>(dstWidth) * dstHeight * 4);
+
+        const uint8_t* src = levels[level - 1].data();
+        uint8_t* dst = levels[level].data();
+        uint32_t rowsPerTask = static_cast<uint32_t>(std::max<size_t>(TEXELS_PER_TASK / dstWidth, 1));
+        size_t taskCount = (dstHeight + rowsPerTask - 1) / rowsPerTask;
+        if (taskCount == 1)
+        {
+            downsampleRows(src, width, height, dst, dstWidth, 0, dstHeight);
+        }
+        else
+        {
+            threadPool.parallelFor(taskCount, [&](size_t task) {
+                uint32_t rowBegin = static_cast<uint32_t>(task) * rowsPerTask;
+                downsampleRows(src, width, height, dst, dstWidth, rowBegin, std::min(rowBegin + rowsPerTask, dstHeight));
+            });
+        }
+
+        width = dstWidth;
+        height = dstHeight;
+    }
+}
+
+const char* MipGenerator::getInstructionSet()
+{
+#if defined(__AVX2__)
+    return "AVX2";
+#elif defined(__SSE2__) || defined(_M_X64)
+    return "SSE2";
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+    return "NEON";
+#else
+    return "scalar";
+#endif
+}
+
+uint32_t MipGenerator::getLevelCount(uint32_t width, uint32_t height)
+{
+    return static_cast<uint32_t>(std::floor(std::log2(std::max({ width, height, 1u })))) + 1;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "ThreadPool.h"
+
+#include <cstdint>
+#include <vector>
+
+/*! ***********************************************************************************************
+ * \class   MipGenerator
+ * \brief   Builds a full mip chain of an 8-bit sRGB RGBA image on the CPU. Every level is the 2x2
+ *          box average of the previous one, taken in linear space so that the chain does not darken;
+ *          alpha is averaged as is. Needed wherever the GPU cannot blit, e.g. for block compressed
+ *          formats or formats without linear filtering, and used to produce cached chains that are
+ *          uploaded in one copy.
+ *
+ *          Conversions go through tables, and the averaging runs on AVX2, SSE2 or NEON depending on
+ *          what the build targets. All paths perform the same float operations in the same order, so
+ *          the output is identical on every machine.
+ * \author  Leon Vincii
+ * \date    2026.10.16
+ * ************************************************************************************************/
+class MipGenerator
+{
+public:
+    /* ********************************************************************************************
+     * Public Functions
+     * ********************************************************************************************/
+    // Fills levels with the whole chain down to 1x1, including a copy of the source as level 0. The
+    // rows of every level are split across the thread pool.
+    static void generate(const uint8_t* rgba, uint32_t width, uint32_t height,
+        std::vector<std::vector<uint8_t>>& levels, ThreadPool& threadPool);
+    // Name of the instruction set the build uses, for reports.
+    static const char* getInstructionSet();
+    static uint32_t getLevelCount(uint32_t width, uint32_t height);
+};
@@ -0,0 +1,310 @@
+#include "ObjLoader.h"
+
+#include "VertexDedupTable.h"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+/* ************************************************************************************************
+ * Local Functions
+ * ************************************************************************************************/
+namespace
+{
+// Chunks smaller than this are not worth a task of their own.
+const size_t MIN_CHUNK_SIZE = 256 * 1024;
+
+using Clock = std::chrono::high_resolution_clock;
+
+double secondsSince(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::chrono::seconds::period>(Clock::now() - start).count();
+}
+
+const char* skipSpaces(const char* cursor, const char* end)
+{
+    while (cursor < end && (*cursor == ' ' || *cursor == '\t')) { ++ cursor; }
+    return cursor;
+}
+
+const char* parseFloat(const char* cursor, const char* end, float& value)
+{
+    cursor = skipSpaces(cursor, end);
+    // from_chars does not accept a leading '+', which some exporters write.
+    if (cursor < end && *cursor == '+') { ++ cursor; }
+    auto result = std::from_chars(cursor, end, value);
+    if (result.ec != std::errc()) { value = 0.f; }
+    return result.ptr;
+}
+
+const char* parseInt(const char* cursor, const char* end, int32_t& value)
+{
+    auto result = std::from_chars(cursor, end, value);
+    if (result.ec != std::errc()) { value = 0; }
+    return result.ptr;
+}
+}
+
+/*! ***********************************************************************************************
+ * \class   ObjLoader
+ * \author  Leon Vincii
+ * \date    2026.10.16
+ * ************************************************************************************************/
+/* ************************************************************************************************
+ * Public Functions
+ * ************************************************************************************************/
+void ObjLoader::load(const std::string& filename, ThreadPool& threadPool, size_t threadCount,
+    std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, ObjLoadStats* stats)
+{
+    // Read the whole file in one go; parsing works on the raw bytes.
+    auto startTime = Clock::now();
+
+    std::ifstream file(filename, std::ios::ate | std::ios::binary);
+    if (!file.is_open())
+    {
+        throw std::runtime_error("failed to open model file " + filename);
+    }
+    size_t fileSize = static_cast<size_t>(file.tellg());
+    std::vector<char> buffer(fileSize);
+    file.seekg(0);
+    file.read(buffer.data(), fileSize);
+    file.close();
+
+    double readSeconds = secondsSince(startTime);
+
+    // Split the file into one chunk per thread, moving every split point forward to the next line
+    // start so that no line is cut in half.
+    threadCount = std::max<size_t>(1, std::min(threadCount, threadPool.threadCount()));
+    size_t chunkCount = std::max<size_t>(1, std::min(threadCount, fileSize / MIN_CHUNK_SIZE + 1));
+
+    std::vector<Chunk> chunks(chunkCount);
+    const char* fileBegin = buffer.data();
+    const char* fileEnd = fileBegin + fileSize;
+    const char* chunkBegin = fileBegin;
+
+    for (size_t i = 0; i < chunkCount; ++ i)
+    {
+        const char* chunkEnd = i + 1 == chunkCount ? fileEnd : fileBegin + fileSize * (i + 1) / chunkCount;
+        chunkEnd = std::max(chunkEnd, chunkBegin);
+        while (chunkEnd < fileEnd && *(chunkEnd - 1) != '\n') { ++ chunkEnd; }
+
+        chunks[i].begin = chunkBegin;
+        chunks[i].end = chunkEnd;
+        chunkBegin = chunkEnd;
+    }
+
+    // 1. Parse every chunk in parallel.
+    startTime = Clock::now();
+    threadPool.parallelFor(chunkCount, [&chunks](size_t i) { parseChunk(chunks[i]); });
+
+    // Concatenate the attribute arrays; face indices are resolved against the global arrays.
+    uint32_t positionCount = 0, textureCoordCount = 0;
+    for (auto& chunk : chunks)
+    {
+        chunk.positionBase = positionCount;
+        chunk.textureCoordBase = textureCoordCount;
+        positionCount += static_cast<uint32_t>(chunk.positions.size() / 3);
+        textureCoordCount += static_cast<uint32_t>(chunk.textureCoords.size() / 2);
+    }
+
+    std::vector<float> positions(3 * static_cast<size_t>(positionCount));
+    std::vector<float> textureCoords(2 * static_cast<size_t>(textureCoordCount));
+    threadPool.parallelFor(chunkCount, [&](size_t i) {
+        std::copy(chunks[i].positions.begin(), chunks[i].positions.end(), positions.begin() + 3 * chunks[i].positionBase);
+        std::copy(chunks[i].textureCoords.begin(), chunks[i].textureCoords.end(), textureCoords.begin() + 2 * chunks[i].textureCoordBase);
+        chunks[i].positions = std::vector<float>();
+        chunks[i].textureCoords = std::vector<float>();
+    });
+
+    double parseSeconds = secondsSince(startTime);
+
+    // 2. Deduplicate every chunk in parallel. Vertices shared across chunk borders stay duplicated,
+    // which costs a handful of vertices per chunk.
+    startTime = Clock::now();
+    threadPool.parallelFor(chunkCount, [&](size_t i) { dedupChunk(chunks[i], positions, textureCoords); });
+    double dedupSeconds = secondsSince(startTime);
+
+    // 3. Merge the chunks, offsetting each chunk's indices by the number of vertices before it.
+    startTime = Clock::now();
+    uint32_t vertexCount = 0;
+    size_t indexCount = 0;
+    for (auto& chunk : chunks)
+    {
+        chunk.vertexBase = vertexCount;
+        vertexCount += static_cast<uint32_t>(chunk.vertices.size());
+        indexCount += chunk.indices.size();
+    }
+
+    vertices.resize(vertexCount);
+    indices.resize(indexCount);
+
+    std::vector<size_t> indexBases(chunkCount, 0);
+    for (size_t i = 1; i < chunkCount; ++ i)
+    {
+        indexBases[i] = indexBases[i - 1] + chunks[i - 1].indices.size();
+    }
+
+    threadPool.parallelFor(chunkCount, [&](size_t i) {
+        const Chunk& chunk = chunks[i];
+        std::copy(chunk.vertices.begin(), chunk.vertices.end(), vertices.begin() + chunk.vertexBase);
+        for (size_t j = 0; j < chunk.indices.size(); ++ j)
+        {
+            indices[indexBases[i] + j] = chunk.indices[j] + chunk.vertexBase;
+        }
+    });
+    double mergeSeconds = secondsSince(startTime);
+
+    if (stats)
+    {
+        stats->threadCount = threadCount;
+        stats->chunkCount = chunkCount;
+        stats->faceVertexCount = indexCount;
+        stats->uniqueVertexCount = vertexCount;
+        stats->readSeconds = readSeconds;
+        stats->parseSeconds = parseSeconds;
+        stats->dedupSeconds = dedupSeconds;
+        stats->mergeSeconds = mergeSeconds;
+        stats->dedup = VertexDedupStats {};
+        for (const auto& chunk : chunks)
+        {
+            stats->dedup.merge(chunk.dedupStats);
+        }
+    }
+}
+
+/* ************************************************************************************************
+ * Private Functions
+ * ************************************************************************************************/
+void ObjLoader::dedupChunk(Chunk& chunk, const std::vector<float>& positions,
+    const std::vector<float>& textureCoords)
+{
+    int64_t positionCount = static_cast<int64_t>(positions.size() / 3);
+    int64_t textureCoordCount = static_cast<int64_t>(textureCoords.size() / 2);
+
+    // The corner count bounds the unique vertex count, so the table is sized once up front.
+    VertexDedupTable uniqueVertices(chunk.corners.size());
+    chunk.indices.reserve(chunk.corners.size());
+
+    for (const Corner& corner : chunk.corners)
+    {
+        // Relative (negative) indices were stored relative to the chunk's first attribute.
+        int64_t positionIndex = corner.positionRelative ?
+            static_cast<int64_t>(chunk.positionBase) + corner.position : corner.position;
+        int64_t textureCoordIndex = corner.textureCoordRelative ?
+            static_cast<int64_t>(chunk.textureCoordBase) + corner.textureCoord : corner.textureCoord;
+
+        if (positionIndex < 0 || positionIndex >= positionCount)
+        {
+            throw std::runtime_error("face references a vertex position that does not exist");
+        }
+
+        Vertex vertex {};
+        vertex.pos = {
+            positions[3 * positionIndex + 0],
+            positions[3 * positionIndex + 1],
+            positions[3 * positionIndex + 2]
+        };
+        if (textureCoordIndex >= 0 && textureCoordIndex < textureCoordCount)
+        {
+            vertex.textureCoord = {
+                textureCoords[2 * textureCoordIndex + 0],
+                1.f - textureCoords[2 * textureCoordIndex + 1]
+            };
+        }
+
+        chunk.indices.push_back(uniqueVertices.findOrInsert(vertex, chunk.vertices));
+    }
+
+    chunk.corners = std::vector<Corner>();
+    chunk.dedupStats = uniqueVertices.stats();
+}
+
+void ObjLoader::parseChunk(Chunk& chunk)
+{
+    const char* cursor = chunk.begin;
+    const char* end = chunk.end;
+
+    // Rough guess of the attribute counts to avoid most reallocations.
+    size_t estimatedLines = static_cast<size_t>(end - cursor) / 32;
+    chunk.positions.reserve(estimatedLines);
+    chunk.corners.reserve(estimatedLines);
+
+    // Scratch list of the corners of the current polygon before it is fan-triangulated.
+    std::vector<Corner> polygon;
+
+    while (cursor < end)
+    {
+        const char* lineEnd = static_cast<const char*>(memchr(cursor, '\n', static_cast<size_t>(end - cursor)));
+        if (!lineEnd) { lineEnd = end; }
+        const char* next = lineEnd < end ? lineEnd + 1 : end;
+        if (lineEnd > cursor && *(lineEnd - 1) == '\r') { -- lineEnd; }
+
+        cursor = skipSpaces(cursor, lineEnd);
+
+        if (lineEnd - cursor >= 2 && cursor[0] == 'v' && (cursor[1] == ' ' || cursor[1] == '\t'))
+        {
+            // Vertex position: "v x y z [w]".
+            float x, y, z;
+            const char* token = parseFloat(cursor + 2, lineEnd, x);
+            token = parseFloat(token, lineEnd, y);
+            parseFloat(token, lineEnd, z);
+            chunk.positions.push_back(x);
+            chunk.positions.push_back(y);
+            chunk.positions.push_back(z);
+        }
+        else if (lineEnd - cursor >= 3 && cursor[0] == 'v' && cursor[1] == 't' && (cursor[2] == ' ' || cursor[2] == '\t'))
+        {
+            // Texture coordinate: "vt u [v [w]]".
+            float u, v = 0.f;
+            const char* token = parseFloat(cursor + 3, lineEnd, u);
+            if (skipSpaces(token, lineEnd) < lineEnd) { parseFloat(token, lineEnd, v); }
+            chunk.textureCoords.push_back(u);
+            chunk.textureCoords.push_back(v);
+        }
+        else if (lineEnd - cursor >= 2 && cursor[0] == 'f' && (cursor[1] == ' ' || cursor[1] == '\t'))
+        {
+            // Face: "f p[/t[/n]] ..." with any number of corners, fan-triangulated.
+            polygon.clear();
+            const char* token = skipSpaces(cursor + 2, lineEnd);
+            while (token < lineEnd)
+            {
+                Corner corner { 0, -1, false, false };
+
+                int32_t value = 0;
+                token = parseInt(token, lineEnd, value);
+                corner.positionRelative = value < 0;
+                corner.position = value < 0 ? static_cast<int32_t>(chunk.positions.size() / 3) + value : value - 1;
+
+                if (token < lineEnd && *token == '/')
+                {
+                    ++ token;
+                    if (token < lineEnd && *token != '/')
+                    {
+                        token = parseInt(token, lineEnd, value);
+                        corner.textureCoordRelative = value < 0;
+                        corner.textureCoord = value < 0 ?
+                            static_cast<int32_t>(chunk.textureCoords.size() / 2) + value : value - 1;
+                    }
+                }
+
+                // Skip the normal index and anything else up to the next corner.
+                while (token < lineEnd && *token != ' ' && *token != '\t') { ++ token; }
+                token = skipSpaces(token, lineEnd);
+
+                polygon.push_back(corner);
+            }
+
+            for (size_t i = 2; i < polygon.size(); ++ i)
+            {
+                chunk.corners.push_back(polygon[0]);
+                chunk.corners.push_back(polygon[i - 1]);
+                chunk.corners.push_back(polygon[i]);
+            }
+        }
+
+        cursor = next;
+    }
+}
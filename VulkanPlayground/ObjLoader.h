@@ -0,0 +1,80 @@
+#pragma once
+
+#include "ThreadPool.h"
+#include "Vertex.h"
+#include "VertexDedupTable.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/* ************************************************************************************************
+ * Global Structs
+ * ************************************************************************************************/
+struct ObjLoadStats
+{
+    size_t      threadCount;
+    size_t      chunkCount;
+    uint64_t    faceVertexCount;
+    uint64_t    uniqueVertexCount;
+    double      readSeconds;
+    double      parseSeconds;
+    double      dedupSeconds;
+    double      mergeSeconds;
+    VertexDedupStats dedup;
+};
+
+/*! ***********************************************************************************************
+ * \class   ObjLoader
+ * \brief   Wavefront OBJ loader that splits the file into line-aligned chunks, parses and
+ *          deduplicates the chunks in parallel on a thread pool and finally merges the per-chunk
+ *          vertex lists into one vertex/index buffer pair. Only positions, texture coordinates and
+ *          faces are read; everything else (normals, groups, materials) is skipped.
+ * \author  Leon Vincii
+ * \date    2026.10.16
+ * ************************************************************************************************/
+class ObjLoader
+{
+public:
+    /* ********************************************************************************************
+     * Public Functions
+     * ********************************************************************************************/
+    static void load(const std::string& filename, ThreadPool& threadPool, size_t threadCount,
+        std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, ObjLoadStats* stats = nullptr);
+
+private:
+    /* ********************************************************************************************
+     * Private Structs
+     * ********************************************************************************************/
+    struct Corner
+    {
+        int32_t position;
+        int32_t textureCoord;
+        bool    positionRelative;
+        bool    textureCoordRelative;
+    };
+
+    struct Chunk
+    {
+        const char*             begin;
+        const char*             end;
+        // Parsing ------------------------------------------------------------------------------/
+        std::vector<float>      positions;
+        std::vector<float>      textureCoords;
+        std::vector<Corner>     corners;
+        uint32_t                positionBase;
+        uint32_t                textureCoordBase;
+        // Deduplication ------------------------------------------------------------------------/
+        std::vector<Vertex>     vertices;
+        std::vector<uint32_t>   indices;
+        uint32_t                vertexBase;
+        VertexDedupStats        dedupStats;
+    };
+
+    /* ********************************************************************************************
+     * Private Functions
+     * ********************************************************************************************/
+    static void dedupChunk(Chunk& chunk, const std::vector<float>& positions,
+        const std::vector<float>& textureCoords);
+    static void parseChunk(Chunk& chunk);
+};
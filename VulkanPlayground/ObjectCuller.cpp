@@ -0,0 +1,63 @@
+#include "ObjectCuller.h"
+
+#include <algorithm>
+#include <cmath>
+
+/*! ***********************************************************************************************
+ * \class   ObjectCuller
+ * \author  Leon Vincii
+ * \date    2026.10.16
+ * ************************************************************************************************/
+/* ************************************************************************************************
+ * Public Functions
+ * ************************************************************************************************/
+CullingConstants ObjectCuller::getConstants(const glm::vec4& boundingSphere, const glm::mat4& model,
+    const glm::mat4& view, const glm::mat4& proj, float viewportHeight, float pixelError)
+{
+    // The objects only translate the model, so the sphere's radius only scales with the model transform.
+    float scale = std::max({
+        glm::length(glm::vec3(model[0])), glm::length(glm::vec3(model[1])), glm::length(glm::vec3(model[2]))
+    });
+
+    CullingConstants constants {};
+    constants.view = view;
+    constants.boundingSphere = glm::vec4(glm::vec3(model * glm::vec4(glm::vec3(boundingSphere), 1.f)),
+        boundingSphere.w * scale);
+    constants.projection = glm::vec4(proj[0][0], proj[1][1], proj[2][2], proj[3][2]);
+    // An error of e model units at distance d covers e * scale * |P11| * height / 2 / d pixels.
+    constants.lodScale = std::abs(proj[1][1]) * viewportHeight * .5f * scale / pixelError;
+    return constants;
+}
+
+bool ObjectCuller::isInFrustum(const glm::vec3& center, float radius, const glm::vec4& projection)
+{
+    /***
+     * The view looks down -z. With depth d = -z, a point is within the right plane of the frustum
+     * while P00 * x - d <= 0, and within the top one while |P11| * y - d <= 0; the left and bottom ones
+     * mirror them, hence the absolute values. The near and far planes follow from the depth terms of
+     * a zero-to-one projection: near = P32 / P22 and far = P32 / (P22 + 1).
+     ***/
+    float depth = -center.z;
+    float zNear = projection.w / projection.z;
+    float zFar = projection.w / (projection.z + 1.f);
+    if (depth + radius <= zNear || depth - radius >= zFar) { return false; }
+
+    float p00 = projection.x;
+    float p11 = std::abs(projection.y);
+    return (p00 * std::abs(center.x) - depth) / std::sqrt(p00 * p00 + 1.f) < radius &&
+           (p11 * std::abs(center.y) - depth) / std::sqrt(p11 * p11 + 1.f) < radius;
+}
+
+uint32_t ObjectCuller::countInFrustum(const CullingConstants& constants, const std::vector<glm::vec3>& positions)
+{
+    uint32_t count = 0;
+    for (const auto& position : positions)
+    {
+        glm::vec4 center = constants.view * glm::vec4(glm::vec3(constants.boundingSphere) + position, 1.f);
+        if (isInFrustum(glm::vec3(center), constants.boundingSphere.w, constants.projection))
+        {
+            ++ count;
+        }
+    }
+    return count;
+}
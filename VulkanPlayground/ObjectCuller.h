@@ -0,0 +1,63 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+/* ************************************************************************************************
+ * Global Structs
+ * ************************************************************************************************/
+// Per-frame values of shader_cull.comp, pushed as constants; at 124 bytes within the 128 bytes every
+// device offers. Matches the std430 layout of the shader's block member for member.
+struct CullingConstants
+{
+    glm::mat4   view;
+    // Bounding sphere of the model after the frame's model transform (xyz: center, w: radius); each
+    // object moves it by its own transform.
+    glm::vec4   boundingSphere;
+    // proj[0][0], proj[1][1], proj[2][2] and proj[3][2] of a zero-to-one depth projection.
+    glm::vec4   projection;
+    glm::vec2   pyramidSize;        // Size of level 0 of the depth pyramid, in texels.
+    uint32_t    objectCount;
+    uint32_t    lodCount;           // Levels of detail in the shader's table, the finest first.
+    // A level is drawn while its error times this stays within the distance to the sphere; see
+    // MeshSimplifier::selectLod(), which the shader selects the level of every object like.
+    float       lodScale;
+    uint32_t    occlusion;          // Test against the depth pyramid, which must have been built.
+    uint32_t    compact;            // Write the survivors' commands back to back, with a draw count.
+};
+
+// Counters shader_cull.comp accumulates over one frame.
+struct CullingCounters
+{
+    uint32_t    frustumCulled;
+    uint32_t    occlusionCulled;
+    uint32_t    drawn;
+    uint32_t    reserved;
+};
+
+/*! ***********************************************************************************************
+ * \class   ObjectCuller
+ * \brief   CPU side of the GPU object culling. Builds the constants of shader_cull.comp, which tests
+ *          the bounding sphere of every object against the view frustum and then against a depth
+ *          pyramid of the previous frame, and repeats the frustum test on the CPU, so that what the
+ *          GPU culled can be checked on any implementation, a software one included.
+ * \author  Leon Vincii
+ * \date    2026.10.16
+ * ************************************************************************************************/
+class ObjectCuller
+{
+public:
+    /* ********************************************************************************************
+     * Public Functions
+     * ********************************************************************************************/
+    // boundingSphere is in model space (xyz: center, w: radius). Levels of detail are selected for
+    // pixelError pixels on a viewport viewportHeight pixels high. Leaves the counts and flags zero.
+    static CullingConstants getConstants(const glm::vec4& boundingSphere, const glm::mat4& model,
+        const glm::mat4& view, const glm::mat4& proj, float viewportHeight, float pixelError);
+    // Same test as shader_cull.comp, for a sphere in view space.
+    static bool isInFrustum(const glm::vec3& center, float radius, const glm::vec4& projection);
+    // Objects at the given positions that pass the frustum test.
+    static uint32_t countInFrustum(const CullingConstants& constants, const std::vector<glm::vec3>& positions);
+};
@@ -0,0 +1,206 @@
+#include "PackedVertex.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+/* ************************************************************************************************
+ * Local Functions
+ * ************************************************************************************************/
+namespace
+{
+const float UNORM16_MAX = 65535.f;
+
+uint16_t quantizeUnorm16(float value, float offset, float scale)
+{
+    float normalized = scale > 0.f ? (value - offset) / scale : 0.f;
+    return static_cast<uint16_t>(std::lround(std::min(std::max(normalized, 0.f), 1.f) * UNORM16_MAX));
+}
+}
+
+/*! ***********************************************************************************************
+ * \class   VertexPacker
+ * \author  Leon Vincii
+ * \date    2026.10.16
+ * ************************************************************************************************/
+/* ************************************************************************************************
+ * Public Functions
+ * ************************************************************************************************/
+uint32_t VertexPacker::getStride(VertexLayout layout)
+{
+    return layout == VertexLayout::Float ? sizeof(Vertex) : sizeof(PackedVertex);
+}
+
+VertexDecode VertexPacker::pack(VertexLayout layout, const Vertex* vertices, size_t count, void* destination,
+    QuantizationError* error)
+{
+    VertexDecode decode {};
+    decode.positionScale = glm::vec4(1.f);
+    decode.positionOffset = glm::vec4(0.f);
+    decode.textureCoordTransform = glm::vec4(1.f, 1.f, 0.f, 0.f);
+
+    if (error) { *error = QuantizationError {}; }
+
+    if (layout == VertexLayout::Float)
+    {
+        std::memcpy(destination, vertices, count * sizeof(Vertex));
+        return decode;
+    }
+
+    // Quantize against the bounds of the data itself so that the full 16 bits are used.
+    glm::vec3 positionMin(std::numeric_limits<float>::max()), positionMax(std::numeric_limits<float>::lowest());
+    glm::vec2 textureCoordMin(std::numeric_limits<float>::max()), textureCoordMax(std::numeric_limits<float>::lowest());
+    for (size_t i = 0; i < count; ++ i)
+    {
+        positionMin = glm::min(positionMin, vertices[i].pos);
+        positionMax = glm::max(positionMax, vertices[i].pos);
+        textureCoordMin = glm::min(textureCoordMin, vertices[i].textureCoord);
+        textureCoordMax = glm::max(textureCoordMax, vertices[i].textureCoord);
+    }
+    if (count == 0)
+    {
+        positionMin = positionMax = glm::vec3(0.f);
+        textureCoordMin = textureCoordMax = glm::vec2(0.f);
+    }
+
+    glm::vec3 positionScale = positionMax - positionMin;
+    glm::vec2 textureCoordScale = textureCoordMax - textureCoordMin;
+    decode.positionScale = glm::vec4(positionScale, 0.f);
+    decode.positionOffset = glm::vec4(positionMin, 1.f);
+    if (layout == VertexLayout::Unorm16)
+    {
+        decode.textureCoordTransform = glm::vec4(textureCoordScale, textureCoordMin);
+    }
+
+    auto packed = static_cast<PackedVertex*>(destination);
+    double positionErrorSum = 0.0, textureCoordErrorSum = 0.0;
+
+    for (size_t i = 0; i < count; ++ i)
+    {
+        const Vertex& vertex = vertices[i];
+        PackedVertex& out = packed[i];
+
+        for (int k = 0; k < 3; ++ k)
+        {
+            out.pos[k] = quantizeUnorm16(vertex.pos[k], positionMin[k], positionScale[k]);
+        }
+        out.pos[3] = 0;
+
+        for (int k = 0; k < 2; ++ k)
+        {
+            out.textureCoord[k] = layout == VertexLayout::Unorm16 ?
+                quantizeUnorm16(vertex.textureCoord[k], textureCoordMin[k], textureCoordScale[k]) :
+                floatToHalf(vertex.textureCoord[k]);
+        }
+
+        if (!error) { continue; }
+
+        // Decode exactly as the vertex shader does and compare against the float reference.
+        glm::vec3 position;
+        glm::vec2 textureCoord;
+        for (int k = 0; k < 3; ++ k)
+        {
+            position[k] = positionMin[k] + positionScale[k] * (out.pos[k] / UNORM16_MAX);
+        }
+        for (int k = 0; k < 2; ++ k)
+        {
+            textureCoord[k] = layout == VertexLayout::Unorm16 ?
+                textureCoordMin[k] + textureCoordScale[k] * (out.textureCoord[k] / UNORM16_MAX) :
+                halfToFloat(out.textureCoord[k]);
+        }
+
+        float positionError = glm::length(position - vertex.pos);
+        float textureCoordError = glm::length(textureCoord - vertex.textureCoord);
+        error->maxPositionError = std::max(error->maxPositionError, positionError);
+        error->maxTextureCoordError = std::max(error->maxTextureCoordError, textureCoordError);
+        positionErrorSum += positionError;
+        textureCoordErrorSum += textureCoordError;
+    }
+
+    if (error && count > 0)
+    {
+        error->meanPositionError = static_cast<float>(positionErrorSum / count);
+        error->meanTextureCoordError = static_cast<float>(textureCoordErrorSum / count);
+    }
+
+    return decode;
+}
+
+// Half Floats ------------------------------------------------------------------------------------/
+float VertexPacker::halfToFloat(uint16_t value)
+{
+    uint32_t sign = static_cast<uint32_t>(value & 0x8000) << 16;
+    uint32_t exponent = (value >> 10) & 0x1f;
+    uint32_t mantissa = value & 0x3ff;
+
+    uint32_t bits;
+    if (exponent == 0x1f)
+    {
+        // Infinity or NaN.
+        bits = sign | 0x7f800000 | (mantissa << 13);
+    }
+    else if (exponent != 0)
+    {
+        bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+    }
+    else if (mantissa != 0)
+    {
+        // Subnormal half: renormalize into a normal float.
+        exponent = 113;
+        while ((mantissa & 0x400) == 0)
+        {
+            mantissa <<= 1;
+            -- exponent;
+        }
+        bits = sign | (exponent << 23) | ((mantissa & 0x3ff) << 13);
+    }
+    else
+    {
+        bits = sign;
+    }
+
+    float result;
+    std::memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+uint16_t VertexPacker::floatToHalf(float value)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000);
+    uint32_t exponent = (bits >> 23) & 0xff;
+    uint32_t mantissa = bits & 0x7fffff;
+
+    if (exponent == 0xff)
+    {
+        return static_cast<uint16_t>(sign | 0x7c00 | (mantissa ? 0x200 : 0));
+    }
+
+    int32_t halfExponent = static_cast<int32_t>(exponent) - 112;
+    if (halfExponent >= 0x1f)
+    {
+        return static_cast<uint16_t>(sign | 0x7c00);
+    }
+
+    if (halfExponent <= 0)
+    {
+        // Result is subnormal or zero; shift the mantissa with its implicit bit into place.
+        if (halfExponent < -10) { return sign; }
+        mantissa |= 0x800000;
+        uint32_t shift = static_cast<uint32_t>(14 - halfExponent);
+        uint32_t halfMantissa = mantissa >> shift;
+        uint32_t remainder = mantissa & ((1u << shift) - 1);
+        uint32_t halfway = 1u << (shift - 1);
+        if (remainder > halfway || (remainder == halfway && (halfMantissa & 1))) { ++ halfMantissa; }
+        return static_cast<uint16_t>(sign | halfMantissa);
+    }
+
+    // Round to nearest even; a carry out of the mantissa correctly bumps the exponent.
+    uint32_t half = (static_cast<uint32_t>(halfExponent) << 10) | (mantissa >> 13);
+    uint32_t remainder = mantissa & 0x1fff;
+    if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1))) { ++ half; }
+    return static_cast<uint16_t>(sign | half);
+}
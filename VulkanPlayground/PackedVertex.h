@@ -0,0 +1,102 @@
+#pragma once
+
+#include "Vertex.h"
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/* ************************************************************************************************
+ * Global Enums
+ * ************************************************************************************************/
+enum class VertexLayout
+{
+    Float,              // Vertex as is: float position, color and texture coordinate, 32 bytes.
+    Unorm16,            // PackedVertex with 16-bit normalized texture coordinates, 12 bytes.
+    Unorm16Half         // PackedVertex with half-float texture coordinates, 12 bytes.
+};
+
+/* ************************************************************************************************
+ * Global Structs
+ * ************************************************************************************************/
+// Maps the normalized attributes back to model space: value = offset + scale * attribute.
+struct VertexDecode
+{
+    glm::vec4   positionScale;
+    glm::vec4   positionOffset;
+    glm::vec4   textureCoordTransform;  // xy: scale, zw: offset.
+};
+
+struct QuantizationError
+{
+    float       maxPositionError;       // In model units.
+    float       meanPositionError;
+    float       maxTextureCoordError;   // In texture coordinate units.
+    float       meanTextureCoordError;
+};
+
+// Compact vertex without the color, which loadModel() never fills in. The position is quantized to
+// 16 bits per axis against the mesh AABB and padded to four components, because three-component
+// 16-bit formats are rarely supported for vertex fetch.
+struct PackedVertex
+{
+    uint16_t pos[4];
+    uint16_t textureCoord[2];
+
+    static VkVertexInputBindingDescription getBindingDescription()
+    {
+        VkVertexInputBindingDescription bindingDescription {};
+        bindingDescription.binding = 0;
+        bindingDescription.stride = sizeof(PackedVertex);
+        bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+
+        return bindingDescription;
+    }
+
+    static std::array<VkVertexInputAttributeDescription, 2> getAttributeDescriptions(VertexLayout layout)
+    {
+        // Locations match shader_packed.vert; location 1, the color, is left out.
+        std::array<VkVertexInputAttributeDescription, 2> attributeDescriptions {};
+        // Read position attributes.
+        attributeDescriptions[0].binding = 0;
+        attributeDescriptions[0].location = 0;
+        attributeDescriptions[0].format = VK_FORMAT_R16G16B16A16_UNORM;
+        attributeDescriptions[0].offset = offsetof(PackedVertex, pos);
+        // Read texture coordinate attributes.
+        attributeDescriptions[1].binding = 0;
+        attributeDescriptions[1].location = 2;
+        attributeDescriptions[1].format = layout == VertexLayout::Unorm16Half ?
+            VK_FORMAT_R16G16_SFLOAT : VK_FORMAT_R16G16_UNORM;
+        attributeDescriptions[1].offset = offsetof(PackedVertex, textureCoord);
+
+        return attributeDescriptions;
+    }
+};
+
+static_assert(sizeof(PackedVertex) == 12, "PackedVertex must not be padded");
+
+/*! ***********************************************************************************************
+ * \class   VertexPacker
+ * \brief   Converts float vertices into one of the compact layouts and reports the error the
+ *          conversion introduced against the float reference.
+ * \author  Leon Vincii
+ * \date    2026.10.16
+ * ************************************************************************************************/
+class VertexPacker
+{
+public:
+    /* ********************************************************************************************
+     * Public Functions
+     * ********************************************************************************************/
+    static uint32_t getStride(VertexLayout layout);
+    // Writes count vertices in the given layout to destination, which must hold count * stride
+    // bytes, and returns the transformation the vertex shader needs to decode them.
+    static VertexDecode pack(VertexLayout layout, const Vertex* vertices, size_t count, void* destination,
+        QuantizationError* error = nullptr);
+
+    // Half Floats --------------------------------------------------------------------------------/
+    static float halfToFloat(uint16_t value);
+    static uint16_t floatToHalf(float value);
+};
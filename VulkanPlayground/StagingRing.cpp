@@ -0,0 +1,110 @@
+#include "StagingRing.h"
+
+#include <algorithm>
+
+/* ************************************************************************************************
+ * Local Functions
+ * ************************************************************************************************/
+namespace
+{
+uint64_t alignUp(uint64_t value, uint64_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+}
+
+/*! ***********************************************************************************************
+ * \class   StagingRing
+ * \author  Leon Vincii
+ * \date    2026.10.16
+ * ************************************************************************************************/
+/* ************************************************************************************************
+ * Public Ctor & Dtor
+ * ************************************************************************************************/
+StagingRing::StagingRing(uint64_t capacity) :
+    m_allocations               ()
+  , m_capacity                  (capacity)
+  , m_condition                 ()
+  , m_mutex                     ()
+{}
+
+/* ************************************************************************************************
+ * Public Functions
+ * ************************************************************************************************/
+bool StagingRing::allocate(uint64_t size, uint64_t alignment, uint64_t& offset)
+{
+    size = std::max<uint64_t>(size, 1);
+    alignment = std::max<uint64_t>(alignment, 1);
+    if (size > m_capacity) { return false; }
+
+    // Anything that fits into the capacity fits into the empty ring, so the wait always ends once the
+    // older allocations have been released.
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_condition.wait(lock, [&]() { return findSpace(size, alignment, offset); });
+
+    m_allocations.push_back({ offset, offset + size, false });
+    return true;
+}
+
+bool StagingRing::tryAllocate(uint64_t size, uint64_t alignment, uint64_t& offset)
+{
+    size = std::max<uint64_t>(size, 1);
+    alignment = std::max<uint64_t>(alignment, 1);
+    if (size > m_capacity) { return false; }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!findSpace(size, alignment, offset)) { return false; }
+
+    m_allocations.push_back({ offset, offset + size, false });
+    return true;
+}
+
+void StagingRing::release(uint64_t offset)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = std::find_if(m_allocations.begin(), m_allocations.end(),
+            [offset](const Allocation& allocation) { return allocation.offset == offset && !allocation.released; });
+        if (it == m_allocations.end()) { return; }
+
+        it->released = true;
+        while (!m_allocations.empty() && m_allocations.front().released)
+        {
+            m_allocations.pop_front();
+        }
+    }
+    m_condition.notify_all();
+}
+
+void StagingRing::reset(uint64_t capacity)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_allocations.clear();
+    m_capacity = capacity;
+}
+
+/* ************************************************************************************************
+ * Private Functions
+ * ************************************************************************************************/
+bool StagingRing::findSpace(uint64_t size, uint64_t alignment, uint64_t& offset) const
+{
+    if (m_allocations.empty())
+    {
+        offset = 0;
+        return true;
+    }
+
+    // The live range runs from the oldest allocation to the newest one; it has wrapped around if
+    // the newest one starts before the oldest.
+    uint64_t tail = m_allocations.front().offset;
+    uint64_t head = m_allocations.back().end;
+    bool wrapped = m_allocations.back().offset < tail;
+
+    offset = alignUp(head, alignment);
+    if (wrapped) { return offset + size <= tail; }
+    if (offset + size <= m_capacity) { return true; }
+
+    // Not enough room at the end; start over at the beginning, in front of the oldest allocation.
+    offset = 0;
+    return size <= tail;
+}
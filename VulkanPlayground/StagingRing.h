@@ -0,0 +1,66 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+
+/*! ***********************************************************************************************
+ * \class   StagingRing
+ * \brief   Offset bookkeeping for a ring buffer of upload data shared by several producer threads.
+ *          Allocations are handed out in order around the ring and may be released in any order;
+ *          space is reclaimed once everything older has been released as well. The ring only tracks
+ *          offsets, so the memory it describes can be anything, e.g. a persistently mapped buffer.
+ * \author  Leon Vincii
+ * \date    2026.10.16
+ * ************************************************************************************************/
+class StagingRing
+{
+public:
+    /* ********************************************************************************************
+     * Public Ctor & Dtor
+     * ********************************************************************************************/
+    explicit StagingRing(uint64_t capacity = 0);
+
+    StagingRing(const StagingRing&) = delete;
+    StagingRing& operator=(const StagingRing&) = delete;
+
+    /* ********************************************************************************************
+     * Public Functions
+     * ********************************************************************************************/
+    // Reserves size bytes at a multiple of alignment, waiting for releases while the ring is too full.
+    // Returns false, without waiting, only if the request would not fit even into the empty ring.
+    bool allocate(uint64_t size, uint64_t alignment, uint64_t& offset);
+    // Like allocate(), but returns false instead of waiting while the ring is too full. For threads
+    // that release allocations themselves and so must not wait for them.
+    bool tryAllocate(uint64_t size, uint64_t alignment, uint64_t& offset);
+    void release(uint64_t offset);
+    // Must only be called while nothing is allocated.
+    void reset(uint64_t capacity);
+
+    uint64_t capacity() const { return m_capacity; }
+
+private:
+    /* ********************************************************************************************
+     * Private Structs
+     * ********************************************************************************************/
+    struct Allocation
+    {
+        uint64_t                    offset;
+        uint64_t                    end;
+        bool                        released;
+    };
+
+    /* ********************************************************************************************
+     * Private Functions
+     * ********************************************************************************************/
+    bool findSpace(uint64_t size, uint64_t alignment, uint64_t& offset) const;
+
+    /* ********************************************************************************************
+     * Private Attributes
+     * ********************************************************************************************/
+    std::deque<Allocation>          m_allocations;
+    uint64_t                        m_capacity;
+    std::condition_variable         m_condition;
+    std::mutex                      m_mutex;
+};
@@ -0,0 +1,432 @@
+#include "TextureCompressor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+/* ************************************************************************************************
+ * Local Functions
+ * ************************************************************************************************/
+namespace
+{
+// Weight of the second endpoint for each BC7 4-bit index, out of 64.
+const uint32_t BC7_WEIGHTS[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+// Weight of the first endpoint for each BC1 index in four-color mode.
+const float BC1_WEIGHTS[4] = { 1.f, 0.f, 2.f / 3.f, 1.f / 3.f };
+
+struct BitWriter
+{
+    uint8_t*    data;
+    uint32_t    position;
+
+    void write(uint32_t value, uint32_t bitCount)
+    {
+        for (uint32_t i = 0; i < bitCount; ++ i, ++ position)
+        {
+            if ((value >> i) & 1) { data[position >> 3] |= static_cast<uint8_t>(1 << (position & 7)); }
+        }
+    }
+};
+
+// Mean and dominant direction of the first channelCount channels, the direction by power iteration
+// on the covariance matrix.
+void computePrincipalAxis(const float (*colors)[4], size_t channelCount, float* mean, float* axis)
+{
+    for (size_t c = 0; c < 4; ++ c)
+    {
+        mean[c] = 0.f;
+        for (size_t i = 0; i < 16; ++ i) { mean[c] += colors[i][c]; }
+        mean[c] /= 16.f;
+    }
+
+    float covariance[4][4] = {};
+    for (size_t i = 0; i < 16; ++ i)
+    {
+        for (size_t a = 0; a < channelCount; ++ a)
+        {
+            for (size_t b = 0; b < channelCount; ++ b)
+            {
+                covariance[a][b] += (colors[i][a] - mean[a]) * (colors[i][b] - mean[b]);
+            }
+        }
+    }
+
+    for (size_t c = 0; c < 4; ++ c) { axis[c] = c < channelCount ? 1.f : 0.f; }
+    for (int iteration = 0; iteration < 8; ++ iteration)
+    {
+        float next[4] = {};
+        float length = 0.f;
+        for (size_t a = 0; a < channelCount; ++ a)
+        {
+            for (size_t b = 0; b < channelCount; ++ b) { next[a] += covariance[a][b] * axis[b]; }
+            length = std::max(length, std::abs(next[a]));
+        }
+        // A flat block has no dominant direction; any axis will do.
+        if (length < 1e-6f) { break; }
+        for (size_t c = 0; c < channelCount; ++ c) { axis[c] = next[c] / length; }
+    }
+}
+
+// Endpoints that minimise the squared error for fixed per-texel weights w (of endpoint 0, the rest
+// going to endpoint 1); false if the weights do not determine both endpoints.
+bool fitEndpoints(const float (*colors)[4], const float* weights, size_t channelCount, float* end0, float* end1)
+{
+    float aa = 0.f, ab = 0.f, bb = 0.f;
+    float ax[4] = {}, bx[4] = {};
+    for (size_t i = 0; i < 16; ++ i)
+    {
+        float a = weights[i];
+        float b = 1.f - a;
+        aa += a * a;
+        ab += a * b;
+        bb += b * b;
+        for (size_t c = 0; c < channelCount; ++ c)
+        {
+            ax[c] += a * colors[i][c];
+            bx[c] += b * colors[i][c];
+        }
+    }
+
+    float determinant = aa * bb - ab * ab;
+    if (std::abs(determinant) < 1e-6f) { return false; }
+
+    for (size_t c = 0; c < channelCount; ++ c)
+    {
+        end0[c] = (bb * ax[c] - ab * bx[c]) / determinant;
+        end1[c] = (aa * bx[c] - ab * ax[c]) / determinant;
+    }
+    return true;
+}
+
+void extremesAlongAxis(const float (*colors)[4], const float* mean, const float* axis, size_t channelCount,
+    float* end0, float* end1)
+{
+    float tMin = std::numeric_limits<float>::max();
+    float tMax = std::numeric_limits<float>::lowest();
+    for (size_t i = 0; i < 16; ++ i)
+    {
+        float t = 0.f;
+        for (size_t c = 0; c < channelCount; ++ c) { t += (colors[i][c] - mean[c]) * axis[c]; }
+        tMin = std::min(tMin, t);
+        tMax = std::max(tMax, t);
+    }
+
+    for (size_t c = 0; c < channelCount; ++ c)
+    {
+        end0[c] = mean[c] + axis[c] * tMax;
+        end1[c] = mean[c] + axis[c] * tMin;
+    }
+}
+
+// BC1 -------------------------------------------------------------------------------------------/
+uint16_t packRgb565(const float* color)
+{
+    auto quantize = [](float value, float maximum) {
+        return static_cast<uint16_t>(std::min(std::max(value * maximum / 255.f + .5f, 0.f), maximum));
+    };
+    return static_cast<uint16_t>(quantize(color[0], 31.f) << 11 | quantize(color[1], 63.f) << 5 | quantize(color[2], 31.f));
+}
+
+void unpackRgb565(uint16_t color, float* rgb)
+{
+    uint32_t r = (color >> 11) & 31;
+    uint32_t g = (color >> 5) & 63;
+    uint32_t b = color & 31;
+    rgb[0] = static_cast<float>(r << 3 | r >> 2);
+    rgb[1] = static_cast<float>(g << 2 | g >> 4);
+    rgb[2] = static_cast<float>(b << 3 | b >> 2);
+}
+
+float selectBc1Indices(const float (*colors)[4], uint16_t color0, uint16_t color1, uint8_t* indices)
+{
+    float palette[4][3];
+    unpackRgb565(color0, palette[0]);
+    unpackRgb565(color1, palette[1]);
+    for (size_t c = 0; c < 3; ++ c)
+    {
+        palette[2][c] = (2.f * palette[0][c] + palette[1][c]) / 3.f;
+        palette[3][c] = (palette[0][c] + 2.f * palette[1][c]) / 3.f;
+    }
+
+    float error = 0.f;
+    for (size_t i = 0; i < 16; ++ i)
+    {
+        float bestDistance = std::numeric_limits<float>::max();
+        for (uint8_t p = 0; p < 4; ++ p)
+        {
+            float distance = 0.f;
+            for (size_t c = 0; c < 3; ++ c)
+            {
+                float delta = colors[i][c] - palette[p][c];
+                distance += delta * delta;
+            }
+            if (distance < bestDistance)
+            {
+                bestDistance = distance;
+                indices[i] = p;
+            }
+        }
+        error += bestDistance;
+    }
+    return error;
+}
+
+// BC7 -------------------------------------------------------------------------------------------/
+// Quantizes an endpoint to 7 bits per channel plus the shared p-bit that fits it best.
+void quantizeBc7Endpoint(const float* endpoint, uint8_t* quantized, uint8_t& pBit)
+{
+    float bestError = std::numeric_limits<float>::max();
+    for (uint8_t p = 0; p < 2; ++ p)
+    {
+        uint8_t candidate[4];
+        float error = 0.f;
+        for (size_t c = 0; c < 4; ++ c)
+        {
+            float value = std::min(std::max((endpoint[c] - p) * .5f + .5f, 0.f), 127.f);
+            candidate[c] = static_cast<uint8_t>(value);
+            float delta = static_cast<float>(candidate[c] << 1 | p) - endpoint[c];
+            error += delta * delta;
+        }
+        if (error < bestError)
+        {
+            bestError = error;
+            pBit = p;
+            std::memcpy(quantized, candidate, 4);
+        }
+    }
+}
+
+float selectBc7Indices(const float (*colors)[4], const uint8_t* quantized0, uint8_t pBit0, const uint8_t* quantized1,
+    uint8_t pBit1, uint8_t* indices)
+{
+    float palette[16][4];
+    for (size_t p = 0; p < 16; ++ p)
+    {
+        for (size_t c = 0; c < 4; ++ c)
+        {
+            uint32_t value0 = quantized0[c] << 1 | pBit0;
+            uint32_t value1 = quantized1[c] << 1 | pBit1;
+            palette[p][c] = static_cast<float>(((64 - BC7_WEIGHTS[p]) * value0 + BC7_WEIGHTS[p] * value1 + 32) >> 6);
+        }
+    }
+
+    float error = 0.f;
+    for (size_t i = 0; i < 16; ++ i)
+    {
+        float bestDistance = std::numeric_limits<float>::max();
+        for (uint8_t p = 0; p < 16; ++ p)
+        {
+            float distance = 0.f;
+            for (size_t c = 0; c < 4; ++ c)
+            {
+                float delta = colors[i][c] - palette[p][c];
+                distance += delta * delta;
+            }
+            if (distance < bestDistance)
+            {
+                bestDistance = distance;
+                indices[i] = p;
+            }
+        }
+        error += bestDistance;
+    }
+    return error;
+}
+}
+
+/*! ***********************************************************************************************
+ * \class   TextureCompressor
+ * \author  Leon Vincii
+ * \date    2026.10.16
+ * ************************************************************************************************/
+/* ************************************************************************************************
+ * Public Functions
+ * ************************************************************************************************/
+float TextureCompressor::encodeBc1Block(const uint8_t* texels, uint8_t* block)
+{
+    float colors[16][4];
+    for (size_t i = 0; i < 16; ++ i)
+    {
+        for (size_t c = 0; c < 4; ++ c) { colors[i][c] = c < 3 ? static_cast<float>(texels[i * 4 + c]) : 0.f; }
+    }
+
+    // 1. Initial endpoints at the extremes of the colors along their principal axis.
+    float mean[4], axis[4], end0[4], end1[4];
+    computePrincipalAxis(colors, 3, mean, axis);
+    extremesAlongAxis(colors, mean, axis, 3, end0, end1);
+
+    uint16_t color0 = packRgb565(end0);
+    uint16_t color1 = packRgb565(end1);
+    uint8_t indices[16];
+    float error = selectBc1Indices(colors, color0, color1, indices);
+
+    // 2. Refit the endpoints to the chosen indices for as long as that helps.
+    for (int iteration = 0; iteration < 2 && error > 0.f; ++ iteration)
+    {
+        float weights[16];
+        for (size_t i = 0; i < 16; ++ i) { weights[i] = BC1_WEIGHTS[indices[i]]; }
+        if (!fitEndpoints(colors, weights, 3, end0, end1)) { break; }
+
+        uint16_t refit0 = packRgb565(end0);
+        uint16_t refit1 = packRgb565(end1);
+        uint8_t refitIndices[16];
+        float refitError = selectBc1Indices(colors, refit0, refit1, refitIndices);
+        if (refitError >= error) { break; }
+
+        color0 = refit0;
+        color1 = refit1;
+        error = refitError;
+        std::memcpy(indices, refitIndices, sizeof(indices));
+    }
+
+    // 3. Four-color mode requires color0 > color1. Swapping the endpoints swaps index 0 with 1 and 2
+    //    with 3; equal endpoints select the three-color mode, where only index 0 is safe.
+    if (color0 < color1)
+    {
+        std::swap(color0, color1);
+        for (auto& index : indices) { index ^= 1; }
+    }
+    else if (color0 == color1)
+    {
+        std::memset(indices, 0, sizeof(indices));
+    }
+
+    uint32_t packedIndices = 0;
+    for (size_t i = 0; i < 16; ++ i) { packedIndices |= static_cast<uint32_t>(indices[i]) << (i * 2); }
+
+    block[0] = static_cast<uint8_t>(color0);
+    block[1] = static_cast<uint8_t>(color0 >> 8);
+    block[2] = static_cast<uint8_t>(color1);
+    block[3] = static_cast<uint8_t>(color1 >> 8);
+    std::memcpy(block + 4, &packedIndices, sizeof(packedIndices));
+
+    return error;
+}
+
+float TextureCompressor::encodeBc7Block(const uint8_t* texels, uint8_t* block)
+{
+    float colors[16][4];
+    for (size_t i = 0; i < 16; ++ i)
+    {
+        for (size_t c = 0; c < 4; ++ c) { colors[i][c] = static_cast<float>(texels[i * 4 + c]); }
+    }
+
+    // 1. Initial endpoints at the extremes along the principal axis, as for BC1 but in RGBA.
+    float mean[4], axis[4], end0[4], end1[4];
+    computePrincipalAxis(colors, 4, mean, axis);
+    extremesAlongAxis(colors, mean, axis, 4, end0, end1);
+
+    uint8_t quantized0[4], quantized1[4], pBit0, pBit1;
+    quantizeBc7Endpoint(end0, quantized0, pBit0);
+    quantizeBc7Endpoint(end1, quantized1, pBit1);
+    uint8_t indices[16];
+    float error = selectBc7Indices(colors, quantized0, pBit0, quantized1, pBit1, indices);
+
+    // 2. Refit the endpoints to the chosen indices for as long as that helps.
+    for (int iteration = 0; iteration < 2 && error > 0.f; ++ iteration)
+    {
+        float weights[16];
+        for (size_t i = 0; i < 16; ++ i) { weights[i] = 1.f - BC7_WEIGHTS[indices[i]] / 64.f; }
+        if (!fitEndpoints(colors, weights, 4, end0, end1)) { break; }
+
+        uint8_t refit0[4], refit1[4], refitPBit0, refitPBit1;
+        quantizeBc7Endpoint(end0, refit0, refitPBit0);
+        quantizeBc7Endpoint(end1, refit1, refitPBit1);
+        uint8_t refitIndices[16];
+        float refitError = selectBc7Indices(colors, refit0, refitPBit0, refit1, refitPBit1, refitIndices);
+        if (refitError >= error) { break; }
+
+        std::memcpy(quantized0, refit0, 4);
+        std::memcpy(quantized1, refit1, 4);
+        pBit0 = refitPBit0;
+        pBit1 = refitPBit1;
+        error = refitError;
+        std::memcpy(indices, refitIndices, sizeof(indices));
+    }
+
+    // 3. The first texel's index is stored without its top bit, which must therefore be zero. If it
+    //    is not, swap the endpoints and mirror every index.
+    if (indices[0] >= 8)
+    {
+        std::swap_ranges(quantized0, quantized0 + 4, quantized1);
+        std::swap(pBit0, pBit1);
+        for (auto& index : indices) { index = static_cast<uint8_t>(15 - index); }
+    }
+
+    std::memset(block, 0, 16);
+    BitWriter writer { block, 0 };
+    writer.write(1 << 6, 7);            // Mode 6: six zero bits, then a one.
+    for (size_t c = 0; c < 4; ++ c)
+    {
+        writer.write(quantized0[c], 7);
+        writer.write(quantized1[c], 7);
+    }
+    writer.write(pBit0, 1);
+    writer.write(pBit1, 1);
+    for (size_t i = 0; i < 16; ++ i)
+    {
+        writer.write(indices[i], i == 0 ? 3 : 4);
+    }
+
+    return error;
+}
+
+float TextureCompressor::encode(TextureCompression compression, const uint8_t* rgba, uint32_t width,
+    uint32_t height, uint8_t* blocks, ThreadPool& threadPool)
+{
+    if (compression == TextureCompression::None)
+    {
+        throw std::invalid_argument("texture compression none has no block encoder");
+    }
+
+    size_t blockSize = getBlockSize(compression);
+    uint32_t blocksWide = (width + 3) / 4;
+    uint32_t blocksHigh = (height + 3) / 4;
+    std::vector<double> rowErrors(blocksHigh, 0.0);
+
+    threadPool.parallelFor(blocksHigh, [&](size_t blockY) {
+        uint8_t texels[64];
+        double rowError = 0.0;
+
+        for (uint32_t blockX = 0; blockX < blocksWide; ++ blockX)
+        {
+            for (uint32_t y = 0; y < 4; ++ y)
+            {
+                uint32_t sourceY = std::min(static_cast<uint32_t>(blockY) * 4 + y, height - 1);
+                for (uint32_t x = 0; x < 4; ++ x)
+                {
+                    uint32_t sourceX = std::min(blockX * 4 + x, width - 1);
+                    std::memcpy(texels + (y * 4 + x) * 4, rgba + (static_cast<size_t>(sourceY) * width + sourceX) * 4, 4);
+                }
+            }
+
+            uint8_t* block = blocks + (blockY * blocksWide + blockX) * blockSize;
+            rowError += compression == TextureCompression::Bc1 ?
+                encodeBc1Block(texels, block) : encodeBc7Block(texels, block);
+        }
+
+        rowErrors[blockY] = rowError;
+    });
+
+    double totalError = 0.0;
+    for (double rowError : rowErrors) { totalError += rowError; }
+
+    size_t channelCount = compression == TextureCompression::Bc1 ? 3 : 4;
+    double sampleCount = static_cast<double>(blocksWide) * blocksHigh * 16 * channelCount;
+    return static_cast<float>(std::sqrt(totalError / sampleCount));
+}
+
+size_t TextureCompressor::getBlockSize(TextureCompression compression)
+{
+    if (compression == TextureCompression::Bc1) { return 8; }
+    if (compression == TextureCompression::Bc7) { return 16; }
+    return 0;
+}
+
+size_t TextureCompressor::getEncodedSize(TextureCompression compression, uint32_t width, uint32_t height)
+{
+    return getBlockSize(compression) * ((width + 3) / 4) * ((height + 3) / 4);
+}
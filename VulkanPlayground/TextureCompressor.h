@@ -0,0 +1,44 @@
+#pragma once
+
+#include "ThreadPool.h"
+
+#include <cstddef>
+#include <cstdint>
+
+/* ************************************************************************************************
+ * Global Enums
+ * ************************************************************************************************/
+enum class TextureCompression
+{
+    None,               // R8G8B8A8, 4 bytes per texel.
+    Bc1,                // Opaque RGB, 8 bytes per 4x4 block (0.5 bytes per texel).
+    Bc7                 // RGBA, 16 bytes per 4x4 block (1 byte per texel).
+};
+
+/*! ***********************************************************************************************
+ * \class   TextureCompressor
+ * \brief   CPU encoder from 8-bit RGBA to the BC1 and BC7 block formats. Both fit the block's colors
+ *          along their principal axis and refine the endpoints by least squares against the chosen
+ *          indices. BC7 is written in mode 6 only (one subset, 7-bit RGBA endpoints with a p-bit and
+ *          4-bit indices), which is fast and never worse than BC1 but leaves the partitioned modes'
+ *          extra quality on the table. Texels are encoded in the space they are stored in, so sRGB
+ *          input belongs in an sRGB block format.
+ * \author  Leon Vincii
+ * \date    2026.10.16
+ * ************************************************************************************************/
+class TextureCompressor
+{
+public:
+    /* ********************************************************************************************
+     * Public Functions
+     * ********************************************************************************************/
+    // Encodes one 4x4 block of RGBA texels (row-major, 64 bytes); returns the summed squared error.
+    static float encodeBc1Block(const uint8_t* texels, uint8_t* block);
+    static float encodeBc7Block(const uint8_t* texels, uint8_t* block);
+    // Encodes a whole image, block rows in parallel; partial edge blocks repeat the last row and
+    // column. Returns the RMS error per encoded channel on the 0-255 scale.
+    static float encode(TextureCompression compression, const uint8_t* rgba, uint32_t width, uint32_t height,
+        uint8_t* blocks, ThreadPool& threadPool);
+    static size_t getBlockSize(TextureCompression compression);
+    static size_t getEncodedSize(TextureCompression compression, uint32_t width, uint32_t height);
+};
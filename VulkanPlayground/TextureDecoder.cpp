@@ -0,0 +1,162 @@
+#include "TextureDecoder.h"
+
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+
+#if __has_include(<spng.h>)
+#include <spng.h>
+#define TEXTURE_DECODER_SPNG
+#ifdef _MSC_VER
+#pragma comment(lib, "spng.lib")
+#endif
+#endif
+
+#if __has_include(<turbojpeg.h>)
+#include <turbojpeg.h>
+#define TEXTURE_DECODER_TURBOJPEG
+#ifdef _MSC_VER
+#pragma comment(lib, "turbojpeg.lib")
+#endif
+#endif
+
+/* ************************************************************************************************
+ * Local Functions
+ * ************************************************************************************************/
+namespace
+{
+bool isPng(const uint8_t* data, size_t size)
+{
+    const uint8_t signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+    return size >= sizeof(signature) && std::memcmp(data, signature, sizeof(signature)) == 0;
+}
+
+bool isJpeg(const uint8_t* data, size_t size)
+{
+    return size >= 3 && data[0] == 0xff && data[1] == 0xd8 && data[2] == 0xff;
+}
+
+#ifdef TEXTURE_DECODER_SPNG
+using SpngContext = std::unique_ptr<spng_ctx, decltype(&spng_ctx_free)>;
+
+SpngContext createSpngContext(const uint8_t* data, size_t size)
+{
+    SpngContext context(spng_ctx_new(0), &spng_ctx_free);
+    if (!context || spng_set_png_buffer(context.get(), data, size) != 0)
+    {
+        return SpngContext(nullptr, &spng_ctx_free);
+    }
+    return context;
+}
+#endif
+
+#ifdef TEXTURE_DECODER_TURBOJPEG
+using TurboJpegHandle = std::unique_ptr<void, decltype(&tjDestroy)>;
+#endif
+}
+
+/*! ***********************************************************************************************
+ * \class   TextureDecoder
+ * \author  Leon Vincii
+ * \date    2026.10.16
+ * ************************************************************************************************/
+/* ************************************************************************************************
+ * Public Functions
+ * ************************************************************************************************/
+bool TextureDecoder::readInfo(const uint8_t* data, size_t size, uint32_t& width, uint32_t& height)
+{
+#ifdef TEXTURE_DECODER_SPNG
+    if (isPng(data, size))
+    {
+        SpngContext context = createSpngContext(data, size);
+        spng_ihdr header {};
+        if (!context || spng_get_ihdr(context.get(), &header) != 0) { return false; }
+
+        width = header.width;
+        height = header.height;
+        return true;
+    }
+#endif
+#ifdef TEXTURE_DECODER_TURBOJPEG
+    if (isJpeg(data, size))
+    {
+        TurboJpegHandle handle(tjInitDecompress(), &tjDestroy);
+        int jpegWidth, jpegHeight, subsampling, colorspace;
+        if (!handle || tjDecompressHeader3(handle.get(), data, static_cast<unsigned long>(size), &jpegWidth,
+            &jpegHeight, &subsampling, &colorspace) != 0)
+        {
+            return false;
+        }
+
+        width = static_cast<uint32_t>(jpegWidth);
+        height = static_cast<uint32_t>(jpegHeight);
+        return true;
+    }
+#endif
+
+    int imageWidth, imageHeight, channels;
+    if (!stbi_info_from_memory(data, static_cast<int>(size), &imageWidth, &imageHeight, &channels)) { return false; }
+
+    width = static_cast<uint32_t>(imageWidth);
+    height = static_cast<uint32_t>(imageHeight);
+    return true;
+}
+
+void TextureDecoder::decode(const uint8_t* data, size_t size, uint8_t* rgba, uint32_t width, uint32_t height)
+{
+    size_t byteCount = static_cast<size_t>(width) * height * 4;
+
+#ifdef TEXTURE_DECODER_SPNG
+    if (isPng(data, size))
+    {
+        SpngContext context = createSpngContext(data, size);
+        if (!context || spng_decode_image(context.get(), rgba, byteCount, SPNG_FMT_RGBA8, 0) != 0)
+        {
+            throw std::runtime_error("failed to decode PNG image");
+        }
+        return;
+    }
+#endif
+#ifdef TEXTURE_DECODER_TURBOJPEG
+    if (isJpeg(data, size))
+    {
+        TurboJpegHandle handle(tjInitDecompress(), &tjDestroy);
+        if (!handle || tjDecompress2(handle.get(), data, static_cast<unsigned long>(size), rgba,
+            static_cast<int>(width), 0, static_cast<int>(height), TJPF_RGBA, TJFLAG_FASTDCT) != 0)
+        {
+            throw std::runtime_error("failed to decode JPEG image");
+        }
+        return;
+    }
+#endif
+
+    int imageWidth, imageHeight, channels;
+    stbi_uc* pixels = stbi_load_from_memory(data, static_cast<int>(size), &imageWidth, &imageHeight, &channels,
+        STBI_rgb_alpha);
+    if (!pixels)
+    {
+        throw std::runtime_error("failed to decode texture image");
+    }
+    if (static_cast<uint32_t>(imageWidth) != width || static_cast<uint32_t>(imageHeight) != height)
+    {
+        stbi_image_free(pixels);
+        throw std::runtime_error("texture image size does not match its header");
+    }
+
+    std::memcpy(rgba, pixels, byteCount);
+    stbi_image_free(pixels);
+}
+
+const char* TextureDecoder::getDecoderName(const uint8_t* data, size_t size)
+{
+#ifdef TEXTURE_DECODER_SPNG
+    if (isPng(data, size)) { return "libspng"; }
+#endif
+#ifdef TEXTURE_DECODER_TURBOJPEG
+    if (isJpeg(data, size)) { return "libjpeg-turbo"; }
+#endif
+    return "stb_image";
+}
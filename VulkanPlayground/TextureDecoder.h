@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/*! ***********************************************************************************************
+ * \class   TextureDecoder
+ * \brief   Decodes PNG, JPEG and whatever else stb_image reads from memory to 8-bit RGBA, straight into
+ *          memory the caller provides, e.g. a mapped staging buffer. libspng and libjpeg-turbo are used
+ *          for their formats when their headers are found at build time; they decode in place and
+ *          are several times faster than stb_image, which has to decode into its own allocation first.
+ *          All functions are thread-safe.
+ * \author  Leon Vincii
+ * \date    2026.10.16
+ * ************************************************************************************************/
+class TextureDecoder
+{
+public:
+    /* ********************************************************************************************
+     * Public Functions
+     * ********************************************************************************************/
+    // Reads the image dimensions from the file header; false if the data is not a readable image.
+    static bool readInfo(const uint8_t* data, size_t size, uint32_t& width, uint32_t& height);
+    // Decodes the whole image into rgba, which must hold width * height * 4 bytes as reported by
+    // readInfo(). Throws if the data cannot be decoded.
+    static void decode(const uint8_t* data, size_t size, uint8_t* rgba, uint32_t width, uint32_t height);
+    // Name of the library that decodes the given data, for reports.
+    static const char* getDecoderName(const uint8_t* data, size_t size);
+};
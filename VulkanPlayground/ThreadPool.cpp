@@ -0,0 +1,99 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <exception>
+
+/*! ***********************************************************************************************
+ * \class   ThreadPool
+ * \author  Leon Vincii
+ * \date    2026.10.16
+ * ************************************************************************************************/
+/* ************************************************************************************************
+ * Public Ctor & Dtor
+ * ************************************************************************************************/
+ThreadPool::ThreadPool(size_t threadCount) :
+    m_condition                 ()
+  , m_mutex                     ()
+  , m_stopping                  (false)
+  , m_tasks                     ()
+  , m_workers                   ()
+{
+    // hardware_concurrency() is allowed to return 0 when the count is unknown.
+    threadCount = std::max<size_t>(threadCount, 1);
+
+    m_workers.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; ++ i)
+    {
+        m_workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_condition.notify_all();
+
+    for (auto& worker : m_workers)
+    {
+        worker.join();
+    }
+}
+
+/* ************************************************************************************************
+ * Public Functions
+ * ************************************************************************************************/
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t)>& func)
+{
+    // Run each index as its own task and block until all of them have finished. Exceptions thrown
+    // by any task are rethrown here, on the calling thread.
+    std::vector<std::future<void>> futures;
+    futures.reserve(count);
+
+    for (size_t i = 0; i < count; ++ i)
+    {
+        futures.push_back(submit([&func, i]() { func(i); }));
+    }
+
+    // Wait for every task before rethrowing, since the tasks still reference func.
+    std::exception_ptr firstException;
+    for (auto& future : futures)
+    {
+        try
+        {
+            future.get();
+        }
+        catch (...)
+        {
+            if (!firstException) { firstException = std::current_exception(); }
+        }
+    }
+
+    if (firstException)
+    {
+        std::rethrow_exception(firstException);
+    }
+}
+
+/* ************************************************************************************************
+ * Private Functions
+ * ************************************************************************************************/
+void ThreadPool::workerLoop()
+{
+    while (true)
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [this]() { return m_stopping || !m_tasks.empty(); });
+
+            if (m_stopping && m_tasks.empty()) { return; }
+
+            task = std::move(m_tasks.front());
+            m_tasks.pop();
+        }
+        task();
+    }
+}
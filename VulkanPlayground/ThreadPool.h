@@ -0,0 +1,69 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/*! ***********************************************************************************************
+ * \class   ThreadPool
+ * \brief   Fixed set of worker threads pulling tasks from a single FIFO queue. Used for CPU-side
+ *          asset work (model parsing, mesh processing) that is split into independent chunks.
+ * \author  Leon Vincii
+ * \date    2026.10.16
+ * ************************************************************************************************/
+class ThreadPool
+{
+public:
+    /* ********************************************************************************************
+     * Public Ctor & Dtor
+     * ********************************************************************************************/
+    explicit ThreadPool(size_t threadCount = std::thread::hardware_concurrency());
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /* ********************************************************************************************
+     * Public Functions
+     * ********************************************************************************************/
+    void parallelFor(size_t count, const std::function<void(size_t)>& func);
+    size_t threadCount() const { return m_workers.size(); }
+
+    template<typename F>
+    auto submit(F&& func) -> std::future<std::invoke_result_t<F>>
+    {
+        using Result = std::invoke_result_t<F>;
+
+        auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(func));
+        std::future<Result> future = task->get_future();
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_tasks.emplace([task]() { (*task)(); });
+        }
+        m_condition.notify_one();
+
+        return future;
+    }
+
+private:
+    /* ********************************************************************************************
+     * Private Functions
+     * ********************************************************************************************/
+    void workerLoop();
+
+    /* ********************************************************************************************
+     * Private Attributes
+     * ********************************************************************************************/
+    std::condition_variable             m_condition;
+    std::mutex                          m_mutex;
+    bool                                m_stopping;
+    std::queue<std::function<void()>>   m_tasks;
+    std::vector<std::thread>            m_workers;
+};
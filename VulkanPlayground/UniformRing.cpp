@@ -0,0 +1,74 @@
+#include "UniformRing.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+/* ************************************************************************************************
+ * Local Functions
+ * ************************************************************************************************/
+namespace
+{
+uint64_t alignUp(uint64_t value, uint64_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+}
+
+/*! ***********************************************************************************************
+ * \class   UniformRing
+ * \author  Leon Vincii
+ * \date    2026.10.16
+ * ************************************************************************************************/
+/* ************************************************************************************************
+ * Public Ctor & Dtor
+ * ************************************************************************************************/
+UniformRing::UniformRing() :
+    m_alignment                 (1)
+  , m_data                      (nullptr)
+  , m_frameBegin                (0)
+  , m_frameCount                (0)
+  , m_frameSize                 (0)
+  , m_head                      (0)
+{}
+
+/* ************************************************************************************************
+ * Public Functions
+ * ************************************************************************************************/
+uint64_t UniformRing::getSize(uint64_t frameSize, uint32_t frameCount, uint64_t alignment)
+{
+    return alignUp(frameSize, std::max<uint64_t>(alignment, 1)) * frameCount;
+}
+
+void UniformRing::reset(uint8_t* data, uint64_t frameSize, uint32_t frameCount, uint64_t alignment)
+{
+    m_alignment = std::max<uint64_t>(alignment, 1);
+    m_data = data;
+    m_frameCount = frameCount;
+    m_frameSize = alignUp(frameSize, m_alignment);
+    beginFrame(0);
+}
+
+void UniformRing::beginFrame(uint32_t frameIndex)
+{
+    m_frameBegin = m_frameSize * (frameIndex % std::max(m_frameCount, 1u));
+    m_head = m_frameBegin;
+}
+
+uint32_t UniformRing::push(const void* data, uint64_t size)
+{
+    // Reserving the aligned size keeps the next block aligned as well.
+    uint64_t offset = m_head.fetch_add(alignUp(std::max<uint64_t>(size, 1), m_alignment));
+    if (offset + size > m_frameBegin + m_frameSize)
+    {
+        throw std::runtime_error("uniform ring is out of space for this frame");
+    }
+
+    memcpy(m_data + offset, data, static_cast<size_t>(size));
+    return static_cast<uint32_t>(offset);
+}
+
+uint64_t UniformRing::frameUsage() const
+{
+    return std::min(m_head.load(), m_frameBegin + m_frameSize) - m_frameBegin;
+}
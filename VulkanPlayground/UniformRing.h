@@ -0,0 +1,56 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+/*! ***********************************************************************************************
+ * \class   UniformRing
+ * \brief   Per-frame sub-allocation of a persistently mapped uniform buffer. The buffer is split into
+ *          one region per frame in flight; a frame bumps through its region, and the region is
+ *          reused once the frame that last filled it has finished on the GPU. Every block starts at
+ *          a multiple of the alignment, minUniformBufferOffsetAlignment, so that it can be bound
+ *          with a dynamic offset; nothing is mapped, flushed or allocated per frame. push() may be
+ *          called from several threads at once.
+ * \author  Leon Vincii
+ * \date    2026.10.16
+ * ************************************************************************************************/
+class UniformRing
+{
+public:
+    /* ********************************************************************************************
+     * Public Ctor & Dtor
+     * ********************************************************************************************/
+    UniformRing();
+
+    UniformRing(const UniformRing&) = delete;
+    UniformRing& operator=(const UniformRing&) = delete;
+
+    /* ********************************************************************************************
+     * Public Functions
+     * ********************************************************************************************/
+    // Size of a ring of frameCount regions of at least frameSize bytes each.
+    static uint64_t getSize(uint64_t frameSize, uint32_t frameCount, uint64_t alignment);
+
+    // data points at the mapped buffer, of getSize() bytes.
+    void reset(uint8_t* data, uint64_t frameSize, uint32_t frameCount, uint64_t alignment);
+    // Starts filling the region of frameIndex, whose previous contents the GPU must be done with.
+    void beginFrame(uint32_t frameIndex);
+    // Copies size bytes into the current frame's region and returns their offset within the buffer.
+    // Throws if the region is full.
+    uint32_t push(const void* data, uint64_t size);
+
+    uint64_t frameSize() const { return m_frameSize; }
+    // Bytes the current frame has taken so far.
+    uint64_t frameUsage() const;
+
+private:
+    /* ********************************************************************************************
+     * Private Attributes
+     * ********************************************************************************************/
+    uint64_t                        m_alignment;
+    uint8_t*                        m_data;
+    uint64_t                        m_frameBegin;
+    uint32_t                        m_frameCount;
+    uint64_t                        m_frameSize;
+    std::atomic<uint64_t>           m_head;
+};
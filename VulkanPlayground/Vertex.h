@@ -0,0 +1,143 @@
+#pragma once
+
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+#include <glm/glm.hpp>
+
+#define GLM_ENABLE_EXPERIMENTAL
+#include <glm/gtx/hash.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+/* ************************************************************************************************
+ * Global Structs
+ * ************************************************************************************************/
+struct Vertex
+{
+    glm::vec3 pos;
+    glm::vec3 color;
+    glm::vec2 textureCoord;
+
+    // Vertices are compared bit for bit, which keeps equality consistent with hashVertex() (a float
+    // compare would treat 0.0 and -0.0 as equal while hashing them differently).
+    bool operator==(const Vertex& other) const
+    {
+        return std::memcmp(this, &other, sizeof(Vertex)) == 0;
+    }
+
+    static VkVertexInputBindingDescription getBindingDescription()
+    {
+        VkVertexInputBindingDescription bindingDescription {};
+        bindingDescription.binding = 0;
+        bindingDescription.stride = sizeof(Vertex);
+        bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+
+        return bindingDescription;
+    }
+
+    static std::array<VkVertexInputAttributeDescription, 3> getAttributeDescriptions()
+    {
+        // Return two attribute description structs, one for position and one for color.
+        std::array<VkVertexInputAttributeDescription, 3> attributeDescriptions {};
+        // Read position attributes.
+        attributeDescriptions[0].binding = 0;
+        attributeDescriptions[0].location = 0;
+        attributeDescriptions[0].format = VK_FORMAT_R32G32B32_SFLOAT;
+        attributeDescriptions[0].offset = offsetof(Vertex, pos);
+        // Read color attributes.
+        attributeDescriptions[1].binding = 0;
+        attributeDescriptions[1].location = 1;
+        attributeDescriptions[1].format = VK_FORMAT_R32G32B32_SFLOAT;
+        attributeDescriptions[1].offset = offsetof(Vertex, color);
+        // Read texture coordinate attributes.
+        attributeDescriptions[2].binding = 0;
+        attributeDescriptions[2].location = 2;
+        attributeDescriptions[2].format = VK_FORMAT_R32G32_SFLOAT;
+        attributeDescriptions[2].offset = offsetof(Vertex, textureCoord);
+
+        return attributeDescriptions;
+    }
+};
+
+static_assert(sizeof(Vertex) % sizeof(uint64_t) == 0, "Vertex must be hashable in 64-bit words");
+
+// Placement of one instance of an instanced draw, advanced per instance from vertex binding 1: a
+// translation, a uniform scale and a rotation quaternion, half the size of a model matrix.
+struct InstanceData
+{
+    // Translation in xyz, uniform scale in w.
+    glm::vec4 positionScale;
+    // Unit quaternion, (x, y, z, w).
+    glm::vec4 rotation;
+
+    static VkVertexInputBindingDescription getBindingDescription()
+    {
+        VkVertexInputBindingDescription bindingDescription {};
+        bindingDescription.binding = 1;
+        bindingDescription.stride = sizeof(InstanceData);
+        bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_INSTANCE;
+
+        return bindingDescription;
+    }
+
+    static std::array<VkVertexInputAttributeDescription, 2> getAttributeDescriptions()
+    {
+        // Locations follow those of the vertex, see shader_instanced.vert.
+        std::array<VkVertexInputAttributeDescription, 2> attributeDescriptions {};
+        attributeDescriptions[0].binding = 1;
+        attributeDescriptions[0].location = 3;
+        attributeDescriptions[0].format = VK_FORMAT_R32G32B32A32_SFLOAT;
+        attributeDescriptions[0].offset = offsetof(InstanceData, positionScale);
+        attributeDescriptions[1].binding = 1;
+        attributeDescriptions[1].location = 4;
+        attributeDescriptions[1].format = VK_FORMAT_R32G32B32A32_SFLOAT;
+        attributeDescriptions[1].offset = offsetof(InstanceData, rotation);
+
+        return attributeDescriptions;
+    }
+};
+
+/* ************************************************************************************************
+ * Global Functions
+ * ************************************************************************************************/
+inline uint64_t hashVertex(const Vertex& vertex)
+{
+    /***
+     * Hash the raw bytes of the vertex one 64-bit word at a time and finish with the MurmurHash3
+     * 64-bit finaliser. Unlike combining per-member glm hashes with shifts and XORs, every input bit
+     * reaches every output bit, so grid-like meshes with many repeated coordinates do not pile up
+     * in the same buckets.
+     ***/
+    const uint64_t multiplier = 0x9e3779b97f4a7c15ull;
+
+    uint64_t hash = sizeof(Vertex);
+    for (size_t offset = 0; offset < sizeof(Vertex); offset += sizeof(uint64_t))
+    {
+        uint64_t word;
+        std::memcpy(&word, reinterpret_cast<const char*>(&vertex) + offset, sizeof(word));
+        hash = (hash ^ (word * multiplier)) * multiplier;
+        hash ^= hash >> 29;
+    }
+
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdull;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ull;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+namespace std
+{
+template<> struct hash<Vertex>
+{
+    size_t operator()(Vertex const& vertex) const
+    {
+        return static_cast<size_t>(hashVertex(vertex));
+    }
+};
+}
@@ -0,0 +1,115 @@
+#include "VertexDedupTable.h"
+
+#include <algorithm>
+
+/* ************************************************************************************************
+ * Global Structs
+ * ************************************************************************************************/
+void VertexDedupStats::merge(const VertexDedupStats& other)
+{
+    lookups += other.lookups;
+    inserts += other.inserts;
+    collisions += other.collisions;
+    hashCollisions += other.hashCollisions;
+    totalProbes += other.totalProbes;
+    maxProbeLength = std::max(maxProbeLength, other.maxProbeLength);
+    capacity += other.capacity;
+}
+
+/*! ***********************************************************************************************
+ * \class   VertexDedupTable
+ * \author  Leon Vincii
+ * \date    2026.10.16
+ * ************************************************************************************************/
+const uint32_t VertexDedupTable::m_EMPTY = ~0u;
+
+/* ************************************************************************************************
+ * Public Ctor & Dtor
+ * ************************************************************************************************/
+VertexDedupTable::VertexDedupTable(size_t maxVertexCount) :
+    m_count                     (0)
+  , m_mask                      (0)
+  , m_slots                     ()
+  , m_stats                     ()
+{
+    // Size the table so that it stays at most 75% full even if every vertex turns out to be unique;
+    // the index count of a mesh is a hard upper bound on its unique vertex count, so with that as
+    // the argument the table never has to grow.
+    size_t capacity = 16;
+    while (capacity * 3 < maxVertexCount * 4) { capacity *= 2; }
+
+    m_slots.assign(capacity, Slot { 0, m_EMPTY });
+    m_mask = capacity - 1;
+    m_stats.capacity = static_cast<uint32_t>(capacity);
+}
+
+/* ************************************************************************************************
+ * Public Functions
+ * ************************************************************************************************/
+uint32_t VertexDedupTable::findOrInsert(const Vertex& vertex, std::vector<Vertex>& vertices)
+{
+    if ((m_count + 1) * 4 > m_slots.size() * 3)
+    {
+        grow(vertices);
+    }
+
+    uint64_t hash = hashVertex(vertex);
+    uint32_t tag = static_cast<uint32_t>(hash >> 32);
+    size_t slot = static_cast<size_t>(hash) & m_mask;
+
+    ++ m_stats.lookups;
+
+    // Walk the probe sequence until we either find the vertex or an empty slot to insert it into.
+    uint32_t probeLength = 1;
+    while (m_slots[slot].index != m_EMPTY)
+    {
+        const Slot& candidate = m_slots[slot];
+        if (candidate.hash == tag)
+        {
+            if (vertices[candidate.index] == vertex) { break; }
+            ++ m_stats.hashCollisions;
+        }
+
+        slot = (slot + 1) & m_mask;
+        ++ probeLength;
+    }
+
+    m_stats.totalProbes += probeLength;
+    m_stats.maxProbeLength = std::max(m_stats.maxProbeLength, probeLength);
+    if (probeLength > 1) { ++ m_stats.collisions; }
+
+    if (m_slots[slot].index != m_EMPTY)
+    {
+        return m_slots[slot].index;
+    }
+
+    uint32_t index = static_cast<uint32_t>(vertices.size());
+    vertices.push_back(vertex);
+    m_slots[slot] = Slot { tag, index };
+    ++ m_count;
+    ++ m_stats.inserts;
+
+    return index;
+}
+
+/* ************************************************************************************************
+ * Private Functions
+ * ************************************************************************************************/
+void VertexDedupTable::grow(const std::vector<Vertex>& vertices)
+{
+    // Only reached if the table was sized below the final unique vertex count. The full hash is
+    // recomputed from the stored vertices because the slots only keep the upper 32 bits.
+    std::vector<Slot> oldSlots(m_slots.size() * 2, Slot { 0, m_EMPTY });
+    oldSlots.swap(m_slots);
+    m_mask = m_slots.size() - 1;
+    m_stats.capacity = static_cast<uint32_t>(m_slots.size());
+
+    for (const Slot& oldSlot : oldSlots)
+    {
+        if (oldSlot.index == m_EMPTY) { continue; }
+
+        size_t slot = static_cast<size_t>(hashVertex(vertices[oldSlot.index])) & m_mask;
+        while (m_slots[slot].index != m_EMPTY) { slot = (slot + 1) & m_mask; }
+        m_slots[slot] = oldSlot;
+    }
+}
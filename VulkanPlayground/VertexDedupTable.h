@@ -0,0 +1,74 @@
+#pragma once
+
+#include "Vertex.h"
+
+#include <cstdint>
+#include <vector>
+
+/* ************************************************************************************************
+ * Global Structs
+ * ************************************************************************************************/
+struct VertexDedupStats
+{
+    uint64_t    lookups;
+    uint64_t    inserts;
+    uint64_t    collisions;         // Lookups whose home slot held a different vertex.
+    uint64_t    hashCollisions;     // Probed slots with an equal 32-bit hash tag but a different vertex.
+    uint64_t    totalProbes;
+    uint32_t    maxProbeLength;
+    uint32_t    capacity;
+
+    void merge(const VertexDedupStats& other);
+    double averageProbeLength() const { return lookups ? static_cast<double>(totalProbes) / lookups : 0.0; }
+};
+
+/*! ***********************************************************************************************
+ * \class   VertexDedupTable
+ * \brief   Flat, linearly probed hash index from vertex contents to vertex index. The table only
+ *          stores 32-bit hash tags and indices into the caller's vertex array, so each lookup is a
+ *          single probe sequence over one contiguous allocation and nothing is allocated per
+ *          vertex.
+ * \author  Leon Vincii
+ * \date    2026.10.16
+ * ************************************************************************************************/
+class VertexDedupTable
+{
+public:
+    /* ********************************************************************************************
+     * Public Ctor & Dtor
+     * ********************************************************************************************/
+    explicit VertexDedupTable(size_t maxVertexCount);
+
+    /* ********************************************************************************************
+     * Public Functions
+     * ********************************************************************************************/
+    // Returns the index of the vertex in vertices, appending it first if it is not there yet.
+    uint32_t findOrInsert(const Vertex& vertex, std::vector<Vertex>& vertices);
+    const VertexDedupStats& stats() const { return m_stats; }
+
+private:
+    /* ********************************************************************************************
+     * Private Structs
+     * ********************************************************************************************/
+    struct Slot
+    {
+        uint32_t hash;
+        uint32_t index;
+    };
+
+    /* ********************************************************************************************
+     * Private Functions
+     * ********************************************************************************************/
+    void grow(const std::vector<Vertex>& vertices);
+
+    /* ********************************************************************************************
+     * Private Attributes
+     * ********************************************************************************************/
+    size_t                          m_count;
+    size_t                          m_mask;
+    std::vector<Slot>               m_slots;
+    VertexDedupStats                m_stats;
+
+    // Constants ----------------------------------------------------------------------------------/
+    static const uint32_t           m_EMPTY;
+};
@@ -1,7 +1,17 @@
+#include "Benchmark.h"
 #include "HelloTriangleApp.h"
 
-int main()
+int main(int argc, char** argv)
 {
+    try {
+        if (runBenchmark(argc, argv)) {
+            return EXIT_SUCCESS;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
     HelloTriangleApplication app;
 
     try {
@@ -1,3 +1,10 @@
 C:/VulkanSDK/1.2.154.1/Bin32/glslc.exe shader.vert -o vert.spv
 C:/VulkanSDK/1.2.154.1/Bin32/glslc.exe shader.frag -o frag.spv
+C:/VulkanSDK/1.2.154.1/Bin32/glslc.exe shader_packed.vert -o vert_packed.spv
+C:/VulkanSDK/1.2.154.1/Bin32/glslc.exe shader_bindless.frag -o frag_bindless.spv
+C:/VulkanSDK/1.2.154.1/Bin32/glslc.exe shader_indirect.vert -o vert_indirect.spv
+C:/VulkanSDK/1.2.154.1/Bin32/glslc.exe shader_instanced.vert -o vert_instanced.spv
+C:/VulkanSDK/1.2.154.1/Bin32/glslc.exe shader_cull.comp -o cull.spv
+C:/VulkanSDK/1.2.154.1/Bin32/glslc.exe shader_depth_reduce.comp -o depth_reduce.spv
+C:/VulkanSDK/1.2.154.1/Bin32/glslc.exe -DMULTISAMPLED shader_depth_reduce.comp -o depth_reduce_ms.spv
 pause
\ No newline at end of file
@@ -8,6 +8,12 @@ layout(binding = 0) uniform UniformBufferObject
     mat4 proj;
 } ubo;
 
+// The object's placement, pushed per draw; the uniform block is the frame's.
+layout(push_constant) uniform PushConstants
+{
+    mat4 transform;
+} pushConstants;
+
 layout(location = 0) in vec3 inPosition;
 layout(location = 1) in vec3 inColor;
 layout(location = 2) in vec2 inTextureCoord;
@@ -16,6 +22,6 @@ layout(location = 0) out vec2 outTextureCoord;
 
 void main()
 {
-    gl_Position = ubo.proj * ubo.view * ubo.model * vec4(inPosition, 1.0);
+    gl_Position = ubo.proj * ubo.view * pushConstants.transform * ubo.model * vec4(inPosition, 1.0);
     outTextureCoord = inTextureCoord;
 }
\ No newline at end of file
@@ -0,0 +1,21 @@
+#version 450
+#extension GL_ARB_separate_shader_objects: enable
+#extension GL_EXT_nonuniform_qualifier: enable
+
+// Every texture of the scene, in an update-after-bind set of its own; the draw selects its texture
+// with a push constant.
+layout(set = 1, binding = 0) uniform sampler2D textureSamplers[];
+
+// The vertex stage's transform comes first in the push constants.
+layout(push_constant) uniform PushConstants
+{
+    layout(offset = 64) uint textureIndex;
+} pushConstants;
+
+layout(location = 0) in vec2 inFragTextureCoord;
+
+layout(location = 0) out vec4 outColor;
+
+void main() {
+    outColor = texture(textureSamplers[pushConstants.textureIndex], inFragTextureCoord);
+}
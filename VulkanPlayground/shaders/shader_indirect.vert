@@ -0,0 +1,36 @@
+#version 450
+#extension GL_ARB_separate_shader_objects: enable
+
+layout(binding = 0) uniform UniformBufferObject
+{
+    mat4 model;
+    mat4 view;
+    mat4 proj;
+    vec4 positionScale;
+    vec4 positionOffset;
+    vec4 textureCoordTransform;
+} ubo;
+
+struct ObjectData
+{
+    mat4 transform;
+};
+
+// Every draw command passes the index of its object as the first instance.
+layout(std430, binding = 2) readonly buffer ObjectBuffer
+{
+    ObjectData objects[];
+};
+
+// The vertex decode maps packed attributes back to the mesh bounds; for floats it is the identity.
+layout(location = 0) in vec3 inPosition;
+layout(location = 2) in vec2 inTextureCoord;
+
+layout(location = 0) out vec2 outTextureCoord;
+
+void main()
+{
+    vec3 position = ubo.positionOffset.xyz + ubo.positionScale.xyz * inPosition;
+    gl_Position = ubo.proj * ubo.view * objects[gl_InstanceIndex].transform * ubo.model * vec4(position, 1.0);
+    outTextureCoord = ubo.textureCoordTransform.zw + ubo.textureCoordTransform.xy * inTextureCoord;
+}
\ No newline at end of file
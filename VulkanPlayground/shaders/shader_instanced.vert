@@ -0,0 +1,37 @@
+#version 450
+#extension GL_ARB_separate_shader_objects: enable
+
+layout(binding = 0) uniform UniformBufferObject
+{
+    mat4 model;
+    mat4 view;
+    mat4 proj;
+    vec4 positionScale;
+    vec4 positionOffset;
+    vec4 textureCoordTransform;
+} ubo;
+
+// The vertex decode maps packed attributes back to the mesh bounds; for floats it is the identity.
+layout(location = 0) in vec3 inPosition;
+layout(location = 2) in vec2 inTextureCoord;
+
+// Advanced once per instance: translation and uniform scale, and a unit rotation quaternion.
+layout(location = 3) in vec4 inInstancePositionScale;
+layout(location = 4) in vec4 inInstanceRotation;
+
+layout(location = 0) out vec2 outTextureCoord;
+
+vec3 rotate(vec4 q, vec3 v)
+{
+    return v + 2.0 * cross(q.xyz, cross(q.xyz, v) + q.w * v);
+}
+
+void main()
+{
+    vec3 position = ubo.positionOffset.xyz + ubo.positionScale.xyz * inPosition;
+    vec4 modelPosition = ubo.model * vec4(position, 1.0);
+    vec3 worldPosition = inInstancePositionScale.xyz +
+                         rotate(inInstanceRotation, modelPosition.xyz * inInstancePositionScale.w);
+    gl_Position = ubo.proj * ubo.view * vec4(worldPosition, 1.0);
+    outTextureCoord = ubo.textureCoordTransform.zw + ubo.textureCoordTransform.xy * inTextureCoord;
+}
\ No newline at end of file
@@ -0,0 +1,31 @@
+#version 450
+#extension GL_ARB_separate_shader_objects: enable
+
+layout(binding = 0) uniform UniformBufferObject
+{
+    mat4 model;
+    mat4 view;
+    mat4 proj;
+    vec4 positionScale;
+    vec4 positionOffset;
+    vec4 textureCoordTransform;
+} ubo;
+
+// The object's placement, pushed per draw; the uniform block is the frame's.
+layout(push_constant) uniform PushConstants
+{
+    mat4 transform;
+} pushConstants;
+
+// Normalized 16-bit attributes arrive in [0, 1] and are mapped back to the mesh bounds here.
+layout(location = 0) in vec3 inPosition;
+layout(location = 2) in vec2 inTextureCoord;
+
+layout(location = 0) out vec2 outTextureCoord;
+
+void main()
+{
+    vec3 position = ubo.positionOffset.xyz + ubo.positionScale.xyz * inPosition;
+    gl_Position = ubo.proj * ubo.view * pushConstants.transform * ubo.model * vec4(position, 1.0);
+    outTextureCoord = ubo.textureCoordTransform.zw + ubo.textureCoordTransform.xy * inTextureCoord;
+}
\ No newline at end of file